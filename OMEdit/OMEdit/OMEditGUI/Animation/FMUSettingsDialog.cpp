@@ -58,8 +58,11 @@ FMUSettingsDialog::FMUSettingsDialog(QWidget *pParent, VisualizerFMU* pVisualize
   QLabel *solverLabel = new QLabel(tr("Solver"));
   mpSolverComboBox = new QComboBox();
   mpSolverComboBox->addItem(QString("Explicit Euler"), QVariant((int)Solver::EULER_FORWARD));
+  mpSolverComboBox->addItem(QString("Runge-Kutta 4"), QVariant((int)Solver::RUNGE_KUTTA_4));
+  mpSolverComboBox->addItem(QString("Dormand-Prince (adaptive)"), QVariant((int)Solver::DORMAND_PRINCE));
   Label *stepsizeLabel = new Label(tr("Step Size [s]"));
   mpStepSizeLineEdit = new QLineEdit(QString::number(mStepSize));
+  mpStepSizeLineEdit->setToolTip(tr("The fixed step size of the Euler and Runge-Kutta solvers, the maximum step size of the adaptive solver."));
   Label *handleEventsLabel = new Label(tr("Process Events in FMU"));
   mpHandleEventsCheck = new QCheckBox();
   mpHandleEventsCheck->setCheckState(Qt::Checked);
@@ -37,6 +37,9 @@
 #include "Modeling/MessagesWidget.h"
 #include "Util/Helper.h"
 
+#include <algorithm>
+#include <cmath>
+
 SimSettingsFMU::SimSettingsFMU()
                 : _callEventUpdate(fmi1_false),
                   _toleranceControlled(fmi1_true),
@@ -100,6 +103,11 @@ void SimSettingsFMU::setSolver(const Solver& solver)
   _solver = solver;
 }
 
+Solver SimSettingsFMU::getSolver() const
+{
+  return _solver;
+}
+
 int* SimSettingsFMU::getCallEventUpdate()
 {
   return &_callEventUpdate;
@@ -155,9 +163,9 @@ FMUWrapper_ME_1::~FMUWrapper_ME_1()
   fmi1_import_free(mpFMU);
 }
 
-void FMUWrapper_ME_1::fmi_get_real(unsigned int* valueRef, double* res)
+void FMUWrapper_ME_1::fmi_get_real(unsigned int* valueRef, double* res, size_t nvr)
 {
-  fmi1_import_get_real(mpFMU, valueRef, 1, res);
+  fmi1_import_get_real(mpFMU, valueRef, nvr, res);
 }
 
 unsigned int FMUWrapper_ME_1::fmi_get_variable_by_name(const char* name)
@@ -334,10 +342,31 @@ void FMUWrapper_ME_1::solveSystem()
   mFMUdata._fmiStatus = fmi1_import_get_derivatives(mpFMU, mFMUdata._statesDer, mFMUdata._nStates);
 }
 
-void FMUWrapper_ME_1::doEulerStep()
+void FMUWrapper_ME_1::integrateStep(FMUIntegrator* pIntegrator)
+{
+  const double tstart = mFMUdata._tcur - mFMUdata._hcur;
+  mFMUdata._hcur = pIntegrator->doStep(this, &mFMUdata, tstart, mFMUdata._hcur);
+  mFMUdata._tcur = tstart + mFMUdata._hcur;
+}
+
+void FMUWrapper_ME_1::fmi_set_time(const double time)
+{
+  mFMUdata._fmiStatus = fmi1_import_set_time(mpFMU, time);
+}
+
+void FMUWrapper_ME_1::fmi_set_continuous_states(const double* states)
 {
-  for (size_t k = 0; k < mFMUdata._nStates; ++k)
-    mFMUdata._states[k] = mFMUdata._states[k] + mFMUdata._hcur * mFMUdata._statesDer[k];
+  mFMUdata._fmiStatus = fmi1_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+}
+
+void FMUWrapper_ME_1::fmi_get_derivatives(double* statesDer)
+{
+  mFMUdata._fmiStatus = fmi1_import_get_derivatives(mpFMU, statesDer, mFMUdata._nStates);
+}
+
+void FMUWrapper_ME_1::fmi_get_event_indicators(double* eventIndicators)
+{
+  mFMUdata._fmiStatus = fmi1_import_get_event_indicators(mpFMU, eventIndicators, mFMUdata._nEventIndicators);
 }
 
 void FMUWrapper_ME_1::completedIntegratorStep(int* callEventUpdate)
@@ -374,9 +403,9 @@ FMUWrapper_ME_2::~FMUWrapper_ME_2()
   fmi2_import_free(mpFMU);
 }
 
-void FMUWrapper_ME_2::fmi_get_real(unsigned int* valueRef, double* res)
+void FMUWrapper_ME_2::fmi_get_real(unsigned int* valueRef, double* res, size_t nvr)
 {
-  fmi2_import_get_real(mpFMU, valueRef, 1, res);
+  fmi2_import_get_real(mpFMU, valueRef, nvr, res);
 }
 
 void FMUWrapper_ME_2::load(const std::string& modelFile, const std::string& path, fmi_import_context_t* context)
@@ -552,6 +581,7 @@ void FMUWrapper_ME_2::handleEvents(const int intermediateResults)
   mFMUdata.fmiStatus2 = fmi2_import_enter_continuous_time_mode(mpFMU);
   mFMUdata.fmiStatus2 = fmi2_import_get_continuous_states(mpFMU, mFMUdata._states, mFMUdata._nStates);
   mFMUdata.fmiStatus2 = fmi2_import_get_event_indicators(mpFMU, mFMUdata._eventIndicators, mFMUdata._nEventIndicators);
+  std::copy(mFMUdata._eventIndicators, mFMUdata._eventIndicators + mFMUdata._nEventIndicators, mFMUdata._eventIndicatorsPrev);
 }
 
 void FMUWrapper_ME_2::prepareSimulationStep(const double time)
@@ -575,10 +605,31 @@ void FMUWrapper_ME_2::solveSystem()
   mFMUdata.fmiStatus2 = fmi2_import_get_derivatives(mpFMU, mFMUdata._statesDer, mFMUdata._nStates);
 }
 
-void FMUWrapper_ME_2::doEulerStep()
+void FMUWrapper_ME_2::integrateStep(FMUIntegrator* pIntegrator)
 {
-  for (size_t k = 0; k < mFMUdata._nStates; ++k)
-    mFMUdata._states[k] = mFMUdata._states[k] + mFMUdata._hcur * mFMUdata._statesDer[k];
+  const double tstart = mFMUdata._tcur - mFMUdata._hcur;
+  mFMUdata._hcur = pIntegrator->doStep(this, &mFMUdata, tstart, mFMUdata._hcur);
+  mFMUdata._tcur = tstart + mFMUdata._hcur;
+}
+
+void FMUWrapper_ME_2::fmi_set_time(const double time)
+{
+  mFMUdata.fmiStatus2 = fmi2_import_set_time(mpFMU, time);
+}
+
+void FMUWrapper_ME_2::fmi_set_continuous_states(const double* states)
+{
+  mFMUdata.fmiStatus2 = fmi2_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+}
+
+void FMUWrapper_ME_2::fmi_get_derivatives(double* statesDer)
+{
+  mFMUdata.fmiStatus2 = fmi2_import_get_derivatives(mpFMU, statesDer, mFMUdata._nStates);
+}
+
+void FMUWrapper_ME_2::fmi_get_event_indicators(double* eventIndicators)
+{
+  mFMUdata.fmiStatus2 = fmi2_import_get_event_indicators(mpFMU, eventIndicators, mFMUdata._nEventIndicators);
 }
 
 void FMUWrapper_ME_2::completedIntegratorStep(int* callEventUpdate)
@@ -591,3 +642,296 @@ unsigned int FMUWrapper_ME_2::fmi_get_variable_by_name(const char* name)
     fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(mpFMU, name);
     return (unsigned int)fmi2_import_get_variable_vr(var);
 }
+
+//-------------------------------
+// Integrators
+//-------------------------------
+
+FMUIntegrator::FMUIntegrator()
+  : mDerivativesValid(false)
+{
+}
+
+/*!
+ * \brief FMUIntegrator::getNextStepSize
+ * Returns the step size for the next step. The fixed step integrators always use the default step size.
+ * \param hdef - the default step size.
+ * \return
+ */
+double FMUIntegrator::getNextStepSize(const double hdef)
+{
+  return hdef;
+}
+
+/*!
+ * \brief FMUIntegrator::reset
+ * Forgets everything known about the last step, e.g., after an event or after the states were changed by the user.
+ */
+void FMUIntegrator::reset()
+{
+  mDerivativesValid = false;
+}
+
+/*!
+ * \brief FMUIntegrator::isDerivativesValid
+ * Returns true if the integrator has already stored the derivatives at the end of its last step in FMUData::_statesDer.
+ * \return
+ */
+bool FMUIntegrator::isDerivativesValid() const
+{
+  return mDerivativesValid;
+}
+
+/*!
+ * \brief FMUIntegrator::evaluateDerivatives
+ * Evaluates the derivatives of the model at the given time and states.
+ * \param pFMU
+ * \param time
+ * \param states
+ * \param statesDer
+ */
+void FMUIntegrator::evaluateDerivatives(FMUWrapperAbstract* pFMU, const double time, const double* states, double* statesDer)
+{
+  pFMU->fmi_set_time(time);
+  pFMU->fmi_set_continuous_states(states);
+  pFMU->fmi_get_derivatives(statesDer);
+}
+
+/*!
+ * \brief EulerIntegrator::doStep
+ * Does a forward Euler step with the derivatives at the start of the step.
+ * \param pFMU
+ * \param pFMUData
+ * \param tstart - the time at the start of the step.
+ * \param h - the step size.
+ * \return the step size taken.
+ */
+double EulerIntegrator::doStep(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h)
+{
+  for (size_t k = 0; k < pFMUData->_nStates; ++k)
+    pFMUData->_states[k] = pFMUData->_states[k] + h * pFMUData->_statesDer[k];
+  return h;
+}
+
+/*!
+ * \brief RungeKutta4Integrator::doStep
+ * Does a classical fourth order Runge-Kutta step. Needs three derivative evaluations besides the one at the start of the step.
+ * \param pFMU
+ * \param pFMUData
+ * \param tstart - the time at the start of the step.
+ * \param h - the step size.
+ * \return the step size taken.
+ */
+double RungeKutta4Integrator::doStep(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h)
+{
+  const size_t n = pFMUData->_nStates;
+  double* states = pFMUData->_states;
+  const double* k1 = pFMUData->_statesDer;
+  mStates.assign(states, states + n);
+  mK2.resize(n);
+  mK3.resize(n);
+  mK4.resize(n);
+  // the states of the FMU are used as the buffer of the stage states
+  for (size_t k = 0; k < n; ++k)
+    states[k] = mStates[k] + 0.5 * h * k1[k];
+  evaluateDerivatives(pFMU, tstart + 0.5 * h, states, mK2.data());
+  for (size_t k = 0; k < n; ++k)
+    states[k] = mStates[k] + 0.5 * h * mK2[k];
+  evaluateDerivatives(pFMU, tstart + 0.5 * h, states, mK3.data());
+  for (size_t k = 0; k < n; ++k)
+    states[k] = mStates[k] + h * mK3[k];
+  evaluateDerivatives(pFMU, tstart + h, states, mK4.data());
+  for (size_t k = 0; k < n; ++k)
+    states[k] = mStates[k] + h / 6.0 * (k1[k] + 2.0 * mK2[k] + 2.0 * mK3[k] + mK4[k]);
+  return h;
+}
+
+/*!
+ * \class DormandPrinceIntegrator
+ * \brief Embedded Runge-Kutta 5(4) integrator of Dormand and Prince with step size control and event localisation.
+ * The derivatives at the end of an accepted step are reused at the start of the next step (first same as last).
+ */
+/*!
+ * \brief DormandPrinceIntegrator::DormandPrinceIntegrator
+ * \param relativeTolerance
+ */
+DormandPrinceIntegrator::DormandPrinceIntegrator(const double relativeTolerance)
+  : FMUIntegrator(),
+    mRelativeTolerance(relativeTolerance),
+    mAbsoluteTolerance(relativeTolerance),
+    mStepSize(0.0)
+{
+}
+
+/*!
+ * \brief DormandPrinceIntegrator::getNextStepSize
+ * Returns the step size proposed by the error control of the last step, limited by the default step size.
+ * \param hdef - the default step size, used as the maximum step size.
+ * \return
+ */
+double DormandPrinceIntegrator::getNextStepSize(const double hdef)
+{
+  if (mStepSize <= 0.0) {
+    return hdef;
+  }
+  return std::min(hdef, mStepSize);
+}
+
+/*!
+ * \brief DormandPrinceIntegrator::doStep
+ * Does one accepted step. Rejected steps are repeated with a smaller step size, so the step size taken can be smaller than h.
+ * If an event indicator changes its sign during the step then the step is shortened to just after the zero crossing.
+ * \param pFMU
+ * \param pFMUData
+ * \param tstart - the time at the start of the step.
+ * \param h - the proposed step size.
+ * \return the step size taken.
+ */
+double DormandPrinceIntegrator::doStep(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h)
+{
+  static const double c[7] = {0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0, 8.0/9.0, 1.0, 1.0};
+  static const double a[7][6] = {
+    {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+    {1.0/5.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+    {3.0/40.0, 9.0/40.0, 0.0, 0.0, 0.0, 0.0},
+    {44.0/45.0, -56.0/15.0, 32.0/9.0, 0.0, 0.0, 0.0},
+    {19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0, 0.0, 0.0},
+    {9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0, 0.0},
+    {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0}
+  };
+  // difference between the fifth and the embedded fourth order solution
+  static const double e[7] = {71.0/57600.0, 0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0};
+
+  const size_t n = pFMUData->_nStates;
+  double* states = pFMUData->_states;
+  mStates.assign(states, states + n);
+  for (int i = 0; i < 7; ++i) {
+    mK[i].resize(n);
+  }
+  // the derivatives at the start of the step are either computed by FMUWrapperAbstract::solveSystem or are the last stage of the previous step
+  std::copy(pFMUData->_statesDer, pFMUData->_statesDer + n, mK[0].begin());
+
+  const double minStepSize = 1e-12 * std::max(1.0, std::fabs(tstart));
+  double step = h;
+  double error = 0.0;
+  bool rejected = false;
+  while (true) {
+    // the states of the FMU are used as the buffer of the stage states
+    for (int i = 1; i < 7; ++i) {
+      for (size_t k = 0; k < n; ++k) {
+        double sum = 0.0;
+        for (int j = 0; j < i; ++j) {
+          sum += a[i][j] * mK[j][k];
+        }
+        states[k] = mStates[k] + step * sum;
+      }
+      evaluateDerivatives(pFMU, tstart + c[i] * step, states, mK[i].data());
+    }
+    // the last stage was evaluated at the fifth order solution
+    error = 0.0;
+    for (size_t k = 0; k < n; ++k) {
+      double localError = 0.0;
+      for (int j = 0; j < 7; ++j) {
+        localError += e[j] * mK[j][k];
+      }
+      const double scale = mAbsoluteTolerance + mRelativeTolerance * std::max(std::fabs(mStates[k]), std::fabs(states[k]));
+      localError = step * localError / scale;
+      error += localError * localError;
+    }
+    error = n > 0 ? std::sqrt(error / n) : 0.0;
+    if (error <= 1.0 || step <= minStepSize) {
+      break;
+    }
+    rejected = true;
+    step = std::max(minStepSize, step * std::max(0.2, 0.9 * std::pow(error, -0.2)));
+  }
+
+  // propose the next step size. Keep the old proposal if the step was only shortened to hit a time event or the stop time.
+  double factor = error > 0.0 ? std::min(5.0, 0.9 * std::pow(error, -0.2)) : 5.0;
+  if (rejected) {
+    factor = std::min(1.0, factor);
+  }
+  if (rejected || step >= mStepSize) {
+    mStepSize = step * factor;
+  }
+
+  std::copy(mK[6].begin(), mK[6].end(), pFMUData->_statesDer);
+  mDerivativesValid = true;
+
+  // the model is now evaluated at the end of the step, check for zero crossings of the event indicators
+  if (pFMUData->_nEventIndicators > 0) {
+    mEventIndicators.resize(pFMUData->_nEventIndicators);
+    pFMU->fmi_get_event_indicators(mEventIndicators.data());
+    for (size_t k = 0; k < pFMUData->_nEventIndicators; ++k) {
+      if (pFMUData->_eventIndicators[k] * mEventIndicators[k] < 0) {
+        step = locateEvent(pFMU, pFMUData, tstart, step);
+        mDerivativesValid = false;
+        break;
+      }
+    }
+  }
+  pFMU->fmi_set_time(tstart + step);
+  return step;
+}
+
+/*!
+ * \brief DormandPrinceIntegrator::locateEvent
+ * Finds the first zero crossing of the event indicators in the last step by bisection on the interpolated states.
+ * The states are set to just after the zero crossing so that the event is handled at the start of the next step.
+ * \param pFMU
+ * \param pFMUData
+ * \param tstart - the time at the start of the step.
+ * \param h - the step size taken.
+ * \return the step size up to the zero crossing.
+ */
+double DormandPrinceIntegrator::locateEvent(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h)
+{
+  const size_t n = pFMUData->_nStates;
+  mStageStates.resize(n);
+  double lower = 0.0;
+  double upper = 1.0;
+  const double tolerance = 1e-10 * std::max(1.0, std::fabs(tstart));
+  for (int i = 0; i < 60 && (upper - lower) * h > tolerance; ++i) {
+    const double theta = 0.5 * (lower + upper);
+    interpolateStates(pFMUData->_states, h, theta, mStageStates.data());
+    pFMU->fmi_set_time(tstart + theta * h);
+    pFMU->fmi_set_continuous_states(mStageStates.data());
+    pFMU->fmi_get_event_indicators(mEventIndicators.data());
+    bool crossed = false;
+    for (size_t k = 0; k < pFMUData->_nEventIndicators; ++k) {
+      if (pFMUData->_eventIndicators[k] * mEventIndicators[k] < 0) {
+        crossed = true;
+        break;
+      }
+    }
+    if (crossed) {
+      upper = theta;
+    } else {
+      lower = theta;
+    }
+  }
+  interpolateStates(pFMUData->_states, h, upper, mStageStates.data());
+  std::copy(mStageStates.begin(), mStageStates.end(), pFMUData->_states);
+  return upper * h;
+}
+
+/*!
+ * \brief DormandPrinceIntegrator::interpolateStates
+ * Cubic Hermite interpolation of the states in the last step using the states and the derivatives at both ends of the step.
+ * \param states - the states at the end of the step.
+ * \param h - the step size.
+ * \param theta - the relative position in the step, between 0 and 1.
+ * \param res - the interpolated states.
+ */
+void DormandPrinceIntegrator::interpolateStates(const double* states, const double h, const double theta, double* res)
+{
+  const double theta2 = theta * theta;
+  const double theta3 = theta2 * theta;
+  const double h00 = 2.0 * theta3 - 3.0 * theta2 + 1.0;
+  const double h10 = theta3 - 2.0 * theta2 + theta;
+  const double h01 = -2.0 * theta3 + 3.0 * theta2;
+  const double h11 = theta3 - theta2;
+  for (size_t k = 0; k < mStates.size(); ++k) {
+    res[k] = h00 * mStates[k] + h10 * h * mK[0][k] + h01 * states[k] + h11 * h * mK[6][k];
+  }
+}
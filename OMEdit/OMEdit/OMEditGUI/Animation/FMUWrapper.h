@@ -42,6 +42,7 @@
 #include <iostream>
 #include <memory>
 #include <map>
+#include <vector>
 
 
 typedef struct
@@ -69,9 +70,13 @@ typedef struct
 enum class Solver
 {
   NONE = 0,
-  EULER_FORWARD = 1
+  EULER_FORWARD = 1,
+  RUNGE_KUTTA_4 = 2,
+  DORMAND_PRINCE = 3
 };
 
+class FMUIntegrator;
+
 class SimSettingsFMU
 {
  public:
@@ -89,6 +94,7 @@ class SimSettingsFMU
   double getRelativeTolerance();
   int getToleranceControlled() const;
   void setSolver(const Solver& solver);
+  Solver getSolver() const;
   int* getCallEventUpdate();
   int getIntermediateResults();
   void setIterateEvents(bool iE);
@@ -123,13 +129,18 @@ class FMUWrapperAbstract
   virtual void updateNextTimeStep(const double hdef) = 0;
   virtual void setLastStepSize(const double simTimeEnd) = 0;
   virtual void solveSystem() = 0;
-  virtual void doEulerStep() = 0;
+  virtual void integrateStep(FMUIntegrator* pIntegrator) = 0;
   virtual void setContinuousStates() = 0;
   virtual void completedIntegratorStep(int* callEventUpdate) = 0;
 
   virtual const FMUData* getFMUData()  = 0;
-  virtual void fmi_get_real(unsigned int* valueRef, double* res) = 0;
+  virtual void fmi_get_real(unsigned int* valueRef, double* res, size_t nvr = 1) = 0;
   virtual unsigned int fmi_get_variable_by_name(const char* name) = 0;
+  //used by the integrators to evaluate the model at intermediate points
+  virtual void fmi_set_time(const double time) = 0;
+  virtual void fmi_set_continuous_states(const double* states) = 0;
+  virtual void fmi_get_derivatives(double* statesDer) = 0;
+  virtual void fmi_get_event_indicators(double* eventIndicators) = 0;
 };
 
 class FMUWrapper_ME_1 : public FMUWrapperAbstract
@@ -149,14 +160,18 @@ class FMUWrapper_ME_1 : public FMUWrapperAbstract
   void updateNextTimeStep(const double hdef);
   void setLastStepSize(const double simTimeEnd);
   void solveSystem();
-  void doEulerStep();
+  void integrateStep(FMUIntegrator* pIntegrator);
   void setContinuousStates();
   void completedIntegratorStep(int* callEventUpdate);
 
   const FMUData* getFMUData();
   fmi1_import_t* getFMU();
-  void fmi_get_real(unsigned int* valueRef, double* res);
+  void fmi_get_real(unsigned int* valueRef, double* res, size_t nvr = 1);
   unsigned int fmi_get_variable_by_name(const char* name);
+  void fmi_set_time(const double time);
+  void fmi_set_continuous_states(const double* states);
+  void fmi_get_derivatives(double* statesDer);
+  void fmi_get_event_indicators(double* eventIndicators);
 
  private:
   fmi1_import_t* mpFMU;
@@ -182,14 +197,18 @@ class FMUWrapper_ME_2 : public FMUWrapperAbstract
   void prepareSimulationStep(const double time);
   void setLastStepSize(const double simTimeEnd);
   void solveSystem();
-  void doEulerStep();
+  void integrateStep(FMUIntegrator* pIntegrator);
   void completedIntegratorStep(int* callEventUpdate);
   void do_event_iteration(fmi2_import_t *fmu, fmi2_event_info_t *eventInfo);
 
   const FMUData* getFMUData();
   fmi2_import_t* getFMU();
-  void fmi_get_real(unsigned int* valueRef, double* res);
+  void fmi_get_real(unsigned int* valueRef, double* res, size_t nvr = 1);
   unsigned int fmi_get_variable_by_name(const char* name);
+  void fmi_set_time(const double time);
+  void fmi_set_continuous_states(const double* states);
+  void fmi_get_derivatives(double* statesDer);
+  void fmi_get_event_indicators(double* eventIndicators);
 
  private:
   fmi2_import_t* mpFMU;
@@ -197,4 +216,60 @@ class FMUWrapper_ME_2 : public FMUWrapperAbstract
   FMUData mFMUdata;
 };
 
+
+class FMUIntegrator
+{
+ public:
+  FMUIntegrator();
+  virtual ~FMUIntegrator() = default;
+
+  virtual double getNextStepSize(const double hdef);
+  virtual double doStep(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h) = 0;
+  virtual void reset();
+  bool isDerivativesValid() const;
+
+ protected:
+  void evaluateDerivatives(FMUWrapperAbstract* pFMU, const double time, const double* states, double* statesDer);
+  bool mDerivativesValid;
+};
+
+class EulerIntegrator : public FMUIntegrator
+{
+ public:
+  double doStep(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h) override;
+};
+
+class RungeKutta4Integrator : public FMUIntegrator
+{
+ public:
+  double doStep(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h) override;
+
+ private:
+  std::vector<double> mStates;
+  std::vector<double> mK2;
+  std::vector<double> mK3;
+  std::vector<double> mK4;
+};
+
+class DormandPrinceIntegrator : public FMUIntegrator
+{
+ public:
+  DormandPrinceIntegrator(const double relativeTolerance);
+
+  double getNextStepSize(const double hdef) override;
+  double doStep(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h) override;
+
+ private:
+  double locateEvent(FMUWrapperAbstract* pFMU, FMUData* pFMUData, const double tstart, const double h);
+  void interpolateStates(const double* states, const double h, const double theta, double* res);
+
+  double mRelativeTolerance;
+  double mAbsoluteTolerance;
+  double mStepSize;
+  std::vector<double> mStates;
+  std::vector<double> mK[7];
+  std::vector<double> mStageStates;
+  std::vector<double> mEventIndicators;
+};
+
 #endif // end FMUWRAPPER_H
@@ -38,7 +38,9 @@ ShapeObjectAttribute::ShapeObjectAttribute()
     : isConst(true),
       exp(0.0),
       cref("NONE"),
-      fmuValueRef(0)
+      fmuValueRef(0),
+      matVar(nullptr),
+      csvValues(nullptr)
 {
 }
 
@@ -46,7 +48,9 @@ ShapeObjectAttribute::ShapeObjectAttribute(float value)
     : isConst(true),
       exp(value),
       cref("NONE"),
-      fmuValueRef(0)
+      fmuValueRef(0),
+      matVar(nullptr),
+      csvValues(nullptr)
 {
 }
 
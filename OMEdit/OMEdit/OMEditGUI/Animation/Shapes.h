@@ -58,6 +58,8 @@ class ShapeObjectAttribute
   float exp;
   std::string cref;
   unsigned int fmuValueRef;
+  ModelicaMatVariable_t* matVar;
+  const double* csvValues;
 };
 
 enum class stateSetAction {update, modify};
@@ -34,6 +34,12 @@
 
 #include "Visualizer.h"
 
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+#include <QtConcurrent/QtConcurrent>
+#else
+#include <QtConcurrentRun>
+#endif
+#include <QThread>
 #if (QT_VERSION < QT_VERSION_CHECK(5, 2, 0))
 #include <QGLWidget>
 #endif
@@ -263,6 +269,158 @@ void OMVisualBase::appendVisVariable(const rapidxml::xml_node<>* node, std::vect
 }
 
 
+///--------------------------------------------------///
+///SHAPE TRANSFORMATIONS-----------------------------///
+///--------------------------------------------------///
+
+/*!
+ * \class ShapeTransforms
+ * \brief Computes the transformation matrices of all the shapes.
+ * The attribute values are copied into a structure of arrays so that the matrices can be computed in parallel.
+ */
+ShapeTransforms::ShapeTransforms()
+{
+}
+
+/*!
+ * \brief ShapeTransforms::clear
+ * Clears the arrays. The next update marks the geometry of all the shapes as changed.
+ */
+void ShapeTransforms::clear()
+{
+  _types.clear();
+  for (int i = 0; i < 3; ++i) {
+    _r[i].clear();
+    _rShape[i].clear();
+    _lDir[i].clear();
+    _wDir[i].clear();
+  }
+  for (int i = 0; i < 9; ++i) {
+    _T[i].clear();
+  }
+  _length.clear();
+  for (int i = 0; i < 4; ++i) {
+    _geometry[i].clear();
+  }
+  _geometryChanged.clear();
+  _mat.clear();
+}
+
+/*!
+ * \brief ShapeTransforms::updateTransforms
+ * Computes the transformation matrices of the shapes from their attribute values and stores them in ShapeObject::_mat.
+ * \param shapes
+ */
+void ShapeTransforms::updateTransforms(std::vector<ShapeObject>& shapes)
+{
+  gatherAttributes(shapes);
+  const size_t numberOfShapes = shapes.size();
+  // only use several threads if there are enough shapes to make up for the overhead
+  const size_t minShapesPerThread = 64;
+  size_t numberOfThreads = std::min((size_t)std::max(1, QThread::idealThreadCount()), numberOfShapes / minShapesPerThread);
+  if (numberOfThreads <= 1) {
+    computeTransforms(0, numberOfShapes);
+  } else {
+    const size_t chunkSize = (numberOfShapes + numberOfThreads - 1) / numberOfThreads;
+    QList<QFuture<void> > futures;
+    for (size_t first = chunkSize; first < numberOfShapes; first += chunkSize) {
+      futures.append(QtConcurrent::run(this, &ShapeTransforms::computeTransforms, first, std::min(first + chunkSize, numberOfShapes)));
+    }
+    computeTransforms(0, chunkSize);
+    foreach (QFuture<void> future, futures) {
+      future.waitForFinished();
+    }
+  }
+  for (size_t i = 0; i < numberOfShapes; ++i) {
+    shapes[i]._mat = _mat[i];
+  }
+}
+
+/*!
+ * \brief ShapeTransforms::isGeometryChanged
+ * Returns true if the dimensions of the shape have changed in the last update, i.e., its drawable must be recreated.
+ * \param shapeIdx
+ * \return
+ */
+bool ShapeTransforms::isGeometryChanged(const size_t shapeIdx) const
+{
+  return shapeIdx >= _geometryChanged.size() || _geometryChanged[shapeIdx];
+}
+
+/*!
+ * \brief ShapeTransforms::gatherAttributes
+ * Copies the attribute values of the shapes into the arrays.
+ * \param shapes
+ */
+void ShapeTransforms::gatherAttributes(const std::vector<ShapeObject>& shapes)
+{
+  const size_t numberOfShapes = shapes.size();
+  const bool resized = (_mat.size() != numberOfShapes);
+  if (resized) {
+    _types.resize(numberOfShapes);
+    for (int i = 0; i < 3; ++i) {
+      _r[i].resize(numberOfShapes);
+      _rShape[i].resize(numberOfShapes);
+      _lDir[i].resize(numberOfShapes);
+      _wDir[i].resize(numberOfShapes);
+    }
+    for (int i = 0; i < 9; ++i) {
+      _T[i].resize(numberOfShapes);
+    }
+    _length.resize(numberOfShapes);
+    for (int i = 0; i < 4; ++i) {
+      _geometry[i].resize(numberOfShapes);
+    }
+    _geometryChanged.resize(numberOfShapes);
+    _mat.resize(numberOfShapes);
+  }
+  for (size_t idx = 0; idx < numberOfShapes; ++idx) {
+    const ShapeObject& shape = shapes[idx];
+    _types[idx] = &shape._type;
+    for (int i = 0; i < 3; ++i) {
+      _r[i][idx] = shape._r[i].exp;
+      _rShape[i][idx] = shape._rShape[i].exp;
+      _lDir[i][idx] = shape._lDir[i].exp;
+      _wDir[i][idx] = shape._wDir[i].exp;
+    }
+    for (int i = 0; i < 9; ++i) {
+      _T[i][idx] = shape._T[i].exp;
+    }
+    _length[idx] = shape._length.exp;
+    const float geometry[4] = {shape._width.exp, shape._height.exp, shape._length.exp, shape._extra.exp};
+    _geometryChanged[idx] = resized;
+    for (int i = 0; i < 4; ++i) {
+      if (_geometry[i][idx] != geometry[i]) {
+        _geometry[i][idx] = geometry[i];
+        _geometryChanged[idx] = true;
+      }
+    }
+  }
+}
+
+/*!
+ * \brief ShapeTransforms::computeTransforms
+ * Computes the transformation matrices of the shapes in the range [first, last).
+ * Only reads and writes the arrays of this range, so the ranges can be computed in parallel.
+ * \param first
+ * \param last
+ */
+void ShapeTransforms::computeTransforms(const size_t first, const size_t last)
+{
+  for (size_t idx = first; idx < last; ++idx) {
+    rAndT rT = rotateModelica2OSG(osg::Vec3f(_r[0][idx], _r[1][idx], _r[2][idx]),
+                                  osg::Vec3f(_rShape[0][idx], _rShape[1][idx], _rShape[2][idx]),
+                                  osg::Matrix3(_T[0][idx], _T[1][idx], _T[2][idx],
+                                               _T[3][idx], _T[4][idx], _T[5][idx],
+                                               _T[6][idx], _T[7][idx], _T[8][idx]),
+                                  osg::Vec3f(_lDir[0][idx], _lDir[1][idx], _lDir[2][idx]),
+                                  osg::Vec3f(_wDir[0][idx], _wDir[1][idx], _wDir[2][idx]),
+                                  _length[idx],/* _width[idx], _height[idx],*/ *_types[idx]);
+    assemblePokeMatrix(_mat[idx], rT._T, rT._r);
+  }
+}
+
+
 ///--------------------------------------------------///
 ///ABSTRACT VISUALIZER CLASS-------------------------///
 ///--------------------------------------------------///
@@ -290,6 +448,7 @@ VisualizerAbstract::VisualizerAbstract(const std::string& modelFile, const std::
 void VisualizerAbstract::initData()
 {
   // In case of reloading, we need to make sure, that we have empty members.
+  mShapeTransforms.clear();
   mpOMVisualBase->clearXMLDoc();
   // Initialize XML file and get visAttributes.
   mpOMVisualBase->initXMLDoc();
@@ -314,13 +473,32 @@ void VisualizerAbstract::modifyShape(std::string shapeName)
   int shapeIdx = getBaseData()->getShapeObjectIndexByID(shapeName);
   ShapeObject* shape = getBaseData()->getShapeObjectByID(shapeName);
   shape->setStateSetAction(stateSetAction::modify);
-  mpUpdateVisitor->_shape = *shape;
+  mpUpdateVisitor->_shape = shape;
   osg::ref_ptr<osg::Node> child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
   child->accept(*mpUpdateVisitor);
   shape->setStateSetAction(stateSetAction::update);
 }
 
 
+/*!
+ * \brief VisualizerAbstract::applyVisAttributes
+ * Computes the transformations of all the shapes from their current attribute values and applies them to the scene graph.
+ * The visualizers call this after they have updated the attribute values of all the shapes.
+ */
+void VisualizerAbstract::applyVisAttributes()
+{
+  mShapeTransforms.updateTransforms(mpOMVisualBase->_shapes);
+  osg::ref_ptr<osg::Group> rootNode = mpOMVisScene->getScene().getRootNode();
+  for (size_t shapeIdx = 0; shapeIdx < mpOMVisualBase->_shapes.size(); ++shapeIdx) {
+    mpUpdateVisitor->_shape = &mpOMVisualBase->_shapes[shapeIdx];
+    mpUpdateVisitor->_geometryChanged = mShapeTransforms.isGeometryChanged(shapeIdx);
+    // Get the scene graph nodes and stuff.
+    osg::ref_ptr<osg::Node> child = rootNode->getChild(shapeIdx);  // the transformation
+    child->accept(*mpUpdateVisitor);
+  }
+  mpUpdateVisitor->_shape = nullptr;
+}
+
 void VisualizerAbstract::sceneUpdate()
 {
   //measure realtime
@@ -473,7 +651,8 @@ void OSGScene::setPath(const std::string path)
 
 
 UpdateVisitor::UpdateVisitor()
-  : _shape()
+  : _shape(nullptr),
+    _geometryChanged(true)
 {
   setTraversalMode(NodeVisitor::TRAVERSE_ALL_CHILDREN);
 }
@@ -484,7 +663,7 @@ UpdateVisitor::UpdateVisitor()
 void UpdateVisitor::apply(osg::MatrixTransform& node)
 {
   //std::cout<<"MT "<<node.className()<<"  "<<node.getName()<<std::endl;
-  node.setMatrix(_shape._mat);
+  node.setMatrix(_shape->_mat);
   traverse(node);
 }
 
@@ -493,52 +672,52 @@ void UpdateVisitor::apply(osg::MatrixTransform& node)
  */
 void UpdateVisitor::apply(osg::Geode& node)
 {
-  //std::cout<<"GEODE "<< _shape._id<<" "<<_shape.getTransparency()<<std::endl;
+  //std::cout<<"GEODE "<< _shape->_id<<" "<<_shape->getTransparency()<<std::endl;
   osg::ref_ptr<osg::StateSet> ss = node.getOrCreateStateSet();
-  node.setName(_shape._id);
-  switch(_shape.getStateSetAction())
+  node.setName(_shape->_id);
+  switch(_shape->getStateSetAction())
   {
   case(stateSetAction::update):
    {
-    //its a drawable and not a cad file so we have to create a new drawable
-    if (_shape._type.compare("dxf") != 0 and (_shape._type.compare("stl") != 0))
+    //its a drawable and not a cad file so we have to create a new drawable, but only if its dimensions have changed
+    if (_geometryChanged && _shape->_type.compare("dxf") != 0 and (_shape->_type.compare("stl") != 0))
     {
     osg::ref_ptr<osg::Drawable> draw = node.getDrawable(0);
     draw->dirtyDisplayList();
-    if (_shape._type == "pipe")
+    if (_shape->_type == "pipe")
     {
       node.removeDrawable(draw);
-      draw = new Pipecylinder((_shape._width.exp * _shape._extra.exp) / 2, (_shape._width.exp) / 2, _shape._length.exp);
+      draw = new Pipecylinder((_shape->_width.exp * _shape->_extra.exp) / 2, (_shape->_width.exp) / 2, _shape->_length.exp);
     }
-    else if (_shape._type == "pipecylinder")
+    else if (_shape->_type == "pipecylinder")
     {
       node.removeDrawable(draw);
-      draw = new Pipecylinder((_shape._width.exp * _shape._extra.exp) / 2, (_shape._width.exp) / 2, _shape._length.exp);
+      draw = new Pipecylinder((_shape->_width.exp * _shape->_extra.exp) / 2, (_shape->_width.exp) / 2, _shape->_length.exp);
     }
-    else if (_shape._type == "spring")
+    else if (_shape->_type == "spring")
     {
       node.removeDrawable(draw);
-      draw = new Spring(_shape._width.exp, _shape._height.exp, _shape._extra.exp, _shape._length.exp);
+      draw = new Spring(_shape->_width.exp, _shape->_height.exp, _shape->_extra.exp, _shape->_length.exp);
     }
-    else if (_shape._type == "cylinder")
+    else if (_shape->_type == "cylinder")
     {
-      draw->setShape(new osg::Cylinder(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp / 2.0, _shape._length.exp));
+      draw->setShape(new osg::Cylinder(osg::Vec3f(0.0, 0.0, 0.0), _shape->_width.exp / 2.0, _shape->_length.exp));
     }
-    else if (_shape._type == "box")
+    else if (_shape->_type == "box")
     {
-      draw->setShape(new osg::Box(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp, _shape._height.exp, _shape._length.exp));
+      draw->setShape(new osg::Box(osg::Vec3f(0.0, 0.0, 0.0), _shape->_width.exp, _shape->_height.exp, _shape->_length.exp));
     }
-    else if (_shape._type == "cone")
+    else if (_shape->_type == "cone")
     {
-      draw->setShape(new osg::Cone(osg::Vec3f(0.0, 0.0, 0.0), _shape._width.exp / 2.0, _shape._length.exp));
+      draw->setShape(new osg::Cone(osg::Vec3f(0.0, 0.0, 0.0), _shape->_width.exp / 2.0, _shape->_length.exp));
     }
-    else if (_shape._type == "sphere")
+    else if (_shape->_type == "sphere")
     {
-      draw->setShape(new osg::Sphere(osg::Vec3f(0.0, 0.0, 0.0), _shape._length.exp / 2.0));
+      draw->setShape(new osg::Sphere(osg::Vec3f(0.0, 0.0, 0.0), _shape->_length.exp / 2.0));
     }
     else
     {
-      std::cout<<"Unknown type "<<_shape._type<<", we make a capsule."<<std::endl;
+      std::cout<<"Unknown type "<<_shape->_type<<", we make a capsule."<<std::endl;
       draw->setShape(new osg::Capsule(osg::Vec3f(0.0, 0.0, 0.0), 0.1, 0.5));
     }
     //std::cout<<"SHAPE "<<draw->getShape()->className()<<std::endl;
@@ -550,7 +729,7 @@ void UpdateVisitor::apply(osg::Geode& node)
   case(stateSetAction::modify):
    {
      //apply texture
-     applyTexture(ss, _shape.getTextureImagePath());
+     applyTexture(ss, _shape->getTextureImagePath());
      break;
    }//end case
 
@@ -560,11 +739,11 @@ void UpdateVisitor::apply(osg::Geode& node)
   }//end switch
 
   //set color
-  if (_shape._type.compare("dxf") != 0)
-    changeColor(ss, _shape._color[0].exp, _shape._color[1].exp, _shape._color[2].exp);
+  if (_shape->_type.compare("dxf") != 0)
+    changeColor(ss, _shape->_color[0].exp, _shape->_color[1].exp, _shape->_color[2].exp);
 
   //set transparency
-  makeTransparent(node, _shape.getTransparency());
+  makeTransparent(node, _shape->getTransparency());
 
   node.setStateSet(ss);
   traverse(node);
@@ -652,7 +831,7 @@ osg::Image* UpdateVisitor::convertImage(const QImage& iImage)
  */
 void UpdateVisitor::makeTransparent(osg::Geode& node, float transpCoeff)
 {
-  if (_shape.getTransparency())
+  if (_shape->getTransparency())
       {
       node.getStateSet()->setMode( GL_BLEND, osg::StateAttribute::ON );
       node.getStateSet()->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
@@ -798,7 +977,7 @@ void assemblePokeMatrix(osg::Matrix& M, const osg::Matrix3& T, const osg::Vec3f&
 }
 
 
-rAndT rotateModelica2OSG(osg::Vec3f r, osg::Vec3f r_shape, osg::Matrix3 T, osg::Vec3f lDirIn, osg::Vec3f wDirIn, float length,/* float width, float height,*/ std::string type)
+rAndT rotateModelica2OSG(osg::Vec3f r, osg::Vec3f r_shape, osg::Matrix3 T, osg::Vec3f lDirIn, osg::Vec3f wDirIn, float length,/* float width, float height,*/ const std::string& type)
 {
   rAndT res;
 
@@ -74,7 +74,8 @@ class UpdateVisitor : public osg::NodeVisitor
   void changeColor(osg::StateSet* ss, float r, float g, float b);
   osg::Image* convertImage(const QImage& iImage);
 public:
-  ShapeObject _shape;
+  ShapeObject* _shape;
+  bool _geometryChanged;
 };
 
 class InfoVisitor : public osg::NodeVisitor
@@ -148,6 +149,34 @@ public:
   rapidxml::xml_document<> _xmlDoc;
 };
 
+class ShapeTransforms
+{
+ public:
+  ShapeTransforms();
+  ~ShapeTransforms() = default;
+  ShapeTransforms(const ShapeTransforms& st) = delete;
+  ShapeTransforms& operator=(const ShapeTransforms& st) = delete;
+  void clear();
+  void updateTransforms(std::vector<ShapeObject>& shapes);
+  bool isGeometryChanged(const size_t shapeIdx) const;
+ private:
+  void gatherAttributes(const std::vector<ShapeObject>& shapes);
+  void computeTransforms(const size_t first, const size_t last);
+ private:
+  // structure of arrays of the attribute values needed for the transformations, indexed by the shape index
+  std::vector<const std::string*> _types;
+  std::vector<float> _r[3];
+  std::vector<float> _rShape[3];
+  std::vector<float> _T[9];
+  std::vector<float> _lDir[3];
+  std::vector<float> _wDir[3];
+  std::vector<float> _length;
+  // width, height, length and extra of the last update, to detect changes of the geometry
+  std::vector<float> _geometry[4];
+  std::vector<char> _geometryChanged;
+  std::vector<osg::Matrix> _mat;
+};
+
 class VisualizerAbstract
 {
  public:
@@ -175,12 +204,15 @@ class VisualizerAbstract
   //virtual void simulate(TimeManager& omvm) = 0;
   virtual void startVisualization();
   virtual void pauseVisualization();
+protected:
+  void applyVisAttributes();
 protected:
   const VisType _visType;
   OMVisualBase* mpOMVisualBase;
   OMVisScene* mpOMVisScene;
   UpdateVisitor* mpUpdateVisitor;
   TimeManager* mpTimeManager;
+  ShapeTransforms mShapeTransforms;
 };
 
 osg::Vec3f Mat3mulV3(osg::Matrix3 M, osg::Vec3f V);
@@ -190,6 +222,6 @@ osg::Vec3f normalize(osg::Vec3f vec);
 osg::Vec3f cross(osg::Vec3f vec1, osg::Vec3f vec2);
 Directions fixDirections(osg::Vec3f lDir, osg::Vec3f wDir);
 void assemblePokeMatrix(osg::Matrix& M, const osg::Matrix3& T, const osg::Vec3f& r);
-rAndT rotateModelica2OSG(osg::Vec3f r, osg::Vec3f r_shape, osg::Matrix3 T, osg::Vec3f lDirIn, osg::Vec3f wDirIn, float length,/* float width, float height,*/ std::string type);
+rAndT rotateModelica2OSG(osg::Vec3f r, osg::Vec3f r_shape, osg::Matrix3 T, osg::Vec3f lDirIn, osg::Vec3f wDirIn, float length,/* float width, float height,*/ const std::string& type);
 
 #endif
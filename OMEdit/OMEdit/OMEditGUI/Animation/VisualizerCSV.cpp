@@ -34,27 +34,26 @@
 #include "VisualizerCSV.h"
 
 VisualizerCSV::VisualizerCSV(const std::string& modelFile, const std::string& path)
-  : VisualizerAbstract(modelFile, path, VisType::CSV), mpCSVData(0)
+  : VisualizerAbstract(modelFile, path, VisType::CSV), mpResultFile(), mpCSVData(0)
 {
 
 }
 
 VisualizerCSV::~VisualizerCSV()
 {
-  if (mpCSVData) {
-    omc_free_csv_reader(mpCSVData);
-  }
 }
 
 void VisualizerCSV::initData()
 {
   VisualizerAbstract::initData();
   readCSV(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
-  double *time = read_csv_dataset(mpCSVData, "time");
+  mCSVResultColumns.setCSVData(mpCSVData);
+  const double *time = mCSVResultColumns.getColumn("time");
   if (time) {
     mpTimeManager->setStartTime(time[0]);
     mpTimeManager->setEndTime(time[mpCSVData->numsteps - 1]);
   }
+  setCSVColumnsInVisAttributes();
 }
 
 void VisualizerCSV::initializeVisAttributes(const double time)
@@ -74,8 +73,9 @@ void VisualizerCSV::readCSV(const std::string& modelFile, const std::string& pat
     std::string msg = "Could not find CSV file" + resFileName + ".";
     std::cout<<msg<<std::endl;
   } else {
-    // Read mat file.
-    mpCSVData = read_csv(resFileName.c_str());
+    // Read csv file. The data is shared with the plotting windows showing the same file.
+    mpResultFile = OMPlot::ResultFile::open(QString::fromStdString(resFileName));
+    mpCSVData = mpResultFile ? mpResultFile->getCSVData() : 0;
     // Check return value.
     if (!mpCSVData) {
       std::string msg = "Could not read CSV file" + resFileName + ".";
@@ -84,73 +84,98 @@ void VisualizerCSV::readCSV(const std::string& modelFile, const std::string& pat
   }
 }
 
+/*!
+ * \brief VisualizerCSV::setCSVColumnForObjectAttribute
+ * Looks up the result file column of a non-constant attribute once instead of on every frame.
+ * \param attr
+ */
+void VisualizerCSV::setCSVColumnForObjectAttribute(ShapeObjectAttribute* attr)
+{
+  attr->csvValues = nullptr;
+  if (!attr->isConst && mCSVResultColumns.isValid()) {
+    attr->csvValues = mCSVResultColumns.getColumn(QString::fromStdString(attr->cref));
+    if (!attr->csvValues) {
+      std::cout<<"Did not get variable from result file. Variable name is "<<attr->cref<<std::endl;
+      attr->exp = 0.0;
+    }
+  }
+}
+
+/*!
+ * \brief VisualizerCSV::setCSVColumnsInVisAttributes
+ * Sets the result file columns of all the shape attributes.
+ */
+void VisualizerCSV::setCSVColumnsInVisAttributes()
+{
+  for (ShapeObject &shape : mpOMVisualBase->_shapes) {
+    setCSVColumnForObjectAttribute(&shape._length);
+    setCSVColumnForObjectAttribute(&shape._width);
+    setCSVColumnForObjectAttribute(&shape._height);
+    for (int i = 0; i < 3; ++i) {
+      setCSVColumnForObjectAttribute(&shape._lDir[i]);
+      setCSVColumnForObjectAttribute(&shape._wDir[i]);
+      setCSVColumnForObjectAttribute(&shape._r[i]);
+      setCSVColumnForObjectAttribute(&shape._rShape[i]);
+      setCSVColumnForObjectAttribute(&shape._color[i]);
+    }
+    for (int i = 0; i < 9; ++i) {
+      setCSVColumnForObjectAttribute(&shape._T[i]);
+    }
+    setCSVColumnForObjectAttribute(&shape._specCoeff);
+    setCSVColumnForObjectAttribute(&shape._extra);
+  }
+}
+
 void VisualizerCSV::updateVisAttributes(const double time)
 {
   //std::cout<<"updateVisAttributes at "<<time <<std::endl;
   // Update all shapes.
-  unsigned int shapeIdx = 0;
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
+  // find the time rows once for all the attributes.
+  const ResultTimeBracket bracket = mCSVResultColumns.getTimeBracket(time);
   try {
     for (ShapeObject &shape : mpOMVisualBase->_shapes) {
       //std::cout<<"shape "<<shape._id <<std::endl;
 
       // Get the values for the scene graph objects
-      updateObjectAttributeCSV(&shape._length, time);
-      updateObjectAttributeCSV(&shape._width, time);
-      updateObjectAttributeCSV(&shape._height, time);
-
-      updateObjectAttributeCSV(&shape._lDir[0], time);
-      updateObjectAttributeCSV(&shape._lDir[1], time);
-      updateObjectAttributeCSV(&shape._lDir[2], time);
-
-      updateObjectAttributeCSV(&shape._wDir[0], time);
-      updateObjectAttributeCSV(&shape._wDir[1], time);
-      updateObjectAttributeCSV(&shape._wDir[2], time);
-
-      updateObjectAttributeCSV(&shape._r[0], time);
-      updateObjectAttributeCSV(&shape._r[1], time);
-      updateObjectAttributeCSV(&shape._r[2], time);
-
-      updateObjectAttributeCSV(&shape._rShape[0], time);
-      updateObjectAttributeCSV(&shape._rShape[1], time);
-      updateObjectAttributeCSV(&shape._rShape[2], time);
-
-      updateObjectAttributeCSV(&shape._T[0], time);
-      updateObjectAttributeCSV(&shape._T[1], time);
-      updateObjectAttributeCSV(&shape._T[2], time);
-      updateObjectAttributeCSV(&shape._T[3], time);
-      updateObjectAttributeCSV(&shape._T[4], time);
-      updateObjectAttributeCSV(&shape._T[5], time);
-      updateObjectAttributeCSV(&shape._T[6], time);
-      updateObjectAttributeCSV(&shape._T[7], time);
-      updateObjectAttributeCSV(&shape._T[8], time);
-
-      updateObjectAttributeCSV(&shape._color[0], time);
-      updateObjectAttributeCSV(&shape._color[1], time);
-      updateObjectAttributeCSV(&shape._color[2], time);
-
-      updateObjectAttributeCSV(&shape._specCoeff, time);
-      updateObjectAttributeCSV(&shape._extra, time);
-
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-          osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-          osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-          shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-          shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-          osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-          osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-          shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
-      //shape.dumpVisAttributes();
-      // Get the scene graph nodes and stuff.
-      child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++shapeIdx;
+      updateObjectAttributeCSV(&shape._length, bracket);
+      updateObjectAttributeCSV(&shape._width, bracket);
+      updateObjectAttributeCSV(&shape._height, bracket);
+
+      updateObjectAttributeCSV(&shape._lDir[0], bracket);
+      updateObjectAttributeCSV(&shape._lDir[1], bracket);
+      updateObjectAttributeCSV(&shape._lDir[2], bracket);
+
+      updateObjectAttributeCSV(&shape._wDir[0], bracket);
+      updateObjectAttributeCSV(&shape._wDir[1], bracket);
+      updateObjectAttributeCSV(&shape._wDir[2], bracket);
+
+      updateObjectAttributeCSV(&shape._r[0], bracket);
+      updateObjectAttributeCSV(&shape._r[1], bracket);
+      updateObjectAttributeCSV(&shape._r[2], bracket);
+
+      updateObjectAttributeCSV(&shape._rShape[0], bracket);
+      updateObjectAttributeCSV(&shape._rShape[1], bracket);
+      updateObjectAttributeCSV(&shape._rShape[2], bracket);
+
+      updateObjectAttributeCSV(&shape._T[0], bracket);
+      updateObjectAttributeCSV(&shape._T[1], bracket);
+      updateObjectAttributeCSV(&shape._T[2], bracket);
+      updateObjectAttributeCSV(&shape._T[3], bracket);
+      updateObjectAttributeCSV(&shape._T[4], bracket);
+      updateObjectAttributeCSV(&shape._T[5], bracket);
+      updateObjectAttributeCSV(&shape._T[6], bracket);
+      updateObjectAttributeCSV(&shape._T[7], bracket);
+      updateObjectAttributeCSV(&shape._T[8], bracket);
+
+      updateObjectAttributeCSV(&shape._color[0], bracket);
+      updateObjectAttributeCSV(&shape._color[1], bracket);
+      updateObjectAttributeCSV(&shape._color[2], bracket);
+
+      updateObjectAttributeCSV(&shape._specCoeff, bracket);
+      updateObjectAttributeCSV(&shape._extra, bracket);
     }
+    // Update the shapes.
+    applyVisAttributes();
   } catch (std::exception& ex) {
     std::string msg = "Error in VisualizerCSV::updateVisAttributes at time point " + std::to_string(time)
         + "\n" + std::string(ex.what());
@@ -168,32 +193,20 @@ void VisualizerCSV::updateScene(const double time)
   mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / visTime);
 }
 
-void VisualizerCSV::updateObjectAttributeCSV(ShapeObjectAttribute* attr, double time)
+void VisualizerCSV::updateObjectAttributeCSV(ShapeObjectAttribute* attr, const ResultTimeBracket& bracket)
 {
-  if (!attr->isConst) {
-    attr->exp = omcGetVarValue(attr->cref.c_str(), time);
+  if (!attr->isConst && attr->csvValues && bracket.isValid()) {
+    attr->exp = bracket.interpolate(attr->csvValues);
   }
 }
 
 double VisualizerCSV::omcGetVarValue(const char* varName, double time)
 {
-  double *timeDataSet = read_csv_dataset(mpCSVData, "time");
-  for (int i = 0 ; i < mpCSVData->numsteps ; i++) {
-    if (timeDataSet[i] == time) {
-      double *varDataSet = read_csv_dataset(mpCSVData, varName);
-      if (varDataSet) {
-        return varDataSet[i];
-      } else {
-        std::cout<<"Did not get variable from result file. Variable name is "<<std::string(varName)<<std::endl;
-      }
-    } else if ((time > timeDataSet[i]) && (i + 1 < mpCSVData->numsteps) && (time < timeDataSet[i + 1])) { // interpolate
-      double *varDataSet = read_csv_dataset(mpCSVData, varName);
-      if (varDataSet) {
-        return (varDataSet[i] + varDataSet[i + 1]) / 2;
-      } else {
-        std::cout<<"Did not get variable from result file. Variable name is "<<std::string(varName)<<std::endl;
-      }
-    }
+  const double *varDataSet = mCSVResultColumns.getColumn(QString(varName));
+  ResultTimeBracket bracket = mCSVResultColumns.getTimeBracket(time);
+  if (varDataSet && bracket.isValid()) {
+    return bracket.interpolate(varDataSet);
   }
+  std::cout<<"Did not get variable from result file. Variable name is "<<std::string(varName)<<std::endl;
   return 0.0;
 }
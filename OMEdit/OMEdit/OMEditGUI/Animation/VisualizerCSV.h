@@ -35,6 +35,8 @@
 
 #include "Visualizer.h"
 #include "util/read_csv.h"
+#include "ResultFile.h"
+#include "Util/ResultColumns.h"
 
 class VisualizerCSV : public VisualizerAbstract
 {
@@ -50,10 +52,14 @@ public:
   void simulate(TimeManager& omvm) override {Q_UNUSED(omvm);}
   void updateVisAttributes(const double time) override;
   void updateScene(const double time) override;
-  void updateObjectAttributeCSV(ShapeObjectAttribute* attr, double time);
+  void setCSVColumnForObjectAttribute(ShapeObjectAttribute* attr);
+  void setCSVColumnsInVisAttributes();
+  void updateObjectAttributeCSV(ShapeObjectAttribute* attr, const ResultTimeBracket& bracket);
   double omcGetVarValue(const char* varName, double time);
 private:
+  QSharedPointer<OMPlot::ResultFile> mpResultFile;
   csv_data *mpCSVData;
+  CSVResultColumns mCSVResultColumns;
 };
 
 #endif // VISUALIZERCSV_H
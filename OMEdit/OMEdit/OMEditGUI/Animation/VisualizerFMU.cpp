@@ -39,8 +39,10 @@
 VisualizerFMU::VisualizerFMU(const std::string& modelFile, const std::string& path)
     : VisualizerAbstract(modelFile, path, VisType::FMU),
       mpFMU(nullptr),
-      mpSimSettings(new SimSettingsFMU())
+      mpSimSettings(new SimSettingsFMU()),
+      mpIntegrator(nullptr)
 {
+  createIntegrator();
 }
  VisualizerFMU::~VisualizerFMU()
  {
@@ -113,51 +115,59 @@ unsigned int VisualizerFMU::getVarReferencesForObjectAttribute(ShapeObjectAttrib
   return vr;
 }
 
+/*!
+ * \brief VisualizerFMU::addVarReferenceForObjectAttribute
+ * Sets the value reference of the attribute and adds it to the packed value reference array.
+ * Attributes sharing a variable share one entry of the array.
+ * \param attr
+ */
+void VisualizerFMU::addVarReferenceForObjectAttribute(ShapeObjectAttribute* attr)
+{
+  attr->fmuValueRef = getVarReferencesForObjectAttribute(attr);
+  if (attr->isConst)
+  {
+    return;
+  }
+  auto it = mVarReferenceIndices.find(attr->fmuValueRef);
+  if (it == mVarReferenceIndices.end())
+  {
+    it = mVarReferenceIndices.insert(std::make_pair(attr->fmuValueRef, mVarReferences.size())).first;
+    mVarReferences.push_back(attr->fmuValueRef);
+  }
+  mVarAttributes.push_back(std::make_pair(attr, it->second));
+}
+
 int VisualizerFMU::setVarReferencesInVisAttributes()
 {
   int isOk(0);
+  mVarReferences.clear();
+  mVarReferenceIndices.clear();
+  mVarAttributes.clear();
 
   try
   {
-    size_t i = 0;
     for (auto& shape : mpOMVisualBase->_shapes)
     {
-      shape = mpOMVisualBase->_shapes[i];
-
-      shape._length.fmuValueRef = getVarReferencesForObjectAttribute(&shape._length);
-      shape._width.fmuValueRef = getVarReferencesForObjectAttribute(&shape._width);
-      shape._height.fmuValueRef = getVarReferencesForObjectAttribute(&shape._height);
-
-      shape._lDir[0].fmuValueRef = getVarReferencesForObjectAttribute(&shape._lDir[0]);
-      shape._lDir[1].fmuValueRef = getVarReferencesForObjectAttribute(&shape._lDir[1]);
-      shape._lDir[2].fmuValueRef = getVarReferencesForObjectAttribute(&shape._lDir[2]);
-
-      shape._wDir[0].fmuValueRef = getVarReferencesForObjectAttribute(&shape._wDir[0]);
-      shape._wDir[1].fmuValueRef = getVarReferencesForObjectAttribute(&shape._wDir[1]);
-      shape._wDir[2].fmuValueRef = getVarReferencesForObjectAttribute(&shape._wDir[2]);
-
-      shape._r[0].fmuValueRef = getVarReferencesForObjectAttribute(&shape._r[0]);
-      shape._r[1].fmuValueRef = getVarReferencesForObjectAttribute(&shape._r[1]);
-      shape._r[2].fmuValueRef = getVarReferencesForObjectAttribute(&shape._r[2]);
-
-      shape._rShape[0].fmuValueRef = getVarReferencesForObjectAttribute(&shape._rShape[0]);
-      shape._rShape[1].fmuValueRef = getVarReferencesForObjectAttribute(&shape._rShape[1]);
-      shape._rShape[2].fmuValueRef = getVarReferencesForObjectAttribute(&shape._rShape[2]);
-
-      shape._T[0].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[0]);
-      shape._T[1].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[1]);
-      shape._T[2].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[2]);
-      shape._T[3].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[3]);
-      shape._T[4].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[4]);
-      shape._T[5].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[5]);
-      shape._T[6].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[6]);
-      shape._T[7].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[7]);
-      shape._T[8].fmuValueRef = getVarReferencesForObjectAttribute(&shape._T[8]);
-
+      addVarReferenceForObjectAttribute(&shape._length);
+      addVarReferenceForObjectAttribute(&shape._width);
+      addVarReferenceForObjectAttribute(&shape._height);
+      for (int i = 0; i < 3; ++i)
+      {
+        addVarReferenceForObjectAttribute(&shape._lDir[i]);
+        addVarReferenceForObjectAttribute(&shape._wDir[i]);
+        addVarReferenceForObjectAttribute(&shape._r[i]);
+        addVarReferenceForObjectAttribute(&shape._rShape[i]);
+        addVarReferenceForObjectAttribute(&shape._color[i]);
+      }
+      for (int i = 0; i < 9; ++i)
+      {
+        addVarReferenceForObjectAttribute(&shape._T[i]);
+      }
+      addVarReferenceForObjectAttribute(&shape._specCoeff);
+      addVarReferenceForObjectAttribute(&shape._extra);
       //shape.dumpVisAttributes();
-      mpOMVisualBase->_shapes.at(i) = shape;
-      ++i;
     }  //end for
+    mVarValues.assign(mVarReferences.size(), 0.0);
   }  // end try
 
   catch (std::exception& e)
@@ -178,12 +188,14 @@ void VisualizerFMU::updateSystem()
 {
   // Set states
   mpFMU->setContinuousStates();
+  mpIntegrator->reset();
   int zero_crossning_event = 0;
   mpFMU->prepareSimulationStep(mpTimeManager->getVisTime());
   bool zeroCrossingEvent = mpFMU->checkForTriggeredEvent();
-  if (mpSimSettings->getIterateEvents() && (mpSimSettings->getCallEventUpdate() || zeroCrossingEvent || mpFMU->itsEventTime()))
+  if (mpSimSettings->getIterateEvents() && (*mpSimSettings->getCallEventUpdate() || zeroCrossingEvent || mpFMU->itsEventTime()))
   {
     mpFMU->handleEvents(mpSimSettings->getIntermediateResults());
+    mpIntegrator->reset();
   }
   // Solve system
   mpFMU->solveSystem();
@@ -202,19 +214,23 @@ double VisualizerFMU::simulateStep(const double time)
   bool zeroCrossingEvent = mpFMU->checkForTriggeredEvent();
 
   // Handle any events
-  if (mpSimSettings->getIterateEvents() && (mpSimSettings->getCallEventUpdate() || zeroCrossingEvent || mpFMU->itsEventTime()))
+  if (mpSimSettings->getIterateEvents() && (*mpSimSettings->getCallEventUpdate() || zeroCrossingEvent || mpFMU->itsEventTime()))
   {
     mpFMU->handleEvents(mpSimSettings->getIntermediateResults());
+    mpIntegrator->reset();
   }
 
   // Updated next time step
-  mpFMU->updateNextTimeStep(mpSimSettings->getHdef());
+  mpFMU->updateNextTimeStep(mpIntegrator->getNextStepSize(mpSimSettings->getHdef()));
 
   // last step
   mpFMU->setLastStepSize(mpSimSettings->getTend());
 
-  // Solve system
-  mpFMU->solveSystem();
+  // Solve system, unless the integrator already has the derivatives from the end of its last step
+  if (!mpIntegrator->isDerivativesValid())
+  {
+    mpFMU->solveSystem();
+  }
 
   //print out some values for debugging:
   //std::cout<<"DO EULER at "<< mpFMU->getFMUData()->_tcur<<std::endl;
@@ -224,8 +240,8 @@ double VisualizerFMU::simulateStep(const double time)
   //fmi1_import_get_real(mpFMUl.mpFMU, &vr, 1, &value);
   //std::cout<<"value "<<value<<std::endl;
 
-  // integrate a step with euler
-  mpFMU->doEulerStep();
+  // integrate a step with the selected solver
+  mpFMU->integrateStep(mpIntegrator.get());
 
   // Set states
   mpFMU->setContinuousStates();
@@ -239,6 +255,7 @@ double VisualizerFMU::simulateStep(const double time)
 void VisualizerFMU::initializeVisAttributes(const double time)
 {
   mpFMU->initialize(mpSimSettings);
+  mpIntegrator->reset();
   std::cout<<"VisualizerFMU::loadFMU: FMU was successfully initialized."<<std::endl;
 
   mpTimeManager->setVisTime(mpTimeManager->getStartTime());
@@ -250,63 +267,12 @@ void VisualizerFMU::initializeVisAttributes(const double time)
 void VisualizerFMU::updateVisAttributes(const double time)
 {
   // Update all shapes.
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
   try
   {
-    size_t i = 0;
-    for (auto& shape : mpOMVisualBase->_shapes)
-    {
-      // Get the values for the scene graph objects
-      updateObjectAttributeFMU(&shape._length, mpFMU);
-      updateObjectAttributeFMU(&shape._width, mpFMU);
-      updateObjectAttributeFMU(&shape._height, mpFMU);
-
-      updateObjectAttributeFMU(&shape._lDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._wDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._r[0], mpFMU);
-      updateObjectAttributeFMU(&shape._r[1], mpFMU);
-      updateObjectAttributeFMU(&shape._r[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._rShape[0], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[1], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._T[0], mpFMU);
-      updateObjectAttributeFMU(&shape._T[1], mpFMU);
-      updateObjectAttributeFMU(&shape._T[2], mpFMU);
-      updateObjectAttributeFMU(&shape._T[3], mpFMU);
-      updateObjectAttributeFMU(&shape._T[4], mpFMU);
-      updateObjectAttributeFMU(&shape._T[5], mpFMU);
-      updateObjectAttributeFMU(&shape._T[6], mpFMU);
-      updateObjectAttributeFMU(&shape._T[7], mpFMU);
-      updateObjectAttributeFMU(&shape._T[8], mpFMU);
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-                osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-                osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-                             shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-                             shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-                osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-                osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-                shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
-
-      // Get the scene graph nodes and stuff.
-      //mpOMVisScene->dumpOSGTreeDebug();
-      child = mpOMVisScene->getScene().getRootNode()->getChild(i);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++i;
-    }  //end for
+    // Get the values for the scene graph objects
+    updateObjectAttributesFMU();
+    // Update the shapes.
+    applyVisAttributes();
   }  // end try
   catch (std::exception& ex)
   {
@@ -335,14 +301,20 @@ void VisualizerFMU::updateScene(const double time)
   updateVisAttributes(mpTimeManager->getVisTime());
 }
 
-// Todo pass by const ref
-void VisualizerFMU::updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrapperAbstract* fmuWrapper)
+/*!
+ * \brief VisualizerFMU::updateObjectAttributesFMU
+ * Gets the values of all the non-constant attributes with a single fmi get real call and scatters them back to the attributes.
+ */
+void VisualizerFMU::updateObjectAttributesFMU()
 {
-  if (!attr->isConst)
+  if (mVarReferences.empty())
+  {
+    return;
+  }
+  mpFMU->fmi_get_real(&mVarReferences[0], &mVarValues[0], mVarReferences.size());
+  for (const auto& varAttribute : mVarAttributes)
   {
-    double a = attr->exp;
-    fmuWrapper->fmi_get_real(&attr->fmuValueRef, &a);
-    attr->exp = (float) a;
+    varAttribute.first->exp = (float) mVarValues[varAttribute.second];
   }
 }
 
@@ -351,6 +323,28 @@ void VisualizerFMU::setSimulationSettings(double stepsize, Solver solver, bool i
   mpSimSettings->setHdef(stepsize);
   mpSimSettings->setSolver(solver);
   mpSimSettings->setIterateEvents(iterateEvents);
+  createIntegrator();
+}
+
+/*!
+ * \brief VisualizerFMU::createIntegrator
+ * Creates the integrator for the solver selected in the simulation settings.
+ */
+void VisualizerFMU::createIntegrator()
+{
+  switch (mpSimSettings->getSolver())
+  {
+    case Solver::RUNGE_KUTTA_4:
+      mpIntegrator.reset(new RungeKutta4Integrator());
+      break;
+    case Solver::DORMAND_PRINCE:
+      mpIntegrator.reset(new DormandPrinceIntegrator(mpSimSettings->getRelativeTolerance()));
+      break;
+    case Solver::EULER_FORWARD:
+    default:
+      mpIntegrator.reset(new EulerIntegrator());
+      break;
+  }
 }
 
 FMUWrapperAbstract* VisualizerFMU::getFMU()
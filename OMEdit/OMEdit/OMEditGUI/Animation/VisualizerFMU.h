@@ -41,6 +41,9 @@
 #include "Shapes.h"
 #include "TimeManager.h"
 
+#include <unordered_map>
+#include <vector>
+
 class VisualizerFMU : public VisualizerAbstract
 {
  public:
@@ -55,22 +58,32 @@ class VisualizerFMU : public VisualizerAbstract
   void initData() override;
   void initializeVisAttributes(const double time = 0.0) override;
   unsigned int getVarReferencesForObjectAttribute(ShapeObjectAttribute* attr);
+  void addVarReferenceForObjectAttribute(ShapeObjectAttribute* attr);
   int setVarReferencesInVisAttributes();
   void simulate(TimeManager& omvm) override;
   double simulateStep(const double time);
   void updateSystem();
   void updateVisAttributes(const double time) override;
   void updateScene(const double time = 0.0) override;
-  void updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrapperAbstract* fmuWrapper);
+  void updateObjectAttributesFMU();
   void setSimulationSettings(double stepsize, Solver solver, bool iterateEvents);
   FMUWrapperAbstract* getFMU();
 
  private:
+  void createIntegrator();
+
   std::shared_ptr<fmi_import_context_t> mpContext;
   jm_callbacks mCallbacks;
   fmi_version_enu_t mVersion;
   FMUWrapperAbstract* mpFMU;
   std::shared_ptr<SimSettingsFMU> mpSimSettings;
+  std::unique_ptr<FMUIntegrator> mpIntegrator;
+  // packed and deduplicated value references of all the non-constant attributes
+  std::vector<unsigned int> mVarReferences;
+  std::unordered_map<unsigned int, size_t> mVarReferenceIndices;
+  std::vector<double> mVarValues;
+  // the attributes and the index of their value in mVarValues
+  std::vector<std::pair<ShapeObjectAttribute*, size_t> > mVarAttributes;
 };
 
 
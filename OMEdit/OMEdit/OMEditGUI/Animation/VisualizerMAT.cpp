@@ -36,28 +36,29 @@
 
 VisualizerMAT::VisualizerMAT(const std::string& modelFile, const std::string& path)
   : VisualizerAbstract(modelFile, path, VisType::MAT),
-    _matReader()
+    mpResultFile(),
+    _matReader(nullptr)
 {
 
 }
 
 /*!
  * \brief VisualizerMAT::~VisualizerMAT
- * Free the ModelicaMatReader
+ * The ModelicaMatReader is owned by the shared result file and freed with its last reference.
  */
 VisualizerMAT::~VisualizerMAT()
 {
-  if (_matReader.file) {
-    omc_free_matlab4_reader(&_matReader);
-  }
 }
 
 void VisualizerMAT::initData()
 {
   VisualizerAbstract::initData();
   readMat(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
-  mpTimeManager->setStartTime(omc_matlab4_startTime(&_matReader));
-  mpTimeManager->setEndTime(omc_matlab4_stopTime(&_matReader));
+  if (_matReader) {
+    mpTimeManager->setStartTime(omc_matlab4_startTime(_matReader));
+    mpTimeManager->setEndTime(omc_matlab4_stopTime(_matReader));
+  }
+  setMatVariablesInVisAttributes();
 }
 
 void VisualizerMAT::initializeVisAttributes(const double time)
@@ -79,13 +80,14 @@ void VisualizerMAT::readMat(const std::string& modelFile, const std::string& pat
   }
   else
   {
-    // Read mat file.
-    auto ret = omc_new_matlab4_reader(resFileName.c_str(), &_matReader);
+    // Read mat file. The reader is shared with the plotting windows showing the same file.
+    QString errorString;
+    mpResultFile = OMPlot::ResultFile::open(QString::fromStdString(resFileName), &errorString);
+    _matReader = mpResultFile ? mpResultFile->getMatReader() : nullptr;
     // Check return value.
-    if (0 != ret)
+    if (!_matReader)
     {
-      std::string msg(ret);
-      std::cout<<msg<<std::endl;
+      std::cout<<errorString.toStdString()<<std::endl;
     }
   }
 
@@ -96,6 +98,66 @@ void VisualizerMAT::readMat(const std::string& modelFile, const std::string& pat
      */
 }
 
+/*!
+ * \brief VisualizerMAT::setMatVariableForObjectAttribute
+ * Looks up the result file variable of a non-constant attribute once instead of on every frame.
+ * \param attr
+ */
+void VisualizerMAT::setMatVariableForObjectAttribute(ShapeObjectAttribute* attr)
+{
+  attr->matVar = nullptr;
+  if (!attr->isConst && _matReader)
+  {
+    attr->matVar = omc_matlab4_find_var(_matReader, attr->cref.c_str());
+    if (attr->matVar == nullptr)
+    {
+      std::cout<<"Did not get variable from result file. Variable name is "<<attr->cref<<std::endl;
+      attr->exp = 0.0;
+    }
+  }
+}
+
+/*!
+ * \brief VisualizerMAT::setMatVariablesInVisAttributes
+ * Sets the result file variables of all the shape attributes.
+ */
+void VisualizerMAT::setMatVariablesInVisAttributes()
+{
+  for (auto& shape : mpOMVisualBase->_shapes)
+  {
+    setMatVariableForObjectAttribute(&shape._length);
+    setMatVariableForObjectAttribute(&shape._width);
+    setMatVariableForObjectAttribute(&shape._height);
+    for (int i = 0; i < 3; ++i)
+    {
+      setMatVariableForObjectAttribute(&shape._lDir[i]);
+      setMatVariableForObjectAttribute(&shape._wDir[i]);
+      setMatVariableForObjectAttribute(&shape._r[i]);
+      setMatVariableForObjectAttribute(&shape._rShape[i]);
+      setMatVariableForObjectAttribute(&shape._color[i]);
+    }
+    for (int i = 0; i < 9; ++i)
+    {
+      setMatVariableForObjectAttribute(&shape._T[i]);
+    }
+    setMatVariableForObjectAttribute(&shape._specCoeff);
+    setMatVariableForObjectAttribute(&shape._extra);
+  }
+}
+
+/*!
+ * \brief VisualizerMAT::getTimeBracket
+ * Finds the result file rows around the time point.
+ * The bracket is computed once per frame and shared by all the shape attributes.
+ * \param time
+ * \return
+ */
+ResultTimeBracket VisualizerMAT::getTimeBracket(const double time)
+{
+  double* timeVals = _matReader ? omc_matlab4_read_vals(_matReader, 1) : nullptr;
+  return ResultTimeBracket(timeVals, timeVals ? _matReader->nrows : 0, time);
+}
+
 void VisualizerMAT::setSimulationSettings(const UserSimSettingsMAT& simSetMAT)
 {
   auto newVal = simSetMAT.speedup * mpTimeManager->getHVisual();
@@ -106,10 +168,8 @@ void VisualizerMAT::updateVisAttributes(const double time)
 {
   //std::cout<<"updateVisAttributes at "<<time <<std::endl;
   // Update all shapes.
-  unsigned int shapeIdx = 0;
-  rAndT rT;
-  osg::ref_ptr<osg::Node> child = nullptr;
-  ModelicaMatReader* tmpReaderPtr = &_matReader;
+  ModelicaMatReader* tmpReaderPtr = _matReader;
+  const ResultTimeBracket bracket = getTimeBracket(time);
   try
   {
     for (auto& shape : mpOMVisualBase->_shapes)
@@ -117,61 +177,45 @@ void VisualizerMAT::updateVisAttributes(const double time)
       //std::cout<<"shape "<<shape._id <<std::endl;
 
       // Get the values for the scene graph objects
-      updateObjectAttributeMAT(&shape._length, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._width, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._height, time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._lDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._wDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._r[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._rShape[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._T[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[2], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[3], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[4], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[5], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[6], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[7], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[8], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._color[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._specCoeff, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._extra, time, tmpReaderPtr);
-
-      rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
-          osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
-          osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
-          shape._T[3].exp, shape._T[4].exp, shape._T[5].exp,
-          shape._T[6].exp, shape._T[7].exp, shape._T[8].exp),
-          osg::Vec3f(shape._lDir[0].exp, shape._lDir[1].exp, shape._lDir[2].exp),
-          osg::Vec3f(shape._wDir[0].exp, shape._wDir[1].exp, shape._wDir[2].exp),
-          shape._length.exp,/* shape._width.exp, shape._height.exp,*/ shape._type);
-
-      assemblePokeMatrix(shape._mat, rT._T, rT._r);
-      // Update the shapes.
-      mpUpdateVisitor->_shape = shape;
-      //shape.dumpVisAttributes();
-      // Get the scene graph nodes and stuff.
-      child = mpOMVisScene->getScene().getRootNode()->getChild(shapeIdx);  // the transformation
-      child->accept(*mpUpdateVisitor);
-      ++shapeIdx;
+      updateObjectAttributeMAT(&shape._length, bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._width, bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._height, bracket, tmpReaderPtr);
+
+      updateObjectAttributeMAT(&shape._lDir[0], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._lDir[1], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._lDir[2], bracket, tmpReaderPtr);
+
+      updateObjectAttributeMAT(&shape._wDir[0], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._wDir[1], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._wDir[2], bracket, tmpReaderPtr);
+
+      updateObjectAttributeMAT(&shape._r[0], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._r[1], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._r[2], bracket, tmpReaderPtr);
+
+      updateObjectAttributeMAT(&shape._rShape[0], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._rShape[1], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._rShape[2], bracket, tmpReaderPtr);
+
+      updateObjectAttributeMAT(&shape._T[0], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[1], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[2], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[3], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[4], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[5], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[6], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[7], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._T[8], bracket, tmpReaderPtr);
+
+      updateObjectAttributeMAT(&shape._color[0], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._color[1], bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._color[2], bracket, tmpReaderPtr);
+
+      updateObjectAttributeMAT(&shape._specCoeff, bracket, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._extra, bracket, tmpReaderPtr);
     }
+    // Update the shapes.
+    applyVisAttributes();
   }
   catch (std::exception& ex)
   {
@@ -191,10 +235,22 @@ void VisualizerMAT::updateScene(const double time)
   mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / visTime);
 }
 
-void VisualizerMAT::updateObjectAttributeMAT(ShapeObjectAttribute* attr, double time, ModelicaMatReader* reader)
+void VisualizerMAT::updateObjectAttributeMAT(ShapeObjectAttribute* attr, const ResultTimeBracket& bracket, ModelicaMatReader* reader)
 {
-  if (!attr->isConst)
-    attr->exp = omcGetVarValue(reader, attr->cref.c_str(), time);
+  if (attr->isConst || attr->matVar == nullptr)
+    return;
+  if (attr->matVar->isParam || !bracket.isValid())
+  {
+    double val = 0.0;
+    omc_matlab4_val(&val, reader, attr->matVar, bracket.getTime());
+    attr->exp = val;
+  }
+  else
+  {
+    double* vals = omc_matlab4_read_vals(reader, attr->matVar->index);
+    if (vals)
+      attr->exp = bracket.interpolate(vals);
+  }
 }
 
 double VisualizerMAT::omcGetVarValue(ModelicaMatReader* reader, const char* varName, double time)
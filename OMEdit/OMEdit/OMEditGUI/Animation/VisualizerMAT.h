@@ -37,6 +37,8 @@
 
 #include "Visualizer.h"
 #include "util/read_matlab4.h"
+#include "ResultFile.h"
+#include "Util/ResultColumns.h"
 
 class VisualizerMAT : public VisualizerAbstract
 {
@@ -53,10 +55,14 @@ class VisualizerMAT : public VisualizerAbstract
   void simulate(TimeManager& omvm) override {Q_UNUSED(omvm);}
   void updateVisAttributes(const double time) override;
   void updateScene(const double time) override;
-  void updateObjectAttributeMAT(ShapeObjectAttribute* attr, double time, ModelicaMatReader* reader);
+  void setMatVariableForObjectAttribute(ShapeObjectAttribute* attr);
+  void setMatVariablesInVisAttributes();
+  ResultTimeBracket getTimeBracket(const double time);
+  void updateObjectAttributeMAT(ShapeObjectAttribute* attr, const ResultTimeBracket& bracket, ModelicaMatReader* reader);
   double omcGetVarValue(ModelicaMatReader* reader, const char* varName, double time);
 private:
-  ModelicaMatReader _matReader;
+  QSharedPointer<OMPlot::ResultFile> mpResultFile;
+  ModelicaMatReader* _matReader;
 };
 
 #endif // end VISUALIZERMAT_H
@@ -2945,24 +2945,6 @@ void Component::showElementPropertiesDialog()
   }
 }
 
-/*!
- * \brief Component::updateDynamicSelect
- * Slot activated when updateDynamicSelect SIGNAL is raised by VariablesWidget during the visualization of result file.
- * \param time
- */
-void Component::updateDynamicSelect(double time)
-{
-  if (mpLibraryTreeItem && mpLibraryTreeItem->isState()) {
-    double value = MainWindow::instance()->getVariablesWidget()->readVariableValue(getName() + ".active", time);
-    setActiveState(value);
-    foreach (LineAnnotation *pTransitionLineAnnotation, mpGraphicsView->getTransitionsList()) {
-      if (pTransitionLineAnnotation->getEndComponent()->getName().compare(getName()) == 0) {
-        pTransitionLineAnnotation->setActiveState(value);
-      }
-    }
-  }
-}
-
 /*!
  * \brief Component::contextMenuEvent
  * Reimplementation of contextMenuEvent.\n
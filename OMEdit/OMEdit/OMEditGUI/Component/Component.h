@@ -376,7 +376,6 @@ public slots:
   void viewDocumentation();
   void showSubModelAttributes();
   void showElementPropertiesDialog();
-  void updateDynamicSelect(double time);
 protected:
   virtual void contextMenuEvent(QGraphicsSceneContextMenuEvent *event);
   virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
@@ -470,6 +470,7 @@ void ModelicaEditor::toggleCommentSelection()
 //! @brief A syntax highlighter for ModelicaEditor.
 
 //! Constructor
+//! Without a ModelicaEditorPage, e.g., in the highlighter benchmark, the default formats and text settings are used.
 ModelicaHighlighter::ModelicaHighlighter(ModelicaEditorPage *pModelicaEditorPage, QPlainTextEdit *pPlainTextEdit)
   : QSyntaxHighlighter(pPlainTextEdit->document())
 {
@@ -481,49 +482,25 @@ ModelicaHighlighter::ModelicaHighlighter(ModelicaEditorPage *pModelicaEditorPage
 //! Initialized the syntax highlighter with default values.
 void ModelicaHighlighter::initializeSettings()
 {
-  QFont font;
-  font.setFamily(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getFontFamilyComboBox()->currentFont().family());
-  font.setPointSizeF(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getFontSizeSpinBox()->value());
-  mpPlainTextEdit->document()->setDefaultFont(font);
-  mpPlainTextEdit->setTabStopWidth(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getTabSizeSpinBox()->value() * QFontMetrics(font).width(QLatin1Char(' ')));
-  // set color highlighting
-  mHighlightingRules.clear();
-  HighlightingRule rule;
-  mTextFormat.setForeground(mpModelicaEditorPage->getColor("Text"));
-  mKeywordFormat.setForeground(mpModelicaEditorPage->getColor("Keyword"));
-  mTypeFormat.setForeground(mpModelicaEditorPage->getColor("Type"));
-  mSingleLineCommentFormat.setForeground(mpModelicaEditorPage->getColor("Comment"));
-  mMultiLineCommentFormat.setForeground(mpModelicaEditorPage->getColor("Comment"));
-  mFunctionFormat.setForeground(mpModelicaEditorPage->getColor("Function"));
-  mQuotationFormat.setForeground(mpModelicaEditorPage->getColor("Quotes"));
-  // Priority: keyword > func() > ident > number. Yes, the order matters :)
-  mNumberFormat.setForeground(mpModelicaEditorPage->getColor("Number"));
-  rule.mPattern = QRegExp("[0-9][0-9]*([.][0-9]*)?([eE][+-]?[0-9]*)?");
-  rule.mFormat = mNumberFormat;
-  mHighlightingRules.append(rule);
-  rule.mPattern = QRegExp("\\b[A-Za-z_][A-Za-z0-9_]*");
-  rule.mFormat = mTextFormat;
-  mHighlightingRules.append(rule);
-  // functions
-  rule.mPattern = QRegExp("\\b[A-Za-z0-9_]+(?=\\()");
-  rule.mFormat = mFunctionFormat;
-  mHighlightingRules.append(rule);
-  // keywords
-  QStringList keywordPatterns = getKeywords();
-  foreach (const QString &pattern, keywordPatterns) {
-    QString newPattern = QString("\\b%1\\b").arg(pattern);
-    rule.mPattern = QRegExp(newPattern);
-    rule.mFormat = mKeywordFormat;
-    mHighlightingRules.append(rule);
-  }
-  // Modelica types
-  QStringList typePatterns = getTypes();
-  foreach (const QString &pattern, typePatterns) {
-    QString newPattern = QString("\\b%1\\b").arg(pattern);
-    rule.mPattern = QRegExp(newPattern);
-    rule.mFormat = mTypeFormat;
-    mHighlightingRules.append(rule);
+  if (mpModelicaEditorPage) {
+    QFont font;
+    font.setFamily(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getFontFamilyComboBox()->currentFont().family());
+    font.setPointSizeF(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getFontSizeSpinBox()->value());
+    mpPlainTextEdit->document()->setDefaultFont(font);
+    mpPlainTextEdit->setTabStopWidth(mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getTabSizeSpinBox()->value() * QFontMetrics(font).width(QLatin1Char(' ')));
+    // set color highlighting
+    mTextFormat.setForeground(mpModelicaEditorPage->getColor("Text"));
+    mKeywordFormat.setForeground(mpModelicaEditorPage->getColor("Keyword"));
+    mTypeFormat.setForeground(mpModelicaEditorPage->getColor("Type"));
+    mSingleLineCommentFormat.setForeground(mpModelicaEditorPage->getColor("Comment"));
+    mMultiLineCommentFormat.setForeground(mpModelicaEditorPage->getColor("Comment"));
+    mFunctionFormat.setForeground(mpModelicaEditorPage->getColor("Function"));
+    mQuotationFormat.setForeground(mpModelicaEditorPage->getColor("Quotes"));
+    mNumberFormat.setForeground(mpModelicaEditorPage->getColor("Number"));
   }
+  // keywords and Modelica types are looked up while scanning the identifiers
+  mKeywords = getKeywords().toSet();
+  mTypes = getTypes().toSet();
 }
 
 // Function which returns list of keywords for the highlighter
@@ -605,10 +582,63 @@ QStringList ModelicaHighlighter::getTypes()
   return typesList;
 }
 
+/*!
+ * \brief isIdentifierStart
+ * \param c
+ * \return true if c can start a Modelica identifier.
+ */
+static inline bool isIdentifierStart(const QChar &c)
+{
+  ushort u = c.unicode();
+  return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '_';
+}
+
+/*!
+ * \brief isIdentifierCharacter
+ * \param c
+ * \return true if c can be part of a Modelica identifier.
+ */
+static inline bool isIdentifierCharacter(const QChar &c)
+{
+  return isIdentifierStart(c) || (c.unicode() >= '0' && c.unicode() <= '9');
+}
+
+/*!
+ * \brief isDigit
+ * \param text
+ * \param index
+ * \return true if index is inside text and the character at index is an ASCII digit.
+ */
+static inline bool isDigit(const QString &text, int index)
+{
+  return index < text.length() && text[index].unicode() >= '0' && text[index].unicode() <= '9';
+}
+
+/*!
+ * \brief indexOfAnnotation
+ * \param text
+ * \return the index of the first annotation keyword in text or -1.
+ */
+static int indexOfAnnotation(const QString &text)
+{
+  const int length = 10;
+  int index = 0;
+  while ((index = text.indexOf(QLatin1String("annotation"), index)) != -1) {
+    if ((index == 0 || !isIdentifierCharacter(text[index - 1]))
+        && (index + length == text.length() || !isIdentifierCharacter(text[index + length]))) {
+      return index;
+    }
+    index += length;
+  }
+  return -1;
+}
+
 /*!
  * \brief ModelicaTextHighlighter::highlightMultiLine
- * Highlights the multilines text.
- * Quoted text or multiline comments.
+ * Highlights the text block in a single pass.
+ * Identifiers, keywords, types, functions and numbers are classified as they are scanned.
+ * Quoted text and multiline comments are carried over to the next block through the block state.
+ * The parentheses and the annotation folding information are stored in the TextBlockUserData in the same pass.
  * \param text
  */
 void ModelicaHighlighter::highlightMultiLine(const QString &text)
@@ -622,8 +652,9 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
   if (pPreviousTextBlockUserData) {
     foldingState = pPreviousTextBlockUserData->foldingState();
   }
-  QRegExp annotationRegExp("\\bannotation\\b");
-  int annotationIndex = annotationRegExp.indexIn(text);
+  int annotationIndex = indexOfAnnotation(text);
+  bool matchParenthesesCommentsQuotes = !mpModelicaEditorPage
+      || mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked();
   // store parentheses info
   Parentheses parentheses;
   TextBlockUserData *pTextBlockUserData = BaseEditorDocumentLayout::userData(currentBlock());
@@ -633,6 +664,7 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
     pTextBlockUserData->setFoldingEndIncluded(false);
   }
   while (index < text.length()) {
+    bool startFolding = false;
     switch (blockState) {
       /* if the block already has single line comment then don't check for multi line comment and quotes. */
       case 1:
@@ -668,17 +700,58 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
         } else if (text[index] == '"') {
           startIndex = index;
           blockState = 3;
+        } else if (isIdentifierStart(text[index])) {
+          int start = index;
+          while (index + 1 < text.length() && isIdentifierCharacter(text[index + 1])) {
+            index++;
+          }
+          int length = index - start + 1;
+          const QString word = QString::fromRawData(text.unicode() + start, length);
+          if (mKeywords.contains(word)) {
+            setFormat(start, length, mKeywordFormat);
+            // check for annotation start if annotation keyword is at the end of the line or is followed by '(' or space.
+            if (!foldingState && word == QLatin1String("annotation")
+                && (index + 1 == text.length() || text[index + 1] == '(' || text[index + 1] == ' ')) {
+              foldingState = true;
+              startFolding = true;
+            }
+          } else if (mTypes.contains(word)) {
+            setFormat(start, length, mTypeFormat);
+          } else if (index + 1 < text.length() && text[index + 1] == '(') {
+            setFormat(start, length, mFunctionFormat);
+          }
+        } else if (isDigit(text, index)) {
+          int start = index;
+          while (isDigit(text, index + 1)) {
+            index++;
+          }
+          if (index + 1 < text.length() && text[index + 1] == '.') {
+            index++;
+            while (isDigit(text, index + 1)) {
+              index++;
+            }
+          }
+          if (index + 1 < text.length() && (text[index + 1] == 'e' || text[index + 1] == 'E')) {
+            index++;
+            if (index + 1 < text.length() && (text[index + 1] == '+' || text[index + 1] == '-')) {
+              index++;
+            }
+            while (isDigit(text, index + 1)) {
+              index++;
+            }
+          }
+          setFormat(start, index - start + 1, mNumberFormat);
         }
     }
     // if no single line comment, no multi line comment and no quotes then store the parentheses
-    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getMatchParenthesesCommentsQuotesCheckBox()->isChecked())) {
+    if (pTextBlockUserData && (blockState < 1 || blockState > 3 || matchParenthesesCommentsQuotes)) {
       if (text[index] == '(' || text[index] == '{' || text[index] == '[') {
         parentheses.append(Parenthesis(Parenthesis::Opened, text[index], index));
       } else if (text[index] == ')' || text[index] == '}' || text[index] == ']') {
         parentheses.append(Parenthesis(Parenthesis::Closed, text[index], index));
       }
     }
-    if (pTextBlockUserData && foldingState) {
+    if (pTextBlockUserData && foldingState && !startFolding) {
       // if no single line comment, no multi line comment and no quotes then check for annotation end
       if (blockState < 1 || blockState > 3) {
         if (text[index] == ';') {
@@ -705,21 +778,6 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
       } else if (pTextBlockUserData && startIndex < annotationIndex) {  // if we have annotation word before quote or comment block is starting then fold.
         pTextBlockUserData->setFoldingIndent(1);
       }
-    } else {
-      // if no single line comment, no multi line comment and no quotes then check for annotation start
-      if (blockState < 1 || blockState > 3) {
-        if (text[index] == 'a' && index+9<text.length() && text[index+1] == 'n' && text[index+2] == 'n' && text[index+3] == 'o'
-            && text[index+4] == 't' && text[index+5] == 'a' && text[index+6] == 't' && text[index+7] == 'i' && text[index+8] == 'o'
-            && text[index+9] == 'n') {
-          if (index+9 == text.length() - 1) { // if we just have annotation keyword in the line
-            index = index + 8;
-            foldingState = true;
-          } else if (index+10<text.length() && (text[index+10] == '(' || text[index+10] == ' ')) { // if annotation keyword is followed by '(' or space.
-            index = index + 9;
-            foldingState = true;
-          }
-        }
-      }
     }
     index++;
   }
@@ -751,7 +809,7 @@ void ModelicaHighlighter::highlightMultiLine(const QString &text)
 void ModelicaHighlighter::highlightBlock(const QString &text)
 {
   /* Only highlight the text if user has enabled the syntax highlighting */
-  if (!mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getSyntaxHighlightingGroupBox()->isChecked()) {
+  if (mpModelicaEditorPage && !mpModelicaEditorPage->getOptionsDialog()->getTextEditorPage()->getSyntaxHighlightingGroupBox()->isChecked()) {
     return;
   }
   // set text block state
@@ -760,16 +818,7 @@ void ModelicaHighlighter::highlightBlock(const QString &text)
   if (pTextBlockUserData) {
     pTextBlockUserData->setFoldingState(false);
   }
-  setFormat(0, text.length(), mpModelicaEditorPage->getColor("Text"));
-  foreach (const HighlightingRule &rule, mHighlightingRules) {
-    QRegExp expression(rule.mPattern);
-    int index = expression.indexIn(text);
-    while (index >= 0) {
-      int length = expression.matchedLength();
-      setFormat(index, length, rule.mFormat);
-      index = expression.indexIn(text, index + length);
-    }
-  }
+  setFormat(0, text.length(), mTextFormat);
   highlightMultiLine(text);
 }
 
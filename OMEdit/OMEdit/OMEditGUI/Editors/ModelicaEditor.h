@@ -40,6 +40,7 @@
 #include "Editors/BaseEditor.h"
 
 #include <QSyntaxHighlighter>
+#include <QSet>
 
 class ModelWidget;
 class LibraryTreeItem;
@@ -89,12 +90,8 @@ protected:
 private:
   ModelicaEditorPage *mpModelicaEditorPage;
   QPlainTextEdit *mpPlainTextEdit;
-  struct HighlightingRule
-  {
-    QRegExp mPattern;
-    QTextCharFormat mFormat;
-  };
-  QVector<HighlightingRule> mHighlightingRules;
+  QSet<QString> mKeywords;
+  QSet<QString> mTypes;
   QTextCharFormat mTextFormat;
   QTextCharFormat mKeywordFormat;
   QTextCharFormat mTypeFormat;
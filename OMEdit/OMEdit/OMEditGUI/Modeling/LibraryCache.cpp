@@ -0,0 +1,274 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "LibraryCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDirIterator>
+
+#define LIBRARY_CACHE_MAGIC 0x4F4D4C43 // OMLC
+#define LIBRARY_CACHE_VERSION 1
+#define PIXMAP_CACHE_MAGIC 0x4F4D5043 // OMPC
+
+/*!
+ * \class LibraryCache
+ * \brief Persistent cache of the library class metadata.
+ * The cache file is written to the libraries folder next to the OMEdit settings file.
+ * It is keyed by the OpenModelica version, the library file names, their modification times and their contents.
+ * So any change to the library files makes the cache invalid.
+ */
+/*!
+ * \brief LibraryCache::LibraryCache
+ * \param libraryName - the top level class name.
+ * \param fileName - the file containing the top level class.
+ */
+LibraryCache::LibraryCache(QString libraryName, QString fileName)
+  : mLibraryName(libraryName), mFileName(fileName)
+{
+  mKey = computeKey();
+}
+
+/*!
+ * \brief LibraryCache::read
+ * Reads the cached class names and class information.
+ * \param pClassNames
+ * \param pClassesInformation
+ * \return true if the cache exists and is valid for the current library files.
+ */
+bool LibraryCache::read(QStringList *pClassNames, QList<OMCInterface::getClassInformation_res> *pClassesInformation)
+{
+  if (mKey.isEmpty()) {
+    return false;
+  }
+  QFile file(getCacheFileName());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_4_8);
+  quint32 magic, version;
+  QByteArray key;
+  in >> magic >> version >> key;
+  if (magic != LIBRARY_CACHE_MAGIC || version != LIBRARY_CACHE_VERSION || key != mKey) {
+    return false;
+  }
+  QStringList classNames;
+  QList<OMCInterface::getClassInformation_res> classesInformation;
+  qint32 count;
+  in >> count;
+  for (qint32 i = 0 ; i < count && in.status() == QDataStream::Ok ; i++) {
+    QString className;
+    OMCInterface::getClassInformation_res classInformation;
+    bool partialPrefix, finalPrefix, encapsulatedPrefix, fileReadOnly, isProtectedClass, isDocumentationClass, state;
+    qint32 lineNumberStart, columnNumberStart, lineNumberEnd, columnNumberEnd;
+    QStringList dimensions;
+    in >> className >> classInformation.restriction >> classInformation.comment >> partialPrefix >> finalPrefix >> encapsulatedPrefix
+       >> classInformation.fileName >> fileReadOnly >> lineNumberStart >> columnNumberStart >> lineNumberEnd >> columnNumberEnd
+       >> dimensions >> isProtectedClass >> isDocumentationClass >> classInformation.version >> classInformation.preferredView >> state
+       >> classInformation.access;
+    classInformation.partialPrefix = partialPrefix;
+    classInformation.finalPrefix = finalPrefix;
+    classInformation.encapsulatedPrefix = encapsulatedPrefix;
+    classInformation.fileReadOnly = fileReadOnly;
+    classInformation.lineNumberStart = lineNumberStart;
+    classInformation.columnNumberStart = columnNumberStart;
+    classInformation.lineNumberEnd = lineNumberEnd;
+    classInformation.columnNumberEnd = columnNumberEnd;
+    classInformation.dimensions = dimensions;
+    classInformation.isProtectedClass = isProtectedClass;
+    classInformation.isDocumentationClass = isDocumentationClass;
+    classInformation.state = state;
+    classNames.append(className);
+    classesInformation.append(classInformation);
+  }
+  if (in.status() != QDataStream::Ok || classNames.size() != count) {
+    return false;
+  }
+  *pClassNames = classNames;
+  *pClassesInformation = classesInformation;
+  return true;
+}
+
+/*!
+ * \brief LibraryCache::write
+ * Writes the class names and class information to the cache file.
+ * \param classNames
+ * \param classesInformation
+ */
+void LibraryCache::write(const QStringList &classNames, const QList<OMCInterface::getClassInformation_res> &classesInformation)
+{
+  if (mKey.isEmpty() || classNames.size() != classesInformation.size()) {
+    return;
+  }
+  QString cacheFileName = getCacheFileName();
+  QDir().mkpath(QFileInfo(cacheFileName).absolutePath());
+  // write to a temporary file first so a running OMEdit never reads a half written cache.
+  QString temporaryFileName = cacheFileName + ".tmp";
+  QFile file(temporaryFileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return;
+  }
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_4_8);
+  out << (quint32)LIBRARY_CACHE_MAGIC << (quint32)LIBRARY_CACHE_VERSION << mKey << (qint32)classNames.size();
+  for (int i = 0 ; i < classNames.size() ; i++) {
+    const OMCInterface::getClassInformation_res &classInformation = classesInformation.at(i);
+    QStringList dimensions = classInformation.dimensions;
+    out << classNames.at(i) << classInformation.restriction << classInformation.comment << (bool)classInformation.partialPrefix
+        << (bool)classInformation.finalPrefix << (bool)classInformation.encapsulatedPrefix << classInformation.fileName
+        << (bool)classInformation.fileReadOnly << (qint32)classInformation.lineNumberStart << (qint32)classInformation.columnNumberStart
+        << (qint32)classInformation.lineNumberEnd << (qint32)classInformation.columnNumberEnd << dimensions
+        << (bool)classInformation.isProtectedClass << (bool)classInformation.isDocumentationClass << classInformation.version
+        << classInformation.preferredView << (bool)classInformation.state << classInformation.access;
+  }
+  file.close();
+  QFile::remove(cacheFileName);
+  QFile::rename(temporaryFileName, cacheFileName);
+}
+
+/*!
+ * \brief LibraryCache::readPixmaps
+ * Reads the cached library browser pixmap and drag pixmap of a class.
+ * \param key - the key computed from the class icon annotations.
+ * \param pPixmap
+ * \param pDragPixmap
+ * \return true if the pixmaps are found in the cache.
+ */
+bool LibraryCache::readPixmaps(const QByteArray &key, QPixmap *pPixmap, QPixmap *pDragPixmap)
+{
+  if (key.isEmpty()) {
+    return false;
+  }
+  QFile file(getPixmapCacheFileName(key));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_4_8);
+  quint32 magic, version;
+  QPixmap pixmap, dragPixmap;
+  in >> magic >> version >> pixmap >> dragPixmap;
+  if (in.status() != QDataStream::Ok || magic != PIXMAP_CACHE_MAGIC || version != LIBRARY_CACHE_VERSION) {
+    return false;
+  }
+  *pPixmap = pixmap;
+  *pDragPixmap = dragPixmap;
+  return true;
+}
+
+/*!
+ * \brief LibraryCache::writePixmaps
+ * Writes the library browser pixmap and drag pixmap of a class to the cache.
+ * \param key - the key computed from the class icon annotations.
+ * \param pixmap
+ * \param dragPixmap
+ */
+void LibraryCache::writePixmaps(const QByteArray &key, const QPixmap &pixmap, const QPixmap &dragPixmap)
+{
+  if (key.isEmpty()) {
+    return;
+  }
+  QString cacheFileName = getPixmapCacheFileName(key);
+  QDir().mkpath(QFileInfo(cacheFileName).absolutePath());
+  QString temporaryFileName = cacheFileName + ".tmp";
+  QFile file(temporaryFileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return;
+  }
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_4_8);
+  out << (quint32)PIXMAP_CACHE_MAGIC << (quint32)LIBRARY_CACHE_VERSION << pixmap << dragPixmap;
+  file.close();
+  QFile::remove(cacheFileName);
+  QFile::rename(temporaryFileName, cacheFileName);
+}
+
+/*!
+ * \brief LibraryCache::getCacheFileName
+ * Returns the cache file name of the library.\n
+ * The name contains a hash of the library file path so libraries with the same name loaded from different places don't share a cache file.
+ * \return
+ */
+QString LibraryCache::getCacheFileName() const
+{
+  QString settingsPath = QFileInfo(Utilities::getApplicationSettings()->fileName()).absolutePath();
+  QByteArray pathHash = QCryptographicHash::hash(QFileInfo(mFileName).absoluteFilePath().toUtf8(), QCryptographicHash::Md5).toHex();
+  return QString("%1/libraries/%2-%3.cache").arg(settingsPath).arg(mLibraryName).arg(QString(pathHash));
+}
+
+/*!
+ * \brief LibraryCache::getPixmapCacheFileName
+ * Returns the pixmap cache file name for the key.
+ * \param key
+ * \return
+ */
+QString LibraryCache::getPixmapCacheFileName(const QByteArray &key)
+{
+  QString settingsPath = QFileInfo(Utilities::getApplicationSettings()->fileName()).absolutePath();
+  return QString("%1/libraries/pixmaps/%2.pixmap").arg(settingsPath).arg(QString(key.toHex()));
+}
+
+/*!
+ * \brief LibraryCache::computeKey
+ * Computes the cache key from the OpenModelica version and the library files.\n
+ * If the library is stored as package.mo then all the files in the library directory are used.
+ * \return the key or an empty QByteArray if the library file doesn't exist.
+ */
+QByteArray LibraryCache::computeKey() const
+{
+  QFileInfo fileInfo(mFileName);
+  if (mFileName.isEmpty() || !fileInfo.exists()) {
+    return QByteArray();
+  }
+  QStringList fileNames;
+  if (fileInfo.fileName().compare("package.mo") == 0) {
+    QDirIterator dirIterator(fileInfo.absolutePath(), QStringList() << "*.mo" << "package.order", QDir::Files, QDirIterator::Subdirectories);
+    while (dirIterator.hasNext()) {
+      fileNames.append(dirIterator.next());
+    }
+    fileNames.sort();
+  } else {
+    fileNames.append(fileInfo.absoluteFilePath());
+  }
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(Helper::OpenModelicaVersion.toUtf8());
+  foreach (QString fileName, fileNames) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return QByteArray();
+    }
+    hash.addData(fileName.toUtf8());
+    hash.addData(QByteArray::number(QFileInfo(file).lastModified().toMSecsSinceEpoch()));
+    hash.addData(file.readAll());
+  }
+  return hash.result();
+}
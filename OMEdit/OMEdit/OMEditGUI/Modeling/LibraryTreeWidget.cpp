@@ -33,6 +33,7 @@
  */
 
 #include "LibraryTreeWidget.h"
+#include "LibraryCache.h"
 #include "ItemDelegate.h"
 #include "MainWindow.h"
 #include "ModelWidgetContainer.h"
@@ -46,6 +47,8 @@
 #include "Git/GitCommands.h"
 #include "Git/CommitChangesDialog.h"
 
+#include <QCryptographicHash>
+
 /*!
  * \class LibraryTreeItem
  * \brief Contains the information about the Modelica class.
@@ -71,6 +74,7 @@ LibraryTreeItem::LibraryTreeItem()
   setSaveContentsType(LibraryTreeItem::SaveInOneFile);
   setPixmap(QPixmap());
   setDragPixmap(QPixmap());
+  setPixmapDirty(false);
   setClassTextBefore("");
   setClassText("");
   setClassTextAfter("");
@@ -106,6 +110,7 @@ LibraryTreeItem::LibraryTreeItem(LibraryType type, QString text, QString nameStr
   mpParentLibraryTreeItem = pParent;
   setPixmap(QPixmap());
   setDragPixmap(QPixmap());
+  setPixmapDirty(false);
   setName(text);
   setNameStructure(nameStructure);
   if (type == LibraryTreeItem::Modelica) {
@@ -907,8 +912,8 @@ void LibraryTreeItem::handleLoaded(LibraryTreeItem *pLibraryTreeItem)
       mpModelWidget->getDiagramGraphicsView()->removeInitialStatesFromView();
     }
     mpModelWidget->getModelConnections();
-    // load new icon for the class.
-    pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this);
+    // reload the icon of the class once it is shown in the view.
+    setPixmapDirty(true);
     // update the icon in the libraries browser view.
     pMainWindow->getLibraryWidget()->getLibraryTreeModel()->updateLibraryTreeItem(this);
   }
@@ -929,8 +934,8 @@ void LibraryTreeItem::handleUnloaded()
       mpModelWidget->getDiagramGraphicsView()->removeInitialStatesFromView();
     }
     MainWindow *pMainWindow = MainWindow::instance();
-    // load new icon for the class.
-    pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this);
+    // reload the icon of the class once it is shown in the view.
+    setPixmapDirty(true);
     // update the icon in the libraries browser view.
     pMainWindow->getLibraryWidget()->getLibraryTreeModel()->updateLibraryTreeItem(this);
   }
@@ -995,8 +1000,8 @@ void LibraryTreeItem::handleConnectionAdded(LineAnnotation *pConnectionLineAnnot
 void LibraryTreeItem::handleIconUpdated()
 {
   MainWindow *pMainWindow = MainWindow::instance();
-  // load new icon for the class.
-  pMainWindow->getLibraryWidget()->getLibraryTreeModel()->loadLibraryTreeItemPixmap(this);
+  // reload the icon of the class once it is shown in the view.
+  setPixmapDirty(true);
   // update the icon in the libraries browser view.
   pMainWindow->getLibraryWidget()->getLibraryTreeModel()->updateLibraryTreeItem(this);
   emit iconUpdated();
@@ -1091,6 +1096,11 @@ LibraryTreeModel::LibraryTreeModel(LibraryWidget *pLibraryWidget)
 {
   mpLibraryWidget = pLibraryWidget;
   mpRootLibraryTreeItem = new LibraryTreeItem;
+  mLoadingQueuedPixmaps = false;
+  mLoadedQueuedPixmapsCount = 0;
+  mPixmapQueueTimer.setSingleShot(true);
+  mPixmapQueueTimer.setInterval(0);
+  connect(&mPixmapQueueTimer, SIGNAL(timeout()), SLOT(loadQueuedLibraryTreeItemPixmaps()));
 }
 
 /*!
@@ -1208,6 +1218,10 @@ QVariant LibraryTreeModel::data(const QModelIndex &index, int role) const
 
 
   LibraryTreeItem *pLibraryTreeItem = static_cast<LibraryTreeItem*>(index.internalPointer());
+  // the views only ask for the decoration of the visible items so this is where the pixmap rendering is queued.
+  if (role == Qt::DecorationRole && pLibraryTreeItem->isPixmapDirty()) {
+    const_cast<LibraryTreeModel*>(this)->queueLibraryTreeItemPixmap(pLibraryTreeItem);
+  }
   return pLibraryTreeItem->data(index.column(), role);
 }
 
@@ -1228,7 +1242,8 @@ Qt::ItemFlags LibraryTreeModel::flags(const QModelIndex &index) const
 
 /*!
  * \brief LibraryTreeModel::findLibraryTreeItem
- * Finds the LibraryTreeItem based on the name and case sensitivity.
+ * Finds the LibraryTreeItem based on the name and case sensitivity.\n
+ * Uses the name structure index instead of walking the tree. If pLibraryTreeItem is given then only its descendants are returned.
  * \param name
  * \param pLibraryTreeItem
  * \return
@@ -1242,9 +1257,26 @@ LibraryTreeItem* LibraryTreeModel::findLibraryTreeItem(const QString &name, Libr
   if (pLibraryTreeItem->getNameStructure().compare(name, caseSensitivity) == 0) {
     return pLibraryTreeItem;
   }
-  for (int i = pLibraryTreeItem->childrenSize(); --i >= 0; ) {
-    if (LibraryTreeItem *item = findLibraryTreeItem(name, pLibraryTreeItem->childAt(i), caseSensitivity)) {
-      return item;
+  QList<LibraryTreeItem*> libraryTreeItems;
+  if (caseSensitivity == Qt::CaseSensitive) {
+    libraryTreeItems = mLibraryTreeItemsHash.values(name);
+  } else {
+    libraryTreeItems = mLibraryTreeItemsCaseInsensitiveHash.values(name.toLower());
+  }
+  foreach (LibraryTreeItem *pIndexedLibraryTreeItem, libraryTreeItems) {
+    if (pIndexedLibraryTreeItem->getNameStructure().compare(name, caseSensitivity) != 0) {
+      continue;
+    }
+    // all indexed items are part of the tree so only check the ancestors when searching a sub tree.
+    if (pLibraryTreeItem == mpRootLibraryTreeItem) {
+      return pIndexedLibraryTreeItem;
+    }
+    LibraryTreeItem *pParentLibraryTreeItem = pIndexedLibraryTreeItem->parent();
+    while (pParentLibraryTreeItem && pParentLibraryTreeItem != pLibraryTreeItem) {
+      pParentLibraryTreeItem = pParentLibraryTreeItem->parent();
+    }
+    if (pParentLibraryTreeItem) {
+      return pIndexedLibraryTreeItem;
     }
   }
   return 0;
@@ -1311,6 +1343,38 @@ LibraryTreeItem* LibraryTreeModel::findNonExistingLibraryTreeItem(const QString
   return 0;
 }
 
+/*!
+ * \brief LibraryTreeModel::addLibraryTreeItemToIndex
+ * Adds the LibraryTreeItem and its children to the name structure index used by findLibraryTreeItem.\n
+ * Must be called whenever a LibraryTreeItem is inserted in the tree or after its name structure is changed.
+ * \param pLibraryTreeItem
+ */
+void LibraryTreeModel::addLibraryTreeItemToIndex(LibraryTreeItem *pLibraryTreeItem)
+{
+  mLibraryTreeItemsHash.insert(pLibraryTreeItem->getNameStructure(), pLibraryTreeItem);
+  mLibraryTreeItemsCaseInsensitiveHash.insert(pLibraryTreeItem->getNameStructure().toLower(), pLibraryTreeItem);
+  for (int i = 0; i < pLibraryTreeItem->childrenSize(); i++) {
+    addLibraryTreeItemToIndex(pLibraryTreeItem->child(i));
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::removeLibraryTreeItemFromIndex
+ * Removes the LibraryTreeItem and its children from the name structure index.\n
+ * Must be called whenever a LibraryTreeItem is removed from the tree or before its name structure is changed.
+ * \param pLibraryTreeItem
+ */
+void LibraryTreeModel::removeLibraryTreeItemFromIndex(LibraryTreeItem *pLibraryTreeItem)
+{
+  mLibraryTreeItemsHash.remove(pLibraryTreeItem->getNameStructure(), pLibraryTreeItem);
+  mLibraryTreeItemsCaseInsensitiveHash.remove(pLibraryTreeItem->getNameStructure().toLower(), pLibraryTreeItem);
+  // the item might be deleted so make sure we don't try to render its pixmap.
+  mPixmapLibraryTreeItemsQueue.removeOne(pLibraryTreeItem);
+  for (int i = 0; i < pLibraryTreeItem->childrenSize(); i++) {
+    removeLibraryTreeItemFromIndex(pLibraryTreeItem->child(i));
+  }
+}
+
 /*!
  * \brief LibraryTreeModel::libraryTreeItemIndex
  * Finds the QModelIndex attached to LibraryTreeItem.
@@ -1368,6 +1432,10 @@ LibraryTreeItem* LibraryTreeModel::createLibraryTreeItem(QString name, LibraryTr
                                                          bool isSystemLibrary, bool load, int row, bool activateAccessAnnotations)
 {
   QString nameStructure = pParentLibraryTreeItem->getNameStructure().isEmpty() ? name : pParentLibraryTreeItem->getNameStructure() + "." + name;
+  // a loaded library can define the classes that the pixmap cache keys referred to before.
+  if (pParentLibraryTreeItem == mpRootLibraryTreeItem) {
+    mPixmapCacheKeyData.clear();
+  }
   // check if is in non-existing classes.
   LibraryTreeItem *pLibraryTreeItem = findNonExistingLibraryTreeItem(nameStructure);
   if (pLibraryTreeItem && pLibraryTreeItem->isNonExisting()) {
@@ -1467,6 +1535,7 @@ LibraryTreeItem* LibraryTreeModel::createLibraryTreeItem(QString name, QString n
   LibraryTreeItem *pLibraryTreeItem = createOMSLibraryTreeItemImpl(name, nameStructure, path, isSaved, pParentLibraryTreeItem,
                                                                    pOMSElement, pOMSConnector, pOMSBusConnector, pOMSTLMBusConnector);
   pParentLibraryTreeItem->insertChild(row, pLibraryTreeItem);
+  addLibraryTreeItemToIndex(pLibraryTreeItem);
   endInsertRows();
   // create library tree items
   createLibraryTreeItems(pLibraryTreeItem);
@@ -1674,17 +1743,32 @@ LibraryTreeItem* LibraryTreeModel::getContainingFileParentLibraryTreeItem(Librar
 /*!
  * \brief LibraryTreeModel::loadLibraryTreeItemPixmap
  * Loads a pixmap for LibraryTreeItem
- * The pixmap is based on Modelica class icon representation
+ * The pixmap is based on Modelica class icon representation.\n
+ * The pixmaps of the system libraries are cached on disk. If a ModelWidget is created just for rendering the pixmap then it is deleted afterwards.
  * \param pLibraryTreeItem
  */
 void LibraryTreeModel::loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem)
 {
+  pLibraryTreeItem->setPixmapDirty(false);
   // Return if the class is OMSimulator connector.
   if (pLibraryTreeItem->getLibraryType() == LibraryTreeItem::OMS /*&& pLibraryTreeItem->getOMSConnector()*/) {
     return;
   }
+  int libraryIconSize = OptionsDialog::instance()->getGeneralSettingsPage()->getLibraryIconSizeSpinBox()->value();
+  QByteArray pixmapCacheKey;
+  bool deleteModelWidget = false;
   if (!pLibraryTreeItem->getModelWidget()) {
+    if (pLibraryTreeItem->isSystemLibrary() && pLibraryTreeItem->getLibraryType() == LibraryTreeItem::Modelica) {
+      pixmapCacheKey = getLibraryTreeItemPixmapCacheKey(pLibraryTreeItem, libraryIconSize);
+      QPixmap libraryPixmap, dragPixmap;
+      if (LibraryCache::readPixmaps(pixmapCacheKey, &libraryPixmap, &dragPixmap)) {
+        pLibraryTreeItem->setPixmap(libraryPixmap);
+        pLibraryTreeItem->setDragPixmap(dragPixmap);
+        return;
+      }
+    }
     showModelWidget(pLibraryTreeItem, false);
+    deleteModelWidget = true;
   }
   GraphicsView *pGraphicsView = pLibraryTreeItem->getModelWidget()->getIconGraphicsView();
   if (pGraphicsView && pGraphicsView->hasAnnotation()) {
@@ -1701,7 +1785,6 @@ void LibraryTreeModel::loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeIt
     rectangle.setY(rectangle.y() - adjust);
     rectangle.setWidth(rectangle.width() + adjust);
     rectangle.setHeight(rectangle.height() + adjust);
-    int libraryIconSize = OptionsDialog::instance()->getGeneralSettingsPage()->getLibraryIconSizeSpinBox()->value();
     QPixmap libraryPixmap(QSize(libraryIconSize, libraryIconSize));
     libraryPixmap.fill(QColor(Qt::transparent));
     QPainter libraryPainter(&libraryPixmap);
@@ -1731,6 +1814,138 @@ void LibraryTreeModel::loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeIt
     pLibraryTreeItem->setPixmap(QPixmap());
     pLibraryTreeItem->setDragPixmap(QPixmap());
   }
+  if (!pixmapCacheKey.isEmpty()) {
+    LibraryCache::writePixmaps(pixmapCacheKey, pLibraryTreeItem->getPixmap(), pLibraryTreeItem->getDragPixmap());
+  }
+  if (deleteModelWidget) {
+    pLibraryTreeItem->getModelWidget()->clearGraphicsViews();
+    pLibraryTreeItem->getModelWidget()->deleteLater();
+    pLibraryTreeItem->setModelWidget(0);
+    // the inherited classes are added again when the ModelWidget is created
+    pLibraryTreeItem->removeInheritedClasses();
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::queueLibraryTreeItemPixmap
+ * Adds the LibraryTreeItem to the queue of pixmaps that are rendered when the application is idle.
+ * \param pLibraryTreeItem
+ */
+void LibraryTreeModel::queueLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem)
+{
+  if (!mPixmapLibraryTreeItemsQueue.contains(pLibraryTreeItem)) {
+    mPixmapLibraryTreeItemsQueue.append(pLibraryTreeItem);
+  }
+  if (!mLoadingQueuedPixmaps && !mPixmapQueueTimer.isActive()) {
+    mPixmapQueueTimer.start(0);
+  }
+}
+
+/*!
+ * \brief LibraryTreeModel::getLibraryTreeItemPixmapCacheKey
+ * Computes the pixmap cache key from the icon annotations and components of the class and its base classes.\n
+ * The icons of the public component classes, e.g., the connectors, and their base classes are also part of the key.
+ * The OMC data of each class is fetched once per session and kept in mPixmapCacheKeyData.
+ * \param pLibraryTreeItem
+ * \param libraryIconSize
+ * \return
+ */
+QByteArray LibraryTreeModel::getLibraryTreeItemPixmapCacheKey(LibraryTreeItem *pLibraryTreeItem, int libraryIconSize)
+{
+  LibraryTreeItem *pTopLevelLibraryTreeItem = pLibraryTreeItem;
+  while (pTopLevelLibraryTreeItem->parent() && !pTopLevelLibraryTreeItem->parent()->isRootItem()) {
+    pTopLevelLibraryTreeItem = pTopLevelLibraryTreeItem->parent();
+  }
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(Helper::OpenModelicaVersion.toUtf8());
+  hash.addData(pTopLevelLibraryTreeItem->mClassInformation.version.toUtf8());
+  hash.addData(QByteArray::number(libraryIconSize));
+  hash.addData(pLibraryTreeItem->getNameStructure().toUtf8());
+  OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+  // the class and its base classes are hashed with their components. The component classes only with their icons.
+  QStringList classNames, iconClassNames;
+  classNames << pLibraryTreeItem->getNameStructure();
+  QSet<QString> visitedClassNames, visitedIconClassNames;
+  visitedClassNames << pLibraryTreeItem->getNameStructure();
+  while (!classNames.isEmpty() || !iconClassNames.isEmpty()) {
+    // fetch the data of the classes that are not known yet in one round trip.
+    QStringList expressions, fetchClassNames, fetchIconClassNames;
+    foreach (QString className, classNames) {
+      if (!mPixmapCacheKeyData.contains(className) || !mPixmapCacheKeyData.value(className).mHasComponents) {
+        fetchClassNames << className;
+        expressions << QString("getIconAnnotation(%1)").arg(className) << QString("getInheritedClasses(%1)").arg(className)
+                    << QString("getComponents(%1, useQuotes = true)").arg(className);
+      }
+    }
+    foreach (QString className, iconClassNames) {
+      if (!mPixmapCacheKeyData.contains(className)) {
+        fetchIconClassNames << className;
+        expressions << QString("getIconAnnotation(%1)").arg(className) << QString("getInheritedClasses(%1)").arg(className);
+      }
+    }
+    if (!expressions.isEmpty()) {
+      QStringList results = pOMCProxy->sendCommands(expressions);
+      int i = 0;
+      foreach (QString className, fetchClassNames + fetchIconClassNames) {
+        PixmapCacheKeyData pixmapCacheKeyData;
+        QCryptographicHash iconHash(QCryptographicHash::Md5);
+        iconHash.addData(results.at(i).toUtf8());
+        iconHash.addData(results.at(i + 1).toUtf8());
+        pixmapCacheKeyData.mIconHash = iconHash.result();
+        foreach (QString inheritedClass, StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(results.at(i + 1)))) {
+          if (!inheritedClass.isEmpty()) {
+            pixmapCacheKeyData.mInheritedClasses << inheritedClass;
+          }
+        }
+        pixmapCacheKeyData.mHasComponents = fetchClassNames.contains(className);
+        if (pixmapCacheKeyData.mHasComponents) {
+          pixmapCacheKeyData.mComponentsHash = QCryptographicHash::hash(results.at(i + 2).toUtf8(), QCryptographicHash::Md5);
+          QList<ComponentInfo*> componentInfoList = pOMCProxy->parseComponents(results.at(i + 2));
+          foreach (ComponentInfo *pComponentInfo, componentInfoList) {
+            if (!pComponentInfo->getProtected()) {
+              pixmapCacheKeyData.mComponentClasses << pComponentInfo->getClassName();
+            }
+          }
+          qDeleteAll(componentInfoList);
+          i += 3;
+        } else {
+          i += 2;
+        }
+        mPixmapCacheKeyData.insert(className, pixmapCacheKeyData);
+      }
+    }
+    QStringList nextClassNames, nextIconClassNames;
+    foreach (QString className, classNames) {
+      const PixmapCacheKeyData &pixmapCacheKeyData = mPixmapCacheKeyData[className];
+      hash.addData(pixmapCacheKeyData.mIconHash);
+      hash.addData(pixmapCacheKeyData.mComponentsHash);
+      foreach (QString inheritedClass, pixmapCacheKeyData.mInheritedClasses) {
+        if (!visitedClassNames.contains(inheritedClass)) {
+          visitedClassNames << inheritedClass;
+          nextClassNames << inheritedClass;
+        }
+      }
+      foreach (QString componentClass, pixmapCacheKeyData.mComponentClasses) {
+        if (!visitedIconClassNames.contains(componentClass)) {
+          visitedIconClassNames << componentClass;
+          nextIconClassNames << componentClass;
+        }
+      }
+    }
+    foreach (QString className, iconClassNames) {
+      const PixmapCacheKeyData &pixmapCacheKeyData = mPixmapCacheKeyData[className];
+      hash.addData(pixmapCacheKeyData.mIconHash);
+      foreach (QString inheritedClass, pixmapCacheKeyData.mInheritedClasses) {
+        if (!visitedIconClassNames.contains(inheritedClass)) {
+          visitedIconClassNames << inheritedClass;
+          nextIconClassNames << inheritedClass;
+        }
+      }
+    }
+    classNames = nextClassNames;
+    iconClassNames = nextIconClassNames;
+  }
+  return hash.result();
 }
 
 /*!
@@ -2072,6 +2287,7 @@ bool LibraryTreeModel::unloadLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem,
     // remove the LibraryTreeItem from Libraries Browser
     row = pLibraryTreeItem->row();
     beginRemoveRows(libraryTreeItemIndex(pLibraryTreeItem), row, row);
+    removeLibraryTreeItemFromIndex(pLibraryTreeItem);
     pLibraryTreeItem->parent()->removeChild(pLibraryTreeItem);
     endRemoveRows();
     if (pNextLibraryTreeItem) {
@@ -2513,17 +2729,35 @@ QString LibraryTreeModel::readLibraryTreeItemClassTextFromFile(LibraryTreeItem *
 void LibraryTreeModel::createLibraryTreeItems(LibraryTreeItem *pLibraryTreeItem)
 {
   if (pLibraryTreeItem->getLibraryType() == LibraryTreeItem::Modelica) {
-    OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
-    QStringList libs = pOMCProxy->getClassNames(pLibraryTreeItem->getNameStructure(), true, true);
-    if (!libs.isEmpty()) {
-      libs.removeFirst();
-    }
-    LibraryTreeItem *pParentLibraryTreeItem = 0;
-    foreach (QString lib, libs) {
+    QStringList libs;
+    QList<OMCInterface::getClassInformation_res> classesInformation;
+    // the unmodified top level libraries are read from the library cache.
+    LibraryCache *pLibraryCache = 0;
+    if (pLibraryTreeItem->isTopLevel() && pLibraryTreeItem->isSaved()) {
+      pLibraryCache = new LibraryCache(pLibraryTreeItem->getNameStructure(), pLibraryTreeItem->getFileName());
+    }
+    if (!(pLibraryCache && pLibraryCache->read(&libs, &classesInformation))) {
+      OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
+      libs = pOMCProxy->getClassNames(pLibraryTreeItem->getNameStructure(), true, true);
+      if (!libs.isEmpty()) {
+        libs.removeFirst();
+      }
       /* $Code is a special OpenModelica keyword. No API command will work if we use it. */
-      if (lib.contains("$Code")) {
-        continue;
+      for (int i = libs.size() - 1 ; i >= 0 ; i--) {
+        if (libs.at(i).contains("$Code")) {
+          libs.removeAt(i);
+        }
       }
+      // fetch the class information of all the nested classes in one go.
+      classesInformation = pOMCProxy->getClassesInformation(libs);
+      if (pLibraryCache) {
+        pLibraryCache->write(libs, classesInformation);
+      }
+    }
+    delete pLibraryCache;
+    LibraryTreeItem *pParentLibraryTreeItem = 0;
+    for (int i = 0 ; i < libs.size() ; i++) {
+      QString lib = libs.at(i);
       QString name = StringHandler::getLastWordAfterDot(lib);
       QString parentName = StringHandler::removeLastWordAfterDot(lib);
       if (!(pParentLibraryTreeItem && pParentLibraryTreeItem->getNameStructure().compare(parentName) == 0)) {
@@ -2531,7 +2765,7 @@ void LibraryTreeModel::createLibraryTreeItems(LibraryTreeItem *pLibraryTreeItem)
       }
       if (pParentLibraryTreeItem) {
         createLibraryTreeItemImpl(name, pParentLibraryTreeItem, pParentLibraryTreeItem->isSaved(), false, false, -1,
-                                  pParentLibraryTreeItem->isAccessAnnotationsEnabled());
+                                  pParentLibraryTreeItem->isAccessAnnotationsEnabled(), &classesInformation.at(i));
       }
     }
   } else if (pLibraryTreeItem->getLibraryType() == LibraryTreeItem::OMS) {
@@ -2587,10 +2821,13 @@ void LibraryTreeModel::updateOMSChildLibraryTreeItemClassText(LibraryTreeItem *p
  * \param isSystemLibrary
  * \param load
  * \param row
+ * \param activateAccessAnnotations
+ * \param pClassInformation - the already fetched class information. If 0 then the class information is fetched from OMC.
  * \return
  */
 LibraryTreeItem* LibraryTreeModel::createLibraryTreeItemImpl(QString name, LibraryTreeItem *pParentLibraryTreeItem, bool isSaved,
-                                                             bool isSystemLibrary, bool load, int row, bool activateAccessAnnotations)
+                                                             bool isSystemLibrary, bool load, int row, bool activateAccessAnnotations,
+                                                             const OMCInterface::getClassInformation_res *pClassInformation)
 {
   QString nameStructure = pParentLibraryTreeItem->getNameStructure().isEmpty() ? name : pParentLibraryTreeItem->getNameStructure() + "." + name;
   // check if is in non-existing classes.
@@ -2602,13 +2839,17 @@ LibraryTreeItem* LibraryTreeModel::createLibraryTreeItemImpl(QString name, Libra
     if (load) {
       // create library tree items
       createLibraryTreeItems(pLibraryTreeItem);
-      // load the LibraryTreeItem pixmap
-      loadLibraryTreeItemPixmap(pLibraryTreeItem);
+      // the LibraryTreeItem pixmap is loaded when it is shown in the view
+      pLibraryTreeItem->setPixmapDirty(true);
     }
     updateLibraryTreeItem(pLibraryTreeItem);
   } else {
-    OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
-    OMCInterface::getClassInformation_res classInformation = pOMCProxy->getClassInformation(nameStructure);
+    OMCInterface::getClassInformation_res classInformation;
+    if (pClassInformation) {
+      classInformation = *pClassInformation;
+    } else {
+      classInformation = MainWindow::instance()->getOMCProxy()->getClassInformation(nameStructure);
+    }
     pLibraryTreeItem = new LibraryTreeItem(LibraryTreeItem::Modelica, name, nameStructure, classInformation, "", isSaved, pParentLibraryTreeItem);
     pLibraryTreeItem->setSystemLibrary(pParentLibraryTreeItem == mpRootLibraryTreeItem ? isSystemLibrary : pParentLibraryTreeItem->isSystemLibrary());
     pLibraryTreeItem->setAccessAnnotations(activateAccessAnnotations);
@@ -2616,11 +2857,12 @@ LibraryTreeItem* LibraryTreeModel::createLibraryTreeItemImpl(QString name, Libra
       row = pParentLibraryTreeItem->childrenSize();
     }
     pParentLibraryTreeItem->insertChild(row, pLibraryTreeItem);
+    addLibraryTreeItemToIndex(pLibraryTreeItem);
     if (load) {
       // create library tree items
       createLibraryTreeItems(pLibraryTreeItem);
-      // load the LibraryTreeItem pixmap
-      loadLibraryTreeItemPixmap(pLibraryTreeItem);
+      // the LibraryTreeItem pixmap is loaded when it is shown in the view
+      pLibraryTreeItem->setPixmapDirty(true);
     }
   }
   return pLibraryTreeItem;
@@ -2648,6 +2890,7 @@ void LibraryTreeModel::createNonExistingLibraryTreeItem(LibraryTreeItem *pLibrar
   QModelIndex index = libraryTreeItemIndex(pParentLibraryTreeItem);
   beginInsertRows(index, row, row);
   pParentLibraryTreeItem->insertChild(row, pLibraryTreeItem);
+  addLibraryTreeItemToIndex(pLibraryTreeItem);
   endInsertRows();
   pLibraryTreeItem->setNonExisting(false);
 }
@@ -2695,6 +2938,7 @@ LibraryTreeItem* LibraryTreeModel::createLibraryTreeItemImpl(LibraryTreeItem::Li
     row = pParentLibraryTreeItem->childrenSize();
   }
   pParentLibraryTreeItem->insertChild(row, pLibraryTreeItem);
+  addLibraryTreeItemToIndex(pLibraryTreeItem);
   if (pLibraryTreeItem->getLibraryType() == LibraryTreeItem::OMS) {
     // create library tree items
     createLibraryTreeItems(pLibraryTreeItem);
@@ -2829,9 +3073,11 @@ void LibraryTreeModel::unloadClassHelper(LibraryTreeItem *pLibraryTreeItem, Libr
   // make the class non expanded
   pLibraryTreeItem->setExpanded(false);
   pLibraryTreeItem->removeInheritedClasses();
+  mPixmapCacheKeyData.remove(pLibraryTreeItem->getNameStructure());
   // notify the inherits classes
   pLibraryTreeItem->emitUnLoaded();
   addNonExistingLibraryTreeItem(pLibraryTreeItem);
+  removeLibraryTreeItemFromIndex(pLibraryTreeItem);
   pParentLibraryTreeItem->removeChild(pLibraryTreeItem);
 }
 
@@ -2867,6 +3113,7 @@ void LibraryTreeModel::unloadFileHelper(LibraryTreeItem *pLibraryTreeItem, Libra
     }
     pLibraryTreeItem->getModelWidget()->deleteLater();
   }
+  removeLibraryTreeItemFromIndex(pLibraryTreeItem);
   pParentLibraryTreeItem->removeChild(pLibraryTreeItem);
   pLibraryTreeItem->deleteLater();
 }
@@ -2903,6 +3150,7 @@ void LibraryTreeModel::deleteFileHelper(LibraryTreeItem *pLibraryTreeItem, Libra
     }
     pLibraryTreeItem->getModelWidget()->deleteLater();
   }
+  removeLibraryTreeItemFromIndex(pLibraryTreeItem);
   pParentLibraryTreeItem->removeChild(pLibraryTreeItem);
   QFileInfo fileInfo(pLibraryTreeItem->getFileName());
   // delete the file/folder
@@ -2935,6 +3183,44 @@ void LibraryTreeModel::deleteFileChildren(LibraryTreeItem *pLibraryTreeItem)
   deleteFileHelper(pLibraryTreeItem, pLibraryTreeItem->parent());
 }
 
+/*!
+ * \brief LibraryTreeModel::loadQueuedLibraryTreeItemPixmaps
+ * Renders the queued pixmaps in small batches so the GUI stays responsive.\n
+ * The progress bar shows the rendered and the queued pixmaps until the queue is empty.\n
+ * Waits while OMCProxy::waitForCommand runs the event loop since rendering calls OMC.\n
+ * Slot activated when mPixmapQueueTimer timeout signal is raised.
+ */
+void LibraryTreeModel::loadQueuedLibraryTreeItemPixmaps()
+{
+  if (MainWindow::instance()->getOMCProxy()->isCommandPending()) {
+    mPixmapQueueTimer.start(100);
+    return;
+  }
+  mLoadingQueuedPixmaps = true;
+  MainWindow::instance()->showProgressBar();
+  QTime time;
+  time.start();
+  while (!mPixmapLibraryTreeItemsQueue.isEmpty() && time.elapsed() < 50) {
+    LibraryTreeItem *pLibraryTreeItem = mPixmapLibraryTreeItemsQueue.takeFirst();
+    if (pLibraryTreeItem->isPixmapDirty()) {
+      MainWindow::instance()->getStatusBar()->showMessage(QString(Helper::loading).append(": ").append(pLibraryTreeItem->getNameStructure()));
+      loadLibraryTreeItemPixmap(pLibraryTreeItem);
+      updateLibraryTreeItem(pLibraryTreeItem);
+    }
+    mLoadedQueuedPixmapsCount++;
+    MainWindow::instance()->getProgressBar()->setRange(0, mLoadedQueuedPixmapsCount + mPixmapLibraryTreeItemsQueue.size());
+    MainWindow::instance()->getProgressBar()->setValue(mLoadedQueuedPixmapsCount);
+  }
+  mLoadingQueuedPixmaps = false;
+  if (!mPixmapLibraryTreeItemsQueue.isEmpty()) {
+    mPixmapQueueTimer.start(0);
+  } else {
+    mLoadedQueuedPixmapsCount = 0;
+    MainWindow::instance()->getStatusBar()->clearMessage();
+    MainWindow::instance()->hideProgressBar();
+  }
+}
+
 /*!
  * \brief LibraryTreeModel::supportedDropActions
  * \return
@@ -3199,19 +3485,11 @@ LibraryTreeItem* LibraryTreeView::getSelectedLibraryTreeItem()
 void LibraryTreeView::libraryTreeItemExpanded(LibraryTreeItem *pLibraryTreeItem)
 {
   if (!pLibraryTreeItem->isExpanded()) {
-    // set the range for progress bar.
-    int progressValue = 0;
-    MainWindow::instance()->getProgressBar()->setRange(0, pLibraryTreeItem->childrenSize());
-    MainWindow::instance()->showProgressBar();
     pLibraryTreeItem->setExpanded(true);
+    // the children pixmaps are loaded when they are shown in the view. See LibraryTreeModel::data().
     for (int i = 0; i < pLibraryTreeItem->childrenSize(); i++) {
-      LibraryTreeItem *pChildLibraryTreeItem = pLibraryTreeItem->child(i);
-      MainWindow::instance()->getStatusBar()->showMessage(QString(Helper::loading).append(": ").append(pChildLibraryTreeItem->getNameStructure()));
-      mpLibraryWidget->getLibraryTreeModel()->loadLibraryTreeItemPixmap(pChildLibraryTreeItem);
-      MainWindow::instance()->getStatusBar()->clearMessage();
-      MainWindow::instance()->getProgressBar()->setValue(++progressValue);
+      pLibraryTreeItem->child(i)->setPixmapDirty(true);
     }
-    MainWindow::instance()->hideProgressBar();
   }
 }
 
@@ -4020,6 +4298,10 @@ void LibraryTreeView::startDrag(Qt::DropActions supportedActions)
     qreal adjust = 35;
     QDrag *drag = new QDrag(this);
     drag->setMimeData(mimeData);
+    // the item can be dragged before its queued pixmap is rendered.
+    if (pLibraryTreeItem->isPixmapDirty()) {
+      mpLibraryWidget->getLibraryTreeModel()->loadLibraryTreeItemPixmap(pLibraryTreeItem);
+    }
     // if we have component pixmap
     if (!pLibraryTreeItem->getDragPixmap().isNull()) {
       QPixmap pixmap = pLibraryTreeItem->getDragPixmap();
@@ -43,6 +43,8 @@
 
 #include <QTreeView>
 #include <QSortFilterProxyModel>
+#include <QMultiHash>
+#include <QTimer>
 
 class CompleterItem;
 class GraphicsView;
@@ -116,6 +118,8 @@ public:
   QPixmap getPixmap() {return mPixmap;}
   void setDragPixmap(QPixmap dragPixmap) {mDragPixmap = dragPixmap;}
   QPixmap getDragPixmap() {return mDragPixmap;}
+  void setPixmapDirty(bool pixmapDirty) {mPixmapDirty = pixmapDirty;}
+  bool isPixmapDirty() const {return mPixmapDirty;}
   void setClassTextBefore(QString classTextBefore) {mClassTextBefore = classTextBefore;}
   QString getClassTextBefore() {return mClassTextBefore;}
   void setClassText(QString classText);
@@ -211,6 +215,7 @@ private:
   SaveContentsType mSaveContentsType;
   QPixmap mPixmap;
   QPixmap mDragPixmap;
+  bool mPixmapDirty;
   QString mClassTextBefore;
   QString mClassText;
   QString mClassTextAfter;
@@ -262,6 +267,18 @@ protected:
   virtual bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
 };
 
+/*!
+ * \brief The PixmapCacheKeyData struct
+ * Holds the OMC data of a class that is part of the pixmap cache keys.
+ */
+typedef struct {
+  QByteArray mIconHash;
+  QStringList mInheritedClasses;
+  bool mHasComponents;
+  QByteArray mComponentsHash;
+  QStringList mComponentClasses;
+} PixmapCacheKeyData;
+
 class LibraryTreeModel : public QAbstractItemModel
 {
   Q_OBJECT
@@ -281,6 +298,8 @@ public:
   LibraryTreeItem* findLibraryTreeItemOneLevel(const QString &name, LibraryTreeItem *pLibraryTreeItem = 0,
                                                Qt::CaseSensitivity caseSensitivity = Qt::CaseSensitive) const;
   LibraryTreeItem* findNonExistingLibraryTreeItem(const QString &name, Qt::CaseSensitivity caseSensitivity = Qt::CaseSensitive) const;
+  void addLibraryTreeItemToIndex(LibraryTreeItem *pLibraryTreeItem);
+  void removeLibraryTreeItemFromIndex(LibraryTreeItem *pLibraryTreeItem);
   QModelIndex libraryTreeItemIndex(const LibraryTreeItem *pLibraryTreeItem) const;
   void addModelicaLibraries();
   LibraryTreeItem* createLibraryTreeItem(QString name, LibraryTreeItem *pParentLibraryTreeItem, bool isSaved = true,
@@ -303,6 +322,7 @@ public:
   void readLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem);
   LibraryTreeItem* getContainingFileParentLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem);
   void loadLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem);
+  void queueLibraryTreeItemPixmap(LibraryTreeItem *pLibraryTreeItem);
   void loadDependentLibraries(QStringList libraries);
   LibraryTreeItem* getLibraryTreeItemFromFile(QString fileName, int lineNumber);
   void showModelWidget(LibraryTreeItem *pLibraryTreeItem, bool show = true, StringHandler::ViewType viewType = StringHandler::NoView);
@@ -323,6 +343,14 @@ private:
   LibraryWidget *mpLibraryWidget;
   LibraryTreeItem *mpRootLibraryTreeItem;
   QList<LibraryTreeItem*> mNonExistingLibraryTreeItemsList;
+  QMultiHash<QString, LibraryTreeItem*> mLibraryTreeItemsHash;
+  QMultiHash<QString, LibraryTreeItem*> mLibraryTreeItemsCaseInsensitiveHash;
+  QList<LibraryTreeItem*> mPixmapLibraryTreeItemsQueue;
+  QTimer mPixmapQueueTimer;
+  bool mLoadingQueuedPixmaps;
+  int mLoadedQueuedPixmapsCount;
+  QHash<QString, PixmapCacheKeyData> mPixmapCacheKeyData;
+  QByteArray getLibraryTreeItemPixmapCacheKey(LibraryTreeItem *pLibraryTreeItem, int libraryIconSize);
   QModelIndex libraryTreeItemIndexHelper(const LibraryTreeItem *pLibraryTreeItem, const LibraryTreeItem *pParentLibraryTreeItem,
                                          const QModelIndex &parentIndex) const;
   LibraryTreeItem* getLibraryTreeItemFromFileHelper(LibraryTreeItem *pLibraryTreeItem, QString fileName, int lineNumber);
@@ -334,7 +362,8 @@ public:
   void updateOMSChildLibraryTreeItemClassText(LibraryTreeItem *pLibraryTreeItem);
 private:
   LibraryTreeItem* createLibraryTreeItemImpl(QString name, LibraryTreeItem *pParentLibraryTreeItem, bool isSaved = true,
-                                             bool isSystemLibrary = false, bool load = false, int row = -1, bool activateAccessAnnotations = false);
+                                             bool isSystemLibrary = false, bool load = false, int row = -1, bool activateAccessAnnotations = false,
+                                             const OMCInterface::getClassInformation_res *pClassInformation = 0);
   void createNonExistingLibraryTreeItem(LibraryTreeItem *pLibraryTreeItem, LibraryTreeItem *pParentLibraryTreeItem, bool isSaved = true,
                                         int row = -1);
   void createLibraryTreeItemsImpl(QFileInfo fileInfo, LibraryTreeItem *pParentLibraryTreeItem);
@@ -355,6 +384,8 @@ public:
 private:
   void deleteFileHelper(LibraryTreeItem *pLibraryTreeItem, LibraryTreeItem *pParentLibraryTreeItem);
   void deleteFileChildren(LibraryTreeItem *pLibraryTreeItem);
+private slots:
+  void loadQueuedLibraryTreeItemPixmaps();
 protected:
   Qt::DropActions supportedDropActions() const;
 };
@@ -3551,10 +3551,11 @@ void ModelWidget::getModelConnections()
   // get the connections
   MainWindow *pMainWindow = MainWindow::instance();
   LibraryTreeModel *pLibraryTreeModel = pMainWindow->getLibraryWidget()->getLibraryTreeModel();
-  int connectionCount = pMainWindow->getOMCProxy()->getConnectionCount(mpLibraryTreeItem->getNameStructure());
-  for (int i = 1 ; i <= connectionCount ; i++) {
-    // get the connection from OMC
-    QStringList connectionList = pMainWindow->getOMCProxy()->getNthConnection(mpLibraryTreeItem->getNameStructure(), i);
+  QStringList connectionAnnotationsList;
+  QList<QList<QString> > connectionsList = pMainWindow->getOMCProxy()->getConnections(mpLibraryTreeItem->getNameStructure(),
+                                                                                      &connectionAnnotationsList);
+  for (int i = 0 ; i < connectionsList.size() ; i++) {
+    QStringList connectionList = connectionsList.at(i);
     QString connectionString = QString("{%1}").arg(connectionList.join(","));
     // if the connectionString only contains two items then continue the loop,
     // because connection is not valid then
@@ -3641,8 +3642,7 @@ void ModelWidget::getModelConnections()
                                                             Helper::scriptingKind, Helper::errorLevel));
       continue;
     }
-    // get the connector annotations from OMC
-    QString connectionAnnotationString = pMainWindow->getOMCProxy()->getNthConnectionAnnotation(mpLibraryTreeItem->getNameStructure(), i);
+    QString connectionAnnotationString = connectionAnnotationsList.at(i);
     QStringList shapesList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(connectionAnnotationString), '(', ')');
     // Now parse the shapes available in list
     QString lineShape = "";
@@ -4316,8 +4316,11 @@ bool ModelWidget::omsimulatorEditorTextChanged()
       // unload the old model from OMSimulator
       OMSProxy::instance()->omsDelete(mpLibraryTreeItem->getNameStructure());
       // Update to the new name
+      LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
+      pLibraryTreeModel->removeLibraryTreeItemFromIndex(mpLibraryTreeItem);
       mpLibraryTreeItem->setName(modelName);
       mpLibraryTreeItem->setNameStructure(modelName);
+      pLibraryTreeModel->addLibraryTreeItemToIndex(mpLibraryTreeItem);
       setWindowTitle(mpLibraryTreeItem->getName() + (mpLibraryTreeItem->isSaved() ? "" : "*"));
       setModelClassPathLabel(mpLibraryTreeItem->getNameStructure());
     }
@@ -5500,12 +5503,8 @@ void ModelWidget::removeClassComponents(StringHandler::ViewType viewType)
 void ModelWidget::getModelComponents()
 {
   MainWindow *pMainWindow = MainWindow::instance();
-  // get the components
-  mComponentsList = pMainWindow->getOMCProxy()->getComponents(mpLibraryTreeItem->getNameStructure());
-  // get the components annotations
-  if (!mComponentsList.isEmpty()) {
-    mComponentsAnnotationsList = pMainWindow->getOMCProxy()->getComponentAnnotations(mpLibraryTreeItem->getNameStructure());
-  }
+  // get the components and their annotations
+  mComponentsList = pMainWindow->getOMCProxy()->getComponentsAndAnnotations(mpLibraryTreeItem->getNameStructure(), &mComponentsAnnotationsList);
 }
 
 /*!
@@ -2084,6 +2084,8 @@ void RenameItemDialog::renameItem()
       return;
     }
     if (QFile::rename(oldFileInfo.absoluteFilePath(), fileInfo.absoluteFilePath())) {
+      LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
+      pLibraryTreeModel->removeLibraryTreeItemFromIndex(mpLibraryTreeItem);
       mpLibraryTreeItem->setName(mpNameTextBox->text());
       mpLibraryTreeItem->setNameStructure(fileInfo.absoluteFilePath());
       mpLibraryTreeItem->setFileName(fileInfo.absoluteFilePath());
@@ -2095,6 +2097,7 @@ void RenameItemDialog::renameItem()
       if (fileInfo.isDir()) {
         updateChildrenPath(mpLibraryTreeItem);
       }
+      pLibraryTreeModel->addLibraryTreeItemToIndex(mpLibraryTreeItem);
     }
   } else if (mpLibraryTreeItem->getLibraryType() == LibraryTreeItem::CompositeModel) {
     if (mpLibraryTreeItem->getModelWidget()) {
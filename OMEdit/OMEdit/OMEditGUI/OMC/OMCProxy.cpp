@@ -32,6 +32,8 @@
  * @author Adeel Asghar <adeel.asghar@liu.se>
  */
 
+#define GC_THREADS
+
 extern "C" {
 #include "meta/meta_modelica.h"
 #include "omc_config.h"
@@ -61,6 +63,8 @@ void omc_Main_setWindowsPaths(threadData_t *threadData, void* _inOMHome);
 #include "omc_error.h"
 
 #include <QMessageBox>
+#include <QFutureWatcher>
+#include <QEventLoop>
 
 /*!
  * \class OMCProxy
@@ -72,7 +76,8 @@ void omc_Main_setWindowsPaths(threadData_t *threadData, void* _inOMHome);
  * \param pParent
  */
 OMCProxy::OMCProxy(threadData_t* threadData, QWidget *pParent)
-  : QObject(pParent), mHasInitialized(false), mResult(""), mTotalOMCCallsTime(0.0)
+  : QObject(pParent), mHasInitialized(false), mResult(""), mTotalOMCCallsTime(0.0), mpOMCThread(0), mpOMCCommandWorker(0),
+    mCommandPending(false)
 {
   mCurrentCommandIndex = -1;
   // OMC Commands Logger Widget
@@ -207,9 +212,21 @@ bool OMCProxy::initializeOMC(threadData_t *threadData)
   threadData->plotCB = MainWindow::PlotCallbackFunction;
   MMC_CATCH_TOP(return false;)
   mpOMCInterface = new OMCInterface(threadData);
+  // the direct OMCInterface calls share the threadData with the OMC thread so wait for the queued commands before them.
+  connect(mpOMCInterface, SIGNAL(logCommand(QString,QTime*)), this, SLOT(waitForAsyncCommands()), Qt::DirectConnection);
   connect(mpOMCInterface, SIGNAL(logCommand(QString,QTime*)), this, SLOT(logCommand(QString,QTime*)));
   connect(mpOMCInterface, SIGNAL(logResponse(QString,QString,QTime*)), this, SLOT(logResponse(QString,QString,QTime*)));
   connect(mpOMCInterface, SIGNAL(throwException(QString)), SLOT(showException(QString)));
+  // start the OMC thread for the asynchronous commands
+  GC_allow_register_threads();
+  mpOMCThread = new QThread(this);
+  mpOMCCommandWorker = new OMCCommandWorker(threadData);
+  mpOMCCommandWorker->moveToThread(mpOMCThread);
+  connect(mpOMCThread, SIGNAL(started()), mpOMCCommandWorker, SLOT(registerThread()));
+  connect(mpOMCThread, SIGNAL(finished()), mpOMCCommandWorker, SLOT(unregisterThread()), Qt::DirectConnection);
+  connect(mpOMCCommandWorker, SIGNAL(commandFinished(QString,QString,QTime)), SLOT(logAsyncResponse(QString,QString,QTime)));
+  connect(mpOMCCommandWorker, SIGNAL(connectionLost()), SLOT(exitApplication()));
+  mpOMCThread->start();
   mHasInitialized = true;
   // get OpenModelica version
   Helper::OpenModelicaVersion = getVersion();
@@ -238,6 +255,14 @@ bool OMCProxy::initializeOMC(threadData_t *threadData)
  */
 void OMCProxy::quitOMC()
 {
+  waitForAsyncCommands();
+  if (mpOMCThread) {
+    mpOMCThread->quit();
+    mpOMCThread->wait();
+    // the thread has no event loop anymore so deleteLater would never delete the worker.
+    delete mpOMCCommandWorker;
+    mpOMCCommandWorker = 0;
+  }
   sendCommand("quit()");
   if (mpCommunicationLogFile) {
     fclose(mpCommunicationLogFile);
@@ -254,6 +279,7 @@ void OMCProxy::quitOMC()
  */
 void OMCProxy::sendCommand(const QString expression, bool saveToHistory)
 {
+  waitForAsyncCommands();
   // write command to the commands log.
   QTime commandTime;
   commandTime.start();
@@ -285,6 +311,105 @@ void OMCProxy::sendCommand(const QString expression, bool saveToHistory)
   MMC_CATCH_TOP(mResult = "");
 }
 
+/*!
+ * \brief OMCProxy::sendCommandAsync
+ * Queues the command for the OMC thread and returns immediately.\n
+ * The commands are run in the order they are queued.
+ * Any synchronous command waits for the queued commands to finish since OMC can only run one command at a time.
+ * \param expression
+ * \return the future holding the command result.
+ * \sa OMCProxy::waitForCommand()
+ */
+QFuture<QString> OMCProxy::sendCommandAsync(const QString expression)
+{
+  OMCCommand command;
+  command.mExpression = expression;
+  command.mCommandTime.start();
+  command.mFutureInterface.reportStarted();
+  logCommand(expression, &command.mCommandTime);
+  QFuture<QString> future = command.mFutureInterface.future();
+  mPendingCommands.append(future);
+  mpOMCCommandWorker->enqueueCommand(command);
+  return future;
+}
+
+/*!
+ * \brief OMCProxy::waitForCommand
+ * Waits for the asynchronous command to finish while keeping the event loop running so the GUI stays responsive.\n
+ * The user input is excluded from the event loop. Code that calls OMC from timers should check OMCProxy::isCommandPending()
+ * and try again later. A synchronous command issued from the event loop blocks until the pending commands are finished
+ * and a nested asynchronous command is waited for without starting another event loop.
+ * \param future
+ * \return the command result.
+ */
+QString OMCProxy::waitForCommand(QFuture<QString> future)
+{
+  if (!future.isFinished()) {
+    if (mCommandPending) {
+      future.waitForFinished();
+    } else {
+      mCommandPending = true;
+      QFutureWatcher<QString> futureWatcher;
+      QEventLoop eventLoop;
+      connect(&futureWatcher, SIGNAL(finished()), &eventLoop, SLOT(quit()));
+      futureWatcher.setFuture(future);
+      if (!future.isFinished()) {
+        eventLoop.exec(QEventLoop::ExcludeUserInputEvents);
+      }
+      mCommandPending = false;
+    }
+  }
+  mPendingCommands.removeAll(future);
+  return future.result().trimmed();
+}
+
+/*!
+ * \brief OMCProxy::waitForAsyncCommands
+ * Blocks until all the queued asynchronous commands are finished.
+ */
+void OMCProxy::waitForAsyncCommands()
+{
+  foreach (QFuture<QString> future, mPendingCommands) {
+    future.waitForFinished();
+  }
+  mPendingCommands.clear();
+}
+
+/*!
+ * \brief OMCProxy::sendCommands
+ * Sends several commands to OMC in one round trip.\n
+ * The expressions are sent as one statement list with a separator string literal after each expression.
+ * The separator is used to split the reply since the individual results can span several lines.
+ * \param expressions
+ * \return the list of results, one for each expression.
+ */
+QStringList OMCProxy::sendCommands(const QStringList &expressions)
+{
+  QStringList results;
+  if (expressions.isEmpty()) {
+    return results;
+  }
+  const QString separator = "\"__OMEdit_sendCommands_separator__\"";
+  QStringList statements;
+  foreach (QString expression, expressions) {
+    statements << expression << separator;
+  }
+  sendCommand(statements.join("; "));
+  results = mResult.split(separator);
+  // the last item is whatever comes after the last separator.
+  if (!results.isEmpty()) {
+    results.removeLast();
+  }
+  for (int i = 0 ; i < results.size() ; i++) {
+    results[i] = results.at(i).trimmed();
+  }
+  // if the reply is broken e.g., exception in OMC then return empty results so the callers can still index them.
+  while (results.size() < expressions.size()) {
+    results.append("");
+  }
+  return results;
+}
+
 /*!
   Sets the command result.
   \param value the command result.
@@ -740,7 +865,73 @@ QStringList OMCProxy::searchClassNames(QString searchText, bool findInText)
 OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString className)
 {
   OMCInterface::getClassInformation_res classInformation = mpOMCInterface->getClassInformation(className);
-  QString comment = classInformation.comment.replace("\\\"", "\"");
+  updateClassInformationComment(&classInformation);
+  return classInformation;
+}
+
+/*!
+ * \brief OMCProxy::getClassesInformation
+ * Gets the information about several classes in one round trip.
+ * \param classNames
+ * \return the list of class information in the same order as classNames.
+ * \sa OMCProxy::getClassInformation()
+ */
+QList<OMCInterface::getClassInformation_res> OMCProxy::getClassesInformation(QStringList classNames)
+{
+  QStringList expressions;
+  foreach (QString className, classNames) {
+    expressions.append(QString("getClassInformation(%1)").arg(className));
+  }
+  QList<OMCInterface::getClassInformation_res> classesInformation;
+  foreach (QString result, sendCommands(expressions)) {
+    classesInformation.append(parseClassInformation(result));
+  }
+  return classesInformation;
+}
+
+/*!
+ * \brief OMCProxy::parseClassInformation
+ * Parses the getClassInformation result string.
+ * \param result
+ * \return
+ */
+OMCInterface::getClassInformation_res OMCProxy::parseClassInformation(QString result)
+{
+  OMCInterface::getClassInformation_res classInformation;
+  QStringList list = StringHandler::getStrings(StringHandler::removeFirstLastParentheses(result));
+  if (list.size() < 18) {
+    return classInformation;
+  }
+  classInformation.restriction = StringHandler::unparse(list.at(0));
+  classInformation.comment = StringHandler::unparse(list.at(1));
+  classInformation.partialPrefix = StringHandler::unparseBool(list.at(2));
+  classInformation.finalPrefix = StringHandler::unparseBool(list.at(3));
+  classInformation.encapsulatedPrefix = StringHandler::unparseBool(list.at(4));
+  classInformation.fileName = StringHandler::unparse(list.at(5));
+  classInformation.fileReadOnly = StringHandler::unparseBool(list.at(6));
+  classInformation.lineNumberStart = list.at(7).toInt();
+  classInformation.columnNumberStart = list.at(8).toInt();
+  classInformation.lineNumberEnd = list.at(9).toInt();
+  classInformation.columnNumberEnd = list.at(10).toInt();
+  classInformation.dimensions = StringHandler::unparseStrings(list.at(11));
+  classInformation.isProtectedClass = StringHandler::unparseBool(list.at(12));
+  classInformation.isDocumentationClass = StringHandler::unparseBool(list.at(13));
+  classInformation.version = StringHandler::unparse(list.at(14));
+  classInformation.preferredView = StringHandler::unparse(list.at(15));
+  classInformation.state = StringHandler::unparseBool(list.at(16));
+  classInformation.access = StringHandler::unparse(list.at(17));
+  updateClassInformationComment(&classInformation);
+  return classInformation;
+}
+
+/*!
+ * \brief OMCProxy::updateClassInformationComment
+ * Makes the class comment usable in tooltips.
+ * \param pClassInformation
+ */
+void OMCProxy::updateClassInformationComment(OMCInterface::getClassInformation_res *pClassInformation)
+{
+  QString comment = pClassInformation->comment.replace("\\\"", "\"");
   comment = makeDocumentationUriToFileName(comment);
   // since tooltips can't handle file:// scheme so we have to remove it in order to display images and make links work.
 #ifdef WIN32
@@ -748,8 +939,7 @@ OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString clas
 #else
   comment.replace("src=\"file://", "src=\"");
 #endif
-  classInformation.comment = comment;
-  return classInformation;
+  pClassInformation->comment = comment;
 }
 
 /*!
@@ -1140,6 +1330,34 @@ QString OMCProxy::getNthConnectionAnnotation(QString className, int num)
   return getResult();
 }
 
+/*!
+ * \brief OMCProxy::getConnections
+ * Returns all the connections of a model along with their annotations.\n
+ * Uses two round trips, one for the connection count and one for all the connections and their annotations,
+ * instead of two per connection.
+ * \param className - is the name of the model.
+ * \param pConnectionAnnotations - is filled with the connection annotations.
+ * \return the list of connections i.e, {from, to, comment}
+ * \sa OMCProxy::getNthConnection()
+ * \sa OMCProxy::getNthConnectionAnnotation()
+ */
+QList<QList<QString> > OMCProxy::getConnections(QString className, QStringList *pConnectionAnnotations)
+{
+  QList<QList<QString> > connections;
+  int connectionCount = getConnectionCount(className);
+  QStringList expressions;
+  for (int i = 1 ; i <= connectionCount ; i++) {
+    expressions.append(QString("getNthConnection(%1, %2)").arg(className).arg(i));
+    expressions.append(QString("getNthConnectionAnnotation(%1, %2)").arg(className).arg(i));
+  }
+  QStringList results = sendCommands(expressions);
+  for (int i = 0 ; i < results.size() ; i += 2) {
+    connections.append(StringHandler::unparseStrings(results.at(i)));
+    pConnectionAnnotations->append(results.at(i + 1));
+  }
+  return connections;
+}
+
 /*!
  * \brief OMCProxy::getTransitions
  * Returns the list of transitions in a class.
@@ -1231,7 +1449,18 @@ QList<ComponentInfo*> OMCProxy::getComponents(QString className)
 {
   QString expression = "getComponents(" + className + ", useQuotes = true)";
   sendCommand(expression);
-  QString result = getResult();
+  return parseComponents(getResult());
+}
+
+/*!
+ * \brief OMCProxy::parseComponents
+ * Parses the getComponents result string.\n
+ * Creates an object of ComponentInfo for each component.
+ * \param result
+ * \return the list of components
+ */
+QList<ComponentInfo*> OMCProxy::parseComponents(QString result)
+{
   QList<ComponentInfo*> componentInfoList;
   QStringList list = StringHandler::unparseArrays(result);
 
@@ -1259,6 +1488,28 @@ QStringList OMCProxy::getComponentAnnotations(QString className)
   return StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(getResult()));
 }
 
+/*!
+ * \brief OMCProxy::getComponentsAndAnnotations
+ * Returns the components of a model and their annotations in one round trip.
+ * \param className - is the name of the model.
+ * \param pComponentAnnotations - is filled with the component annotations.
+ * \return the list of components
+ * \sa OMCProxy::getComponents()
+ * \sa OMCProxy::getComponentAnnotations()
+ */
+QList<ComponentInfo*> OMCProxy::getComponentsAndAnnotations(QString className, QStringList *pComponentAnnotations)
+{
+  QStringList expressions;
+  expressions << QString("getComponents(%1, useQuotes = true)").arg(className)
+              << QString("getComponentAnnotations(%1)").arg(className);
+  QStringList results = sendCommands(expressions);
+  QList<ComponentInfo*> componentInfoList = parseComponents(results.at(0));
+  if (!componentInfoList.isEmpty()) {
+    *pComponentAnnotations = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(results.at(1)));
+  }
+  return componentInfoList;
+}
+
 QString OMCProxy::getDocumentationAnnotationInfoHeader(LibraryTreeItem *pLibraryTreeItem, QString infoHeader)
 {
   if (pLibraryTreeItem && !pLibraryTreeItem->isRootItem()) {
@@ -1404,10 +1655,10 @@ QString OMCProxy::changeDirectory(QString directory)
   */
 bool OMCProxy::loadModel(QString className, QString priorityVersion, bool notify, QString languageStandard, bool requireExactVersion)
 {
-  bool result = false;
-  QList<QString> priorityVersionList;
-  priorityVersionList << priorityVersion;
-  result = mpOMCInterface->loadModel(className, priorityVersionList, notify, languageStandard, requireExactVersion);
+  QString expression = QString("loadModel(%1, {\"%2\"}, %3, \"%4\", %5)").arg(className)
+      .arg(StringHandler::escapeString(priorityVersion)).arg(notify ? "true" : "false")
+      .arg(StringHandler::escapeString(languageStandard)).arg(requireExactVersion ? "true" : "false");
+  bool result = StringHandler::unparseBool(waitForCommand(sendCommandAsync(expression)));
   printMessagesStringInternal();
   return result;
 }
@@ -2237,7 +2488,7 @@ bool OMCProxy::ngspicetoModelica(QString fileName)
  */
 QString OMCProxy::checkAllModelsRecursive(QString className)
 {
-  QString result = mpOMCInterface->checkAllModelsRecursive(className, false);
+  QString result = StringHandler::unparse(waitForCommand(sendCommandAsync(QString("checkAllModelsRecursive(%1, false)").arg(className))));
   printMessagesStringInternal();
   MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->loadDependentLibraries(getClassNames());
   return result;
@@ -2251,7 +2502,7 @@ QString OMCProxy::checkAllModelsRecursive(QString className)
  */
 QString OMCProxy::instantiateModel(QString className)
 {
-  QString result = mpOMCInterface->instantiateModel(className);
+  QString result = StringHandler::unparse(waitForCommand(sendCommandAsync(QString("instantiateModel(%1)").arg(className))));
   printMessagesStringInternal();
   MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->loadDependentLibraries(getClassNames());
   return result;
@@ -2293,7 +2544,14 @@ OMCInterface::getSimulationOptions_res OMCProxy::getSimulationOptions(QString cl
 QString OMCProxy::buildModelFMU(QString className, QString version, QString type, QString fileNamePrefix, QList<QString> platforms, bool includeResources)
 {
   fileNamePrefix = fileNamePrefix.isEmpty() ? "<default>" : fileNamePrefix;
-  QString fmuFileName = mpOMCInterface->buildModelFMU(className, version, type, fileNamePrefix, platforms, includeResources);
+  QStringList platformsList;
+  foreach (QString platform, platforms) {
+    platformsList.append(QString("\"%1\"").arg(StringHandler::escapeString(platform)));
+  }
+  QString expression = QString("buildModelFMU(%1, \"%2\", \"%3\", \"%4\", {%5}, %6)").arg(className)
+      .arg(StringHandler::escapeString(version)).arg(StringHandler::escapeString(type))
+      .arg(StringHandler::escapeString(fileNamePrefix)).arg(platformsList.join(", ")).arg(includeResources ? "true" : "false");
+  QString fmuFileName = StringHandler::unparse(waitForCommand(sendCommandAsync(expression)));
   if (!fmuFileName.isEmpty()) {
     MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel()->loadDependentLibraries(getClassNames());
   }
@@ -3047,6 +3305,97 @@ bool OMCProxy::loadEncryptedPackage(QString fileName, QString workingDirectory)
   return result;
 }
 
+/*!
+ * \class OMCCommandWorker
+ * \brief Runs the asynchronous OMC commands in the OMC thread.
+ * The OMC thread has its own threadData. The OMC state e.g., the loaded classes lives in the local roots of the threadData,
+ * so they are copied from the GUI thread's threadData before each command and copied back after it.
+ * OMCProxy makes sure that the GUI thread never calls OMC while a queued command is running.
+ */
+/*!
+ * \brief OMCCommandWorker::OMCCommandWorker
+ * \param pParentThreadData - the threadData of the GUI thread.
+ */
+OMCCommandWorker::OMCCommandWorker(threadData_t *pParentThreadData)
+  : QObject(0), mpParentThreadData(pParentThreadData), mpThreadData(0)
+{
+}
+
+/*!
+ * \brief OMCCommandWorker::enqueueCommand
+ * Adds the command to the queue. Called from the GUI thread.
+ * \param command
+ */
+void OMCCommandWorker::enqueueCommand(OMCCommand command)
+{
+  QMutexLocker locker(&mQueueMutex);
+  mCommandsQueue.enqueue(command);
+  QMetaObject::invokeMethod(this, "processCommands", Qt::QueuedConnection);
+}
+
+/*!
+ * \brief OMCCommandWorker::registerThread
+ * Registers the OMC thread with the garbage collector and creates its threadData.
+ */
+void OMCCommandWorker::registerThread()
+{
+  struct GC_stack_base stackBase;
+  GC_get_stack_base(&stackBase);
+  GC_register_my_thread(&stackBase);
+  // uncollectable so the garbage collector scans the local roots stored in it.
+  mpThreadData = (threadData_t*)GC_malloc_uncollectable(sizeof(threadData_t));
+  memset(mpThreadData, 0, sizeof(threadData_t));
+}
+
+/*!
+ * \brief OMCCommandWorker::unregisterThread
+ * Frees the threadData of the OMC thread and unregisters the thread from the garbage collector.
+ */
+void OMCCommandWorker::unregisterThread()
+{
+  GC_free(mpThreadData);
+  mpThreadData = 0;
+  GC_unregister_my_thread();
+}
+
+/*!
+ * \brief OMCCommandWorker::processCommands
+ * Runs the queued commands one by one.
+ */
+void OMCCommandWorker::processCommands()
+{
+  forever {
+    OMCCommand command;
+    {
+      QMutexLocker locker(&mQueueMutex);
+      if (mCommandsQueue.isEmpty()) {
+        return;
+      }
+      command = mCommandsQueue.dequeue();
+    }
+    QString result = "";
+    void *reply_str = NULL;
+    threadData_t *threadData = mpThreadData;
+    memcpy(threadData->localRoots, mpParentThreadData->localRoots, sizeof(threadData->localRoots));
+    mmc_init_stackoverflow(threadData);
+
+    MMC_TRY_TOP_INTERNAL()
+
+    if (omc_Main_handleCommand(threadData, mmc_mk_scon(command.mExpression.toStdString().c_str()), &reply_str)) {
+      result = MMC_STRINGDATA(reply_str);
+    } else {
+      emit connectionLost();
+    }
+
+    MMC_CATCH_TOP(result = "");
+
+    memcpy(mpParentThreadData->localRoots, threadData->localRoots, sizeof(threadData->localRoots));
+    command.mFutureInterface.reportResult(result);
+    command.mFutureInterface.reportFinished();
+    emit commandFinished(command.mExpression, result.trimmed(), command.mCommandTime);
+  }
+}
+
 /*!
   \class CustomExpressionBox
   \brief A text box for executing OMC commands.
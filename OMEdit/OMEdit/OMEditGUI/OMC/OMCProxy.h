@@ -40,11 +40,17 @@
 #include "Util/Helper.h"
 #include "Util/Utilities.h"
 
+#include <QFuture>
+#include <QFutureInterface>
+#include <QMutex>
+#include <QQueue>
+
 class CustomExpressionBox;
 class ComponentInfo;
 class StringHandler;
 class OMCInterface;
 class LibraryTreeItem;
+class OMCCommandWorker;
 
 typedef struct {
   QString mFromUnit;
@@ -80,17 +86,28 @@ private:
   QMap<QString, QList<QString> > mDerivedUnitsMap;
   OMCInterface *mpOMCInterface;
   bool mIsLoggingEnabled;
+  QThread *mpOMCThread;
+  OMCCommandWorker *mpOMCCommandWorker;
+  QList<QFuture<QString> > mPendingCommands;
+  bool mCommandPending;
+
+  OMCInterface::getClassInformation_res parseClassInformation(QString result);
+  void updateClassInformationComment(OMCInterface::getClassInformation_res *pClassInformation);
 public:
   OMCProxy(threadData_t *threadData, QWidget *pParent = 0);
   ~OMCProxy();
+  QList<ComponentInfo*> parseComponents(QString result);
   void getPreviousCommand();
   void getNextCommand();
   bool initializeOMC(threadData_t *threadData);
   void quitOMC();
   void sendCommand(const QString expression, bool saveToHistory = false);
+  QStringList sendCommands(const QStringList &expressions);
+  QFuture<QString> sendCommandAsync(const QString expression);
+  QString waitForCommand(QFuture<QString> future);
+  bool isCommandPending() {return mCommandPending;}
   void setResult(QString value);
   QString getResult();
-  void exitApplication();
   void removeObjectRefFile();
   void setLoggingEnabled(bool enable) {mIsLoggingEnabled = enable;}
   bool isLoggingEnabled() {return mIsLoggingEnabled;}
@@ -114,6 +131,7 @@ public:
                             bool sort = false, bool builtin = false, bool showProtected = true, bool includeConstants = false);
   QStringList searchClassNames(QString searchText, bool findInText = false);
   OMCInterface::getClassInformation_res getClassInformation(QString className);
+  QList<OMCInterface::getClassInformation_res> getClassesInformation(QStringList classNames);
   bool isPackage(QString className);
   bool isBuiltinType(QString typeName);
   QString getBuiltinType(QString typeName);
@@ -138,6 +156,7 @@ public:
   int getConnectionCount(QString className);
   QList<QString> getNthConnection(QString className, int index);
   QString getNthConnectionAnnotation(QString className, int num);
+  QList<QList<QString> > getConnections(QString className, QStringList *pConnectionAnnotations);
   QList<QList<QString> > getTransitions(QString className);
   QList<QList<QString> > getInitialStates(QString className);
   int getInheritanceCount(QString className);
@@ -145,6 +164,7 @@ public:
   QList<QString> getInheritedClasses(QString className);
   QList<ComponentInfo*> getComponents(QString className);
   QStringList getComponentAnnotations(QString className);
+  QList<ComponentInfo*> getComponentsAndAnnotations(QString className, QStringList *pComponentAnnotations);
   QString getDocumentationAnnotationInfoHeader(LibraryTreeItem *pLibraryTreeItem, QString infoHeader);
   QString getDocumentationAnnotation(LibraryTreeItem *pLibraryTreeItem);
   QList<QString> getDocumentationAnnotationInClass(LibraryTreeItem *pLibraryTreeItem);
@@ -265,10 +285,43 @@ public slots:
   void logCommand(QString command, QTime *commandTime) { logCommand(command, commandTime, false); }
   void logCommand(QString command, QTime *commandTime, bool saveToHistory);
   void logResponse(QString command, QString response, QTime *responseTime);
+  void logAsyncResponse(QString command, QString response, QTime responseTime) {logResponse(command, response, &responseTime);}
+  void waitForAsyncCommands();
   void showException(QString exception);
   void openOMCLoggerWidget();
   void sendCustomExpression();
   void openOMCDiffWidget();
+  void exitApplication();
+};
+
+typedef struct {
+  QString mExpression;
+  QTime mCommandTime;
+  QFutureInterface<QString> mFutureInterface;
+} OMCCommand;
+
+/*!
+ * \brief The OMCCommandWorker class
+ * Runs the queued OMC commands in the OMC thread.
+ */
+class OMCCommandWorker : public QObject
+{
+  Q_OBJECT
+public:
+  OMCCommandWorker(threadData_t *pParentThreadData);
+  void enqueueCommand(OMCCommand command);
+private:
+  threadData_t *mpParentThreadData;
+  threadData_t *mpThreadData;
+  QMutex mQueueMutex;
+  QQueue<OMCCommand> mCommandsQueue;
+public slots:
+  void registerThread();
+  void unregisterThread();
+  void processCommands();
+signals:
+  void commandFinished(QString command, QString response, QTime responseTime);
+  void connectionLost();
 };
 
 class CustomExpressionBox : public QLineEdit
@@ -122,12 +122,14 @@ SOURCES += main.cpp \
   Util/Helper.cpp \
   Util/Utilities.cpp \
   Util/StringHandler.cpp \
+  Util/ResultColumns.cpp \
   MainWindow.cpp \
   $$OPENMODELICAHOME/include/omc/scripting-API/OpenModelicaScriptingAPIQt.cpp \
   OMC/OMCProxy.cpp \
   Modeling/MessagesWidget.cpp \
   Modeling/ItemDelegate.cpp \
   Modeling/LibraryTreeWidget.cpp \
+  Modeling/LibraryCache.cpp \
   Modeling/Commands.cpp \
   Modeling/CoOrdinateSystem.cpp \
   Modeling/ModelWidgetContainer.cpp \
@@ -177,6 +179,7 @@ SOURCES += main.cpp \
   TransformationalDebugger/OMDumpXML.cpp \
   TransformationalDebugger/diff_match_patch.cpp \
   TransformationalDebugger/TransformationsWidget.cpp \
+  TransformationalDebugger/ProfilingWidget.cpp \
   Debugger/GDB/CommandFactory.cpp \
   Debugger/GDB/GDBAdapter.cpp \
   Debugger/StackFrames/StackFramesWidget.cpp \
@@ -211,12 +214,14 @@ SOURCES += main.cpp \
 HEADERS  += Util/Helper.h \
   Util/Utilities.h \
   Util/StringHandler.h \
+  Util/ResultColumns.h \
   MainWindow.h \
   $$OPENMODELICAHOME/include/omc/scripting-API/OpenModelicaScriptingAPIQt.h \
   OMC/OMCProxy.h \
   Modeling/MessagesWidget.h \
   Modeling/ItemDelegate.h \
   Modeling/LibraryTreeWidget.h \
+  Modeling/LibraryCache.h \
   Modeling/Commands.h \
   Modeling/CoOrdinateSystem.h \
   Modeling/ModelWidgetContainer.h \
@@ -268,6 +273,7 @@ HEADERS  += Util/Helper.h \
   TransformationalDebugger/OMDumpXML.cpp \
   TransformationalDebugger/diff_match_patch.h \
   TransformationalDebugger/TransformationsWidget.h \
+  TransformationalDebugger/ProfilingWidget.h \
   Debugger/GDB/CommandFactory.h \
   Debugger/GDB/GDBAdapter.h \
   Debugger/StackFrames/StackFramesWidget.h \
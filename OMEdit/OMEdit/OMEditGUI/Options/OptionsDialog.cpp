@@ -611,6 +611,9 @@ void OptionsDialog::readSimulationSettings()
   if (mpSettings->contains("simulation/deleteIntermediateCompilationFiles")) {
     mpSimulationPage->getDeleteIntermediateCompilationFilesCheckBox()->setChecked(mpSettings->value("simulation/deleteIntermediateCompilationFiles").toBool());
   }
+  if (mpSettings->contains("simulation/reuseCompiledObjectFiles")) {
+    mpSimulationPage->getReuseCompiledObjectFilesCheckBox()->setChecked(mpSettings->value("simulation/reuseCompiledObjectFiles").toBool());
+  }
   if (mpSettings->contains("simulation/deleteEntireSimulationDirectory")) {
     mpSimulationPage->getDeleteEntireSimulationDirectoryCheckBox()->setChecked(mpSettings->value("simulation/deleteEntireSimulationDirectory").toBool());
   }
@@ -1225,6 +1228,7 @@ void OptionsDialog::saveSimulationSettings()
   mpSettings->setValue("simulation/switchToPlottingPerspectiveAfterSimulation", mpSimulationPage->getSwitchToPlottingPerspectiveCheckBox()->isChecked());
   mpSettings->setValue("simulation/closeSimulationOutputWidgetsBeforeSimulation", mpSimulationPage->getCloseSimulationOutputWidgetsBeforeSimulationCheckBox()->isChecked());
   mpSettings->setValue("simulation/deleteIntermediateCompilationFiles", mpSimulationPage->getDeleteIntermediateCompilationFilesCheckBox()->isChecked());
+  mpSettings->setValue("simulation/reuseCompiledObjectFiles", mpSimulationPage->getReuseCompiledObjectFilesCheckBox()->isChecked());
   mpSettings->setValue("simulation/deleteEntireSimulationDirectory", mpSimulationPage->getDeleteEntireSimulationDirectoryCheckBox()->isChecked());
   mpSettings->setValue("simulation/outputMode", mpSimulationPage->getOutputMode());
 }
@@ -3611,6 +3615,12 @@ SimulationPage::SimulationPage(OptionsDialog *pOptionsDialog)
   /* Delete intermediate compilation files checkbox */
   mpDeleteIntermediateCompilationFilesCheckBox = new QCheckBox(tr("Delete intermediate compilation files"));
   mpDeleteIntermediateCompilationFilesCheckBox->setChecked(true);
+  /* Reuse compiled object files checkbox */
+  mpReuseCompiledObjectFilesCheckBox = new QCheckBox(tr("Reuse the object files of unchanged generated C files"));
+  mpReuseCompiledObjectFilesCheckBox->setToolTip(tr("Keeps the compiled object files in a cache in the simulation directory of the model.\n"
+                                                    "Only the generated C files that changed since the last compilation are compiled again.\n"
+                                                    "Not used for models that include external C code."));
+  mpReuseCompiledObjectFilesCheckBox->setChecked(false);
   /* Delete entire simulation directory checkbox */
   mpDeleteEntireSimulationDirectoryCheckBox = new QCheckBox(tr("Delete entire simulation directory of the model when OMEdit is closed"));
   // simulation output format
@@ -3651,6 +3661,7 @@ SimulationPage::SimulationPage(OptionsDialog *pOptionsDialog)
   pSimulationLayout->addWidget(mpSwitchToPlottingPerspectiveCheckBox, row++, 0, 1, 2);
   pSimulationLayout->addWidget(mpCloseSimulationOutputWidgetsBeforeSimulationCheckBox, row++, 0, 1, 2);
   pSimulationLayout->addWidget(mpDeleteIntermediateCompilationFilesCheckBox, row++, 0, 1, 2);
+  pSimulationLayout->addWidget(mpReuseCompiledObjectFilesCheckBox, row++, 0, 1, 2);
   pSimulationLayout->addWidget(mpDeleteEntireSimulationDirectoryCheckBox, row++, 0, 1, 2);
   pSimulationLayout->addWidget(mpOutputGroupBox, row++, 0, 1, 2);
   mpSimulationGroupBox->setLayout(pSimulationLayout);
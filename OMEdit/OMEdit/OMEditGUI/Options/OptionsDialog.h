@@ -612,6 +612,7 @@ public:
   QCheckBox* getSwitchToPlottingPerspectiveCheckBox() {return mpSwitchToPlottingPerspectiveCheckBox;}
   QCheckBox* getCloseSimulationOutputWidgetsBeforeSimulationCheckBox() {return mpCloseSimulationOutputWidgetsBeforeSimulationCheckBox;}
   QCheckBox* getDeleteIntermediateCompilationFilesCheckBox() {return mpDeleteIntermediateCompilationFilesCheckBox;}
+  QCheckBox* getReuseCompiledObjectFilesCheckBox() {return mpReuseCompiledObjectFilesCheckBox;}
   QCheckBox* getDeleteEntireSimulationDirectoryCheckBox() {return mpDeleteEntireSimulationDirectoryCheckBox;}
   void setOutputMode(QString value);
   QString getOutputMode();
@@ -634,6 +635,7 @@ private:
   QCheckBox *mpSwitchToPlottingPerspectiveCheckBox;
   QCheckBox *mpCloseSimulationOutputWidgetsBeforeSimulationCheckBox;
   QCheckBox *mpDeleteIntermediateCompilationFilesCheckBox;
+  QCheckBox *mpReuseCompiledObjectFilesCheckBox;
   QCheckBox *mpDeleteEntireSimulationDirectoryCheckBox;
   QGroupBox *mpOutputGroupBox;
   QRadioButton *mpStructuredRadioButton;
@@ -68,6 +68,9 @@ void DiagramWindow::drawDiagram()
 
   ModelWidget *pModelWidget = MainWindow::instance()->getModelWidgetContainer()->getCurrentModelWidget();
   if (pModelWidget && pModelWidget->getDiagramGraphicsView()) {
+    mStatesPlan.clear();
+    mStateComponents.clear();
+    mStateTransitions.clear();
     if (mpGraphicsView) {
       delete mpGraphicsScene;
       mpGraphicsScene = 0;
@@ -82,7 +85,10 @@ void DiagramWindow::drawDiagram()
     foreach (Component *pReferenceComponent, pModelWidget->getDiagramGraphicsView()->getComponentsList()) {
       Component *pComponent = new Component(pReferenceComponent, mpGraphicsView);
       mpGraphicsView->addComponentToList(pComponent);
-      connect(MainWindow::instance()->getVariablesWidget(), SIGNAL(updateDynamicSelect(double)), pComponent, SLOT(updateDynamicSelect(double)));
+      if (pComponent->getLibraryTreeItem() && pComponent->getLibraryTreeItem()->isState()) {
+        mStatesPlan.addVariable(pComponent->getName() + ".active");
+        mStateComponents.append(pComponent);
+      }
     }
     foreach (LineAnnotation *pConnectionLineAnnotation, pModelWidget->getDiagramGraphicsView()->getConnectionsList()) {
       LineAnnotation *pNewConntionLineAnnotation = new LineAnnotation(pConnectionLineAnnotation, mpGraphicsView);
@@ -99,5 +105,37 @@ void DiagramWindow::drawDiagram()
       pNewTransitionLineAnnotation->setCornerItemsActiveOrPassive();
       mpGraphicsView->addTransitionToList(pNewTransitionLineAnnotation);
     }
+    // collect the transitions entering each state once instead of searching them on every time step.
+    mStateTransitions.resize(mStateComponents.size());
+    foreach (LineAnnotation *pTransitionLineAnnotation, mpGraphicsView->getTransitionsList()) {
+      for (int i = 0 ; i < mStateComponents.size() ; i++) {
+        if (pTransitionLineAnnotation->getEndComponent()->getName().compare(mStateComponents.at(i)->getName()) == 0) {
+          mStateTransitions[i].append(pTransitionLineAnnotation);
+        }
+      }
+    }
+    connect(MainWindow::instance()->getVariablesWidget(), SIGNAL(updateDynamicSelect(double)), SLOT(updateDynamicSelect(double)),
+            Qt::UniqueConnection);
+  }
+}
+
+/*!
+ * \brief DiagramWindow::updateDynamicSelect
+ * Slot activated when updateDynamicSelect SIGNAL is raised by VariablesWidget during the visualization of result file.\n
+ * Reads the activity of all the states in one go and updates the states and their entering transitions.
+ * \param time
+ */
+void DiagramWindow::updateDynamicSelect(double time)
+{
+  if (mStateComponents.isEmpty()) {
+    return;
+  }
+  MainWindow::instance()->getVariablesWidget()->readResultVariables(&mStatesPlan, time);
+  for (int i = 0 ; i < mStateComponents.size() ; i++) {
+    double value = mStatesPlan.getValue(i);
+    mStateComponents.at(i)->setActiveState(value);
+    foreach (LineAnnotation *pTransitionLineAnnotation, mStateTransitions.at(i)) {
+      pTransitionLineAnnotation->setActiveState(value);
+    }
   }
 }
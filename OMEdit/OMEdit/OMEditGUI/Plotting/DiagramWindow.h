@@ -38,8 +38,12 @@
 #include <QGraphicsView>
 #include <QVBoxLayout>
 
+#include "Util/ResultColumns.h"
+
 class GraphicsScene;
 class GraphicsView;
+class Component;
+class LineAnnotation;
 class DiagramWindow : public QWidget
 {
   Q_OBJECT
@@ -51,9 +55,13 @@ private:
   GraphicsScene *mpGraphicsScene;
   GraphicsView *mpGraphicsView;
   QVBoxLayout *mpMainLayout;
+  ResultVariablesPlan mStatesPlan;
+  QVector<Component*> mStateComponents;
+  QVector<QList<LineAnnotation*> > mStateTransitions;
 signals:
 
 public slots:
+  void updateDynamicSelect(double time);
 };
 
 #endif // DIAGRAMWINDOW_H
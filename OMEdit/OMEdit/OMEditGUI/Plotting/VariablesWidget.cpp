@@ -324,6 +324,7 @@ VariablesTreeModel::VariablesTreeModel(VariablesTreeView *pVariablesTreeView)
   headers << "" << "" << Helper::variables << Helper::variables << tr("Value") << tr("Unit") << tr("Display Unit") <<
              QStringList() << Helper::description << "" << false;
   mpRootVariablesTreeItem = new VariablesTreeItem(headers, 0, true);
+  mVariablesTreeItemsHash.insert(mpRootVariablesTreeItem->getVariableName(), mpRootVariablesTreeItem);
   mpActiveVariablesTreeItem = 0;
 }
 
@@ -453,16 +454,59 @@ Qt::ItemFlags VariablesTreeModel::flags(const QModelIndex &index) const
   return flags;
 }
 
+/*!
+ * \brief isArrayIndex
+ * Returns true if the variable part is an array index like [1].
+ * \param variable
+ * \return
+ */
+static bool isArrayIndex(const QString &variable)
+{
+  if (variable.size() < 3 || !variable.startsWith('[') || !variable.endsWith(']')) {
+    return false;
+  }
+  for (int i = 1; i < variable.size() - 1; i++) {
+    if (!variable.at(i).isDigit()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief VariablesTreeModel::findVariablesTreeItem
+ * Finds the VariablesTreeItem with the name inside root.\n
+ * Uses the name index instead of walking the tree.
+ * \param name
+ * \param root
+ * \return
+ */
 VariablesTreeItem* VariablesTreeModel::findVariablesTreeItem(const QString &name, VariablesTreeItem *root) const
 {
-  if (root->getVariableName() == name)
-    return root;
-  for (int i = root->getChildren().size(); --i >= 0; )
-    if (VariablesTreeItem *item = findVariablesTreeItem(name, root->getChildren().at(i)))
-      return item;
+  QMultiHash<QString, VariablesTreeItem*>::const_iterator iterator = mVariablesTreeItemsHash.constFind(name);
+  for (; iterator != mVariablesTreeItemsHash.constEnd() && iterator.key() == name; ++iterator) {
+    for (VariablesTreeItem *pVariablesTreeItem = iterator.value(); pVariablesTreeItem; pVariablesTreeItem = pVariablesTreeItem->parent()) {
+      if (pVariablesTreeItem == root) {
+        return iterator.value();
+      }
+    }
+  }
   return 0;
 }
 
+/*!
+ * \brief VariablesTreeModel::removeVariablesTreeItemsFromHash
+ * Removes the VariablesTreeItem and all its children from the name index.
+ * \param pVariablesTreeItem
+ */
+void VariablesTreeModel::removeVariablesTreeItemsFromHash(VariablesTreeItem *pVariablesTreeItem)
+{
+  mVariablesTreeItemsHash.remove(pVariablesTreeItem->getVariableName(), pVariablesTreeItem);
+  foreach (VariablesTreeItem *pChildVariablesTreeItem, pVariablesTreeItem->getChildren()) {
+    removeVariablesTreeItemsFromHash(pChildVariablesTreeItem);
+  }
+}
+
 QModelIndex VariablesTreeModel::variablesTreeItemIndex(const VariablesTreeItem *pVariablesTreeItem) const
 {
   return variablesTreeItemIndexHelper(pVariablesTreeItem, mpRootVariablesTreeItem, QModelIndex());
@@ -566,6 +610,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
   int row = rowCount();
   beginInsertRows(index, row, row);
   mpRootVariablesTreeItem->insertChild(row, pTopVariablesTreeItem);
+  mVariablesTreeItemsHash.insert(pTopVariablesTreeItem->getVariableName(), pTopVariablesTreeItem);
   endInsertRows();
   // set the newly inserted VariablesTreeItem active
   mpActiveVariablesTreeItem = pTopVariablesTreeItem;
@@ -592,15 +637,18 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
     }
   }
   /* open the .mat file */
-  ModelicaMatReader matReader;
-  matReader.file = 0;
-  const char *msg[] = {""};
+  QSharedPointer<OMPlot::ResultFile> pResultFile;
+  ModelicaMatReader *pMatReader = 0;
   if (fileName.endsWith(".mat")) {
     //Read in mat file
-    if (0 != (msg[0] = omc_new_matlab4_reader(QString(filePath + "/" + fileName).toStdString().c_str(), &matReader))) {
+    QString errorString;
+    pResultFile = OMPlot::ResultFile::open(QString(filePath + "/" + fileName), &errorString);
+    if (!pResultFile) {
       MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
                                                             GUIMessages::getMessage(GUIMessages::ERROR_OPENING_FILE).arg(fileName)
-                                                            .arg(QString(msg[0])), Helper::scriptingKind, Helper::errorLevel));
+                                                            .arg(errorString), Helper::scriptingKind, Helper::errorLevel));
+    } else {
+      pMatReader = pResultFile->getMatReader();
     }
   }
 
@@ -620,6 +668,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
     } else {
       variables = StringHandler::makeVariablePartsWithInd(plotVariable);
     }
+    const bool lastIsArrayIndex = !variables.isEmpty() && isArrayIndex(variables.last());
     int count = 1;
     VariablesTreeItem *pParentVariablesTreeItem = 0;
     foreach (QString variable, variables) {
@@ -628,8 +677,8 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       }
       QString findVariable;
       /* if last item of non-array or second to last of array*/
-      if (((variables.size() == count && !QRegExp("\\[\\d+\\]").exactMatch(variable)) ||
-              (variables.size() == count+1 && QRegExp("\\[\\d+\\]").exactMatch(variables.last())))
+      if (((variables.size() == count && !isArrayIndex(variable)) ||
+              (variables.size() == count+1 && lastIsArrayIndex))
               && plotVariable.startsWith("der(")) {
         if (parentVariable.isEmpty()) {
           findVariable = QString("%1.%2").arg(fileName , StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "der("));
@@ -652,7 +701,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       if ((pParentVariablesTreeItem = findVariablesTreeItem(findVariable, pParentVariablesTreeItem)) != NULL) {
         QString addVar;
         //if second to last of array, add der(
-        if ((variables.size() == count+1 && QRegExp("\\[\\d+\\]").exactMatch(variables.last())) && plotVariable.startsWith("der("))
+        if ((variables.size() == count+1 && lastIsArrayIndex) && plotVariable.startsWith("der("))
           addVar = StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "der(");
         else
           addVar = variable;
@@ -675,34 +724,36 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       QModelIndex index = variablesTreeItemIndex(pParentVariablesTreeItem);
       QVector<QVariant> variableData;
       /*if last but one of array derivative*/
-      if (variables.size() == count+1 && QRegExp("\\[\\d+\\]").exactMatch(variables.last()) && plotVariable.startsWith("der(")) {
+      if (variables.size() == count+1 && lastIsArrayIndex && plotVariable.startsWith("der(")) {
         variableData << filePath << fileName << pParentVariablesTreeItem->getVariableName() + "." + StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "der(") << StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "der(");
       }
       /* if last item of non-array derivative*/
-      else if (variables.size() == count && !QRegExp("\\[\\d+\\]").exactMatch(variable) && plotVariable.startsWith("der(")) {
+      else if (variables.size() == count && !isArrayIndex(variable) && plotVariable.startsWith("der(")) {
         variableData << filePath << fileName << fileName + "." + plotVariable << StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "der(");
       }
       /*if last but one of array previous*/
-      else if (variables.size() == count+1 && QRegExp("\\[\\d+\\]").exactMatch(variables.last()) && plotVariable.startsWith("previous(")) {
+      else if (variables.size() == count+1 && lastIsArrayIndex && plotVariable.startsWith("previous(")) {
         variableData << filePath << fileName << pParentVariablesTreeItem->getVariableName() + "." + StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "previous(") << StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "previous(");
       }
       /* if last item of non-array previous*/
-      else if (variables.size() == count && !QRegExp("\\[\\d+\\]").exactMatch(variable) && plotVariable.startsWith("previous(")) {
+      else if (variables.size() == count && !isArrayIndex(variable) && plotVariable.startsWith("previous(")) {
         variableData << filePath << fileName << fileName + "." + plotVariable << StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "previous(");
       }
       /* if last item of array derivative*/
-      else if (variables.size() == count && QRegExp("\\[\\d+\\]").exactMatch(variable)) {
+      else if (variables.size() == count && isArrayIndex(variable)) {
         variableData << filePath << fileName << fileName + "." + plotVariable << variable;
       } else {
         variableData << filePath << fileName << pParentVariablesTreeItem->getVariableName() + "." + variable << variable;
       }
       /* find the variable in the xml file */
       QString variableToFind = variableData[2].toString();
-      variableToFind.remove(QRegExp(pTopVariablesTreeItem->getVariableName() + "."));
+      if (variableToFind.startsWith(pTopVariablesTreeItem->getVariableName() + ".")) {
+        variableToFind.remove(0, pTopVariablesTreeItem->getVariableName().length() + 1);
+      }
       /* get the variable information i.e value, unit, displayunit, description */
       QString value, variability, unit, displayUnit, description;
       bool changeAble = false;
-      getVariableInformation(&matReader, variableToFind, &value, &changeAble, &variability, &unit, &displayUnit, &description);
+      getVariableInformation(pMatReader, variableToFind, &value, &changeAble, &variability, &unit, &displayUnit, &description);
       variableData << StringHandler::unparse(QString("\"").append(value).append("\""));
       /* set the variable unit */
       variableData << StringHandler::unparse(QString("\"").append(unit).append("\""));
@@ -741,7 +792,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
         variableData << tr("File: %1/%2\nVariable: %3\nVariability: %4").arg(filePath).arg(fileName).arg(variableToFind).arg(variability);
       }
       /*is main array*/
-      if (variables.size() == count+1 && QRegExp("\\[\\d+\\]").exactMatch(variables.last())) {
+      if (variables.size() == count+1 && lastIsArrayIndex) {
         variableData << true;
       } else {
         variableData << false;
@@ -752,10 +803,11 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       int row = rowCount(index);
       beginInsertRows(index, row, row);
       pParentVariablesTreeItem->insertChild(row, pVariablesTreeItem);
+      mVariablesTreeItemsHash.insert(pVariablesTreeItem->getVariableName(), pVariablesTreeItem);
       endInsertRows();
       QString addVar;
       //if second to last of array, add der(
-      if ((variables.size() == count+1 && QRegExp("\\[\\d+\\]").exactMatch(variables.last())) && plotVariable.startsWith("der("))
+      if ((variables.size() == count+1 && lastIsArrayIndex) && plotVariable.startsWith("der("))
         addVar = StringHandler::joinDerivativeAndPreviousVariable(plotVariable, variable, "der(");
       else
         addVar = variable;
@@ -767,12 +819,6 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       count++;
     }
   }
-  /* close the .mat file */
-  if (fileName.endsWith(".mat")) {
-    if (matReader.file) {
-      omc_free_matlab4_reader(&matReader);
-    }
-  }
   mpVariablesTreeView->collapseAll();
   QModelIndex idx = variablesTreeItemIndex(pTopVariablesTreeItem);
   idx = mpVariablesTreeView->getVariablesWidget()->getVariableTreeProxyModel()->mapFromSource(idx);
@@ -797,6 +843,7 @@ bool VariablesTreeModel::removeVariableTreeItem(QString variable)
   VariablesTreeItem *pVariablesTreeItem = findVariablesTreeItem(variable, mpRootVariablesTreeItem);
   if (pVariablesTreeItem) {
     beginRemoveRows(variablesTreeItemIndex(pVariablesTreeItem), 0, pVariablesTreeItem->getChildren().size());
+    removeVariablesTreeItemsFromHash(pVariablesTreeItem);
     pVariablesTreeItem->removeChildren();
     VariablesTreeItem *pParentVariablesTreeItem = pVariablesTreeItem->parent();
     pParentVariablesTreeItem->removeChild(pVariablesTreeItem);
@@ -872,7 +919,7 @@ void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, Q
     if (*changeAble) {
       *value = hash["start"];
     } else { /* if the variable is not a tunable parameter then read the final value of the variable. Only mat result files are supported. */
-      if ((pMatReader->file != NULL) && strcmp(pMatReader->fileName, "")) {
+      if (pMatReader && (pMatReader->file != NULL) && strcmp(pMatReader->fileName, "")) {
         *value = "";
         ModelicaMatVariable_t *var;
         if (0 == (var = omc_matlab4_find_var(pMatReader, variableToFind.toStdString().c_str()))) {
@@ -1139,8 +1186,9 @@ VariablesWidget::VariablesWidget(QWidget *pParent)
   mpVariablesTreeView->setColumnWidth(3, 70);
   mpVariablesTreeView->setColumnHidden(2, true); // hide Unit column
   mpLastActiveSubWindow = 0;
-  mModelicaMatReader.file = 0;
+  mpModelicaMatReader = 0;
   mpCSVData = 0;
+  mResultFileId = 0;
   // create the layout
   QGridLayout *pMainLayout = new QGridLayout;
   pMainLayout->setContentsMargins(0, 0, 0, 0);
@@ -1517,24 +1565,23 @@ void VariablesWidget::initializeVisualization(SimulationOptions simulationOption
 double VariablesWidget::readVariableValue(QString variable, double time)
 {
   double value = 0.0;
-  if (mModelicaMatReader.file) {
-    ModelicaMatVariable_t* var = omc_matlab4_find_var(&mModelicaMatReader, variable.toStdString().c_str());
+  if (mpModelicaMatReader) {
+    ModelicaMatVariable_t* var = omc_matlab4_find_var(mpModelicaMatReader, variable.toStdString().c_str());
     if (var) {
-      omc_matlab4_val(&value, &mModelicaMatReader, var, time);
-    }
-  } else if (mpCSVData) {
-    double *timeDataSet = read_csv_dataset(mpCSVData, "time");
-    if (timeDataSet) {
-      for (int i = 0 ; i < mpCSVData->numsteps ; i++) {
-        if (QString::number(timeDataSet[i]).compare(QString::number(time)) == 0) {
-          double *varDataSet = read_csv_dataset(mpCSVData, variable.toStdString().c_str());
-          if (varDataSet) {
-            value = varDataSet[i];
-            break;
-          }
-        }
+      double *pValues = var->isParam ? 0 : omc_matlab4_read_vals(mpModelicaMatReader, var->index);
+      const ResultTimeBracket &timeBracket = getResultTimeBracket(time);
+      if (pValues && timeBracket.isValid()) {
+        value = timeBracket.interpolate(pValues);
+      } else {
+        omc_matlab4_val(&value, mpModelicaMatReader, var, time);
       }
     }
+  } else if (mCSVResultColumns.isValid()) {
+    const double *pValues = mCSVResultColumns.getColumn(variable);
+    const ResultTimeBracket &timeBracket = getResultTimeBracket(time);
+    if (pValues && timeBracket.isValid()) {
+      value = timeBracket.interpolate(pValues);
+    }
   } else if (mPlotFileReader.isOpen()) {
     QTextStream textStream(&mPlotFileReader);
     QString currentLine;
@@ -1559,6 +1606,28 @@ double VariablesWidget::readVariableValue(QString variable, double time)
   return value;
 }
 
+/*!
+ * \brief VariablesWidget::readResultVariables
+ * Reads all the variables of the plan at specific time.\n
+ * The plan is resolved against the columns of the result file the first time it is read after opening the result file.
+ * \param pResultVariablesPlan
+ * \param time
+ */
+void VariablesWidget::readResultVariables(ResultVariablesPlan *pResultVariablesPlan, double time)
+{
+  if (mpModelicaMatReader || mCSVResultColumns.isValid()) {
+    if (!pResultVariablesPlan->isResolvedFor(mResultFileId)) {
+      pResultVariablesPlan->resolve(mResultFileId, mpModelicaMatReader, &mCSVResultColumns);
+    }
+    pResultVariablesPlan->evaluate(getResultTimeBracket(time));
+  } else {
+    // plt result files have no columns to resolve
+    for (int i = 0 ; i < pResultVariablesPlan->size() ; i++) {
+      pResultVariablesPlan->setValue(i, readVariableValue(pResultVariablesPlan->getName(i), time));
+    }
+  }
+}
+
 void VariablesWidget::plotVariables(const QModelIndex &index, qreal curveThickness, int curveStyle, PlotCurve *pPlotCurve,
                                     PlotWindow *pPlotWindow)
 {
@@ -2062,19 +2131,40 @@ void VariablesWidget::selectInteractivePlotWindow(VariablesTreeItem *pVariablesT
  */
 void VariablesWidget::closeResultFile()
 {
-  if (mModelicaMatReader.file) {
-    omc_free_matlab4_reader(&mModelicaMatReader);
-    mModelicaMatReader.file = 0;
-  }
+  // the readers are freed with the last reference to the shared result file
+  mpModelicaMatReader = 0;
   if (mpCSVData) {
-    omc_free_csv_reader(mpCSVData);
+    mCSVResultColumns.setCSVData(0);
     mpCSVData = 0;
   }
+  mpResultFile.clear();
+  mResultTimeBracket = ResultTimeBracket();
+  mResultFileId++;
   if (mPlotFileReader.isOpen()) {
     mPlotFileReader.close();
   }
 }
 
+/*!
+ * \brief VariablesWidget::getResultTimeBracket
+ * Returns the result file rows around the time point.\n
+ * The bracket is reused as long as the time doesn't change so all the variables read for a frame share one time search.
+ * \param time
+ * \return
+ */
+const ResultTimeBracket& VariablesWidget::getResultTimeBracket(double time)
+{
+  if (!mResultTimeBracket.isValid() || mResultTimeBracket.getTime() != time) {
+    if (mpModelicaMatReader) {
+      double *pTimeValues = omc_matlab4_read_vals(mpModelicaMatReader, 1);
+      mResultTimeBracket = ResultTimeBracket(pTimeValues, pTimeValues ? mpModelicaMatReader->nrows : 0, time);
+    } else {
+      mResultTimeBracket = mCSVResultColumns.getTimeBracket(time);
+    }
+  }
+  return mResultTimeBracket;
+}
+
 /*!
  * \brief VariablesWidget::openResultFile
  * Opens the result file.
@@ -2088,15 +2178,19 @@ void VariablesWidget::openResultFile()
     bool errorOpeningFile = false;
     QString errorString = "";
     if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".mat")) {
-      const char *msg[] = {""};
-      if (0 != (msg[0] = omc_new_matlab4_reader(fileName.toStdString().c_str(), &mModelicaMatReader))) {
+      mpResultFile = OMPlot::ResultFile::open(fileName, &errorString);
+      if (!mpResultFile) {
         errorOpeningFile = true;
-        errorString = msg[0];
+      } else {
+        mpModelicaMatReader = mpResultFile->getMatReader();
       }
     } else if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".csv")) {
-      mpCSVData = read_csv(fileName.toStdString().c_str());
-      if (!mpCSVData) {
+      mpResultFile = OMPlot::ResultFile::open(fileName, &errorString);
+      if (!mpResultFile) {
         errorOpeningFile = true;
+      } else {
+        mpCSVData = mpResultFile->getCSVData();
+        mCSVResultColumns.setCSVData(mpCSVData);
       }
     } else if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".plt")) {
       mPlotFileReader.setFileName(fileName);
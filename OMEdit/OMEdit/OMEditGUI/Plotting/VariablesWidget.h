@@ -40,6 +40,7 @@
 #include "Simulation/SimulationOptions.h"
 #include "PlotWindow.h"
 #include "Animation/TimeManager.h"
+#include "Util/ResultColumns.h"
 
 class OMCProxy;
 class TreeSearchFilters;
@@ -141,6 +142,8 @@ private:
   VariablesTreeItem *mpRootVariablesTreeItem;
   VariablesTreeItem *mpActiveVariablesTreeItem;
   QHash<QString, QHash<QString,QString> > mScalarVariablesList;
+  QMultiHash<QString, VariablesTreeItem*> mVariablesTreeItemsHash;
+  void removeVariablesTreeItemsFromHash(VariablesTreeItem *pVariablesTreeItem);
   void getVariableInformation(ModelicaMatReader *pMatReader, QString variableToFind, QString *value, bool *changeAble, QString *variability,
                               QString *unit, QString *displayUnit, QString *description);
 signals:
@@ -199,6 +202,7 @@ public:
   void updateInitXmlFile(SimulationOptions simulationOptions);
   void initializeVisualization(SimulationOptions simulationOptions);
   double readVariableValue(QString variable, double time);
+  void readResultVariables(ResultVariablesPlan *pResultVariablesPlan, double time);
 private:
   TreeSearchFilters *mpTreeSearchFilters;
   Label *mpSimulationTimeLabel;
@@ -220,12 +224,17 @@ private:
   QHash<QString, QList<QString>> mSelectedInteractiveVariables;
   QString mFileName;
   QMdiSubWindow *mpLastActiveSubWindow;
-  ModelicaMatReader mModelicaMatReader;
+  QSharedPointer<OMPlot::ResultFile> mpResultFile;
+  ModelicaMatReader *mpModelicaMatReader;
   csv_data *mpCSVData;
+  CSVResultColumns mCSVResultColumns;
+  ResultTimeBracket mResultTimeBracket;
+  int mResultFileId;
   QFile mPlotFileReader;
   void selectInteractivePlotWindow(VariablesTreeItem *pVariablesTreeItem);
   void closeResultFile();
   void openResultFile();
+  const ResultTimeBracket& getResultTimeBracket(double time);
   void updateVisualization();
 public slots:
   void plotVariables(const QModelIndex &index, qreal curveThickness, int curveStyle,
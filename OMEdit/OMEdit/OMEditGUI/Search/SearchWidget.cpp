@@ -36,12 +36,23 @@
 #include "MainWindow.h"
 #include "Modeling/LibraryTreeWidget.h"
 #include "Util/Helper.h"
+#include "Util/Utilities.h"
 #include "Options/OptionsDialog.h"
 
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
 #include <QtConcurrent/QtConcurrent>
 #endif
 #include <QMenu>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QCryptographicHash>
+#include <QDataStream>
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 1, 0))
+#include <QSaveFile>
+#else
+#include <QTemporaryFile>
+#endif
+#include <QSet>
 #include <QHeaderView>
 #include <QToolBar>
 #include <QGridLayout>
@@ -55,6 +66,7 @@ SearchWidget::SearchWidget(QWidget *pParent)
   : QWidget(pParent)
 {
   qRegisterMetaType<SearchFileDetails>();
+  qRegisterMetaType<QList<SearchFileDetails> >("QList<SearchFileDetails>");
   // Labels
   Label *pSearchScopeLabel = new Label(tr("Scope:"));
   Label *pSearchForStringLabel = new Label(tr("Search for:"));
@@ -72,6 +84,11 @@ SearchWidget::SearchWidget(QWidget *pParent)
   mpSearchFilePatternComboBox->setEditable(true);
   mpSearchFilePatternComboBox->addItem("*");
   connect(mpSearchFilePatternComboBox->lineEdit(), SIGNAL(returnPressed()), SLOT(searchInFiles()));
+  // search options
+  mpRegularExpressionCheckBox = new QCheckBox(tr("Regular expression"));
+  mpUseSearchIndexCheckBox = new QCheckBox(tr("Use search index"));
+  mpUseSearchIndexCheckBox->setToolTip(tr("Skips the files that can not contain the search string using an index stored for each library."));
+  mpUseSearchIndexCheckBox->setChecked(true);
   // search button
   mpSearchButton = new QPushButton("Search");
   connect(mpSearchButton, SIGNAL(clicked()), SLOT(searchInFiles()));
@@ -127,7 +144,9 @@ SearchWidget::SearchWidget(QWidget *pParent)
   pSearchLayout->addWidget(mpSearchStringComboBox, 1, 1);
   pSearchLayout->addWidget(pSearchFilePatternLabel, 2, 0);
   pSearchLayout->addWidget(mpSearchFilePatternComboBox, 2, 1);
-  pSearchLayout->addWidget(mpSearchButton, 3, 1, Qt::AlignRight);
+  pSearchLayout->addWidget(mpRegularExpressionCheckBox, 3, 1);
+  pSearchLayout->addWidget(mpUseSearchIndexCheckBox, 4, 1);
+  pSearchLayout->addWidget(mpSearchButton, 5, 1, Qt::AlignRight);
   pSearchFirstPageWidget->setLayout(pSearchLayout);
   mpSearchStackedWidget->addWidget(pSearchFirstPageWidget);
   // search stack widget layout
@@ -193,7 +212,8 @@ void SearchWidget::searchInFiles()
   mpSearchResultWidget = new SearchResultWidget;
   mSearchResultWidgetobjects.append(mpSearchResultWidget);
   mpSearch = new Search(this);
-  connect(mpSearch, SIGNAL(setTreeWidgetItems(SearchFileDetails)), mpSearchResultWidget, SLOT(updateTreeWidgetItems(SearchFileDetails)));
+  connect(mpSearch, SIGNAL(setTreeWidgetItems(QList<SearchFileDetails>)), mpSearchResultWidget,
+          SLOT(updateTreeWidgetItems(QList<SearchFileDetails>)));
   connect(mpSearch, SIGNAL(setProgressBarRange(int)), mpSearchResultWidget, SLOT(updateProgressBarRange(int)));
   connect(mpSearch, SIGNAL(setProgressBarValue(int,int)), mpSearchResultWidget, SLOT(updateProgressBarValue(int,int)));
   connect(mpSearch, SIGNAL(setFoundFilesLabel(int)), mpSearchResultWidget, SLOT(updateFoundFilesLabel(int)));
@@ -208,6 +228,19 @@ void SearchWidget::searchInFiles()
   QString searchHistoryItem = QString("%1-%2: %3").arg(tr("Project")).arg(mpSearchScopeComboBox->currentText()).arg(mpSearchStringComboBox->currentText());
   mpSearchHistoryComboBox->addItem(searchHistoryItem);
   mpSearchHistoryComboBox->setCurrentIndex(mpSearchHistoryComboBox->findText(searchHistoryItem));
+  /* collect the search options here since the search thread must not access the widgets */
+  QStringList searchPaths;
+  LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
+  if (mpSearchScopeComboBox->currentIndex() != 0) {
+    searchPaths.append(pLibraryTreeModel->getRootLibraryTreeItem()->child(mpSearchScopeComboBox->currentIndex())->getFileName());
+  } else {
+    // start the index from 1 as 0 is dummy root item
+    for (int i = 1; i < pLibraryTreeModel->getRootLibraryTreeItem()->childrenSize(); ++i) {
+      searchPaths.append(pLibraryTreeModel->getRootLibraryTreeItem()->child(i)->getFileName());
+    }
+  }
+  mpSearch->setSearchOptions(mpSearchStringComboBox->currentText(), mpSearchFilePatternComboBox->currentText().split(','), searchPaths,
+                             mpRegularExpressionCheckBox->isChecked(), mpUseSearchIndexCheckBox->isChecked());
   /* start the search in seperate thread using QtConcurrent */
   QtConcurrent::run(mpSearch, &Search::run);
 }
@@ -343,28 +376,32 @@ void SearchResultWidget::findAndOpenTreeWidgetItems(QTreeWidgetItem *item, int c
 }
 
 /*!
- * \brief SearchWidget::updateTreeWidgetItems
- * SLOT function to fill the treewidgetitems
- * from the found search results which updates
- * each tree item with filename and subchild with line numbers and
- * found lines
+ * \brief SearchResultWidget::updateTreeWidgetItems
+ * SLOT function to fill the treewidgetitems from a batch of found search results.
+ * The items are inserted with one call so that the tree widget relayouts once per batch.
+ * \param fileDetailsList
  */
-void SearchResultWidget::updateTreeWidgetItems(SearchFileDetails fileDetails)
+void SearchResultWidget::updateTreeWidgetItems(QList<SearchFileDetails> fileDetailsList)
 {
-  QTreeWidgetItem *pTreeWidgetItem = new QTreeWidgetItem();
-  pTreeWidgetItem->setText(0, fileDetails.mFileName);
-  mpSearchTreeWidget->insertTopLevelItem(0, pTreeWidgetItem);
-  mpSearchTreeWidget->resizeColumnToContents(0);
-  QMap<int, QString> map = fileDetails.mSearchLines;
-  QMap<int, QString>::iterator m;
-  for (m = map.begin(); m != map.end(); ++m) {
-    // addTreeChild(mtreeWidgetItem,filedata[var].file,i.key(),i.value());
-    QTreeWidgetItem *pTreeItemchild = new QTreeWidgetItem();
-    pTreeItemchild->setText(0, QString("%1 %2").arg(QString::number(m.key())).arg(m.value()));
-    QMap<int, QString> mapData;
-    mapData[m.key()] = m.value();
-    pTreeItemchild->setData(0, Qt::UserRole, QVariant::fromValue(SearchFileDetails(fileDetails.mFileName, mapData)));
-    pTreeWidgetItem->addChild(pTreeItemchild);
+  QList<QTreeWidgetItem*> treeWidgetItems;
+  foreach (const SearchFileDetails &fileDetails, fileDetailsList) {
+    QTreeWidgetItem *pTreeWidgetItem = new QTreeWidgetItem();
+    pTreeWidgetItem->setText(0, fileDetails.mFileName);
+    QMap<int, QString>::const_iterator m;
+    for (m = fileDetails.mSearchLines.constBegin(); m != fileDetails.mSearchLines.constEnd(); ++m) {
+      QTreeWidgetItem *pTreeItemchild = new QTreeWidgetItem();
+      pTreeItemchild->setText(0, QString("%1 %2").arg(QString::number(m.key())).arg(m.value()));
+      QMap<int, QString> mapData;
+      mapData[m.key()] = m.value();
+      pTreeItemchild->setData(0, Qt::UserRole, QVariant::fromValue(SearchFileDetails(fileDetails.mFileName, mapData)));
+      pTreeWidgetItem->addChild(pTreeItemchild);
+    }
+    // the latest found file is shown on top
+    treeWidgetItems.prepend(pTreeWidgetItem);
+  }
+  if (!treeWidgetItems.isEmpty()) {
+    mpSearchTreeWidget->insertTopLevelItems(0, treeWidgetItems);
+    mpSearchTreeWidget->resizeColumnToContents(0);
   }
 }
 
@@ -442,6 +479,202 @@ SearchFileDetails::SearchFileDetails(QString fileName, QMap<int,QString> Linenum
   mSearchLines = Linenumbers;
 }
 
+/*!
+ * \class SearchIndex
+ * \brief Persistent trigram index of the files of one library.
+ * Each file is stored with its size, modification time and a fixed size bitmap of the hashed trigrams of its lower case contents.
+ * A file whose bitmap lacks any trigram of the search string can not contain it and is not read at all.
+ * Entries are refreshed when the size or modification time of a file changes.
+ */
+#define SEARCHINDEX_MAGIC 0x4f4d5349
+#define SEARCHINDEX_VERSION 1
+#define SEARCHINDEX_SIGNATURE_BITS 16384
+
+/*!
+ * \brief SearchIndex::SearchIndex
+ * \param path - the library file or directory.
+ */
+SearchIndex::SearchIndex(const QString &path)
+  : mModified(false)
+{
+  QString indexDirectory = QString("%1/searchindex").arg(Utilities::tempDirectory());
+  QDir().mkpath(indexDirectory);
+  QByteArray hash = QCryptographicHash::hash(QFileInfo(path).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+  mIndexFileName = QString("%1/%2.idx").arg(indexDirectory).arg(QString(hash));
+}
+
+/*!
+ * \brief SearchIndex::load
+ * Reads the index file. A missing, old or corrupt index file results in an empty index.
+ */
+void SearchIndex::load()
+{
+  mEntries.clear();
+  mModified = false;
+  QFile file(mIndexFileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  QDataStream in(&file);
+  quint32 magic, version, count;
+  in >> magic >> version >> count;
+  if (magic != SEARCHINDEX_MAGIC || version != SEARCHINDEX_VERSION) {
+    return;
+  }
+  for (quint32 i = 0 ; i < count && in.status() == QDataStream::Ok ; i++) {
+    QString fileName;
+    Entry entry;
+    in >> fileName >> entry.mSize >> entry.mLastModified >> entry.mSignature;
+    mEntries.insert(fileName, entry);
+  }
+  if (in.status() != QDataStream::Ok) {
+    mEntries.clear();
+  }
+}
+
+/*!
+ * \brief SearchIndex::save
+ * Writes the index file if any entry has changed since it was loaded.
+ * The index is written to a temporary file which is then renamed into place,
+ * so overlapping searches never leave a partially written index behind.
+ */
+void SearchIndex::save()
+{
+  if (!mModified) {
+    return;
+  }
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 1, 0))
+  QSaveFile file(mIndexFileName);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return;
+  }
+#else
+  QTemporaryFile file(mIndexFileName + ".XXXXXX");
+  if (!file.open()) {
+    return;
+  }
+#endif
+  QDataStream out(&file);
+  out << (quint32)SEARCHINDEX_MAGIC << (quint32)SEARCHINDEX_VERSION << (quint32)mEntries.size();
+  QHash<QString, Entry>::const_iterator i;
+  for (i = mEntries.constBegin() ; i != mEntries.constEnd() ; ++i) {
+    out << i.key() << i.value().mSize << i.value().mLastModified << i.value().mSignature;
+  }
+  if (out.status() != QDataStream::Ok) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 1, 0))
+    file.cancelWriting();
+#endif
+    return;
+  }
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 1, 0))
+  if (!file.commit()) {
+    return;
+  }
+#else
+  file.close();
+  QFile::remove(mIndexFileName);
+  if (!file.rename(mIndexFileName)) {
+    return;
+  }
+  file.setAutoRemove(false);
+#endif
+  mModified = false;
+}
+
+/*!
+ * \brief SearchIndex::entry
+ * \param fileName
+ * \return the entry of the file or 0 if the file is not indexed.
+ */
+const SearchIndex::Entry* SearchIndex::entry(const QString &fileName) const
+{
+  QHash<QString, Entry>::const_iterator i = mEntries.constFind(fileName);
+  return i == mEntries.constEnd() ? 0 : &i.value();
+}
+
+void SearchIndex::setEntry(const QString &fileName, const Entry &entry)
+{
+  mEntries.insert(fileName, entry);
+  mModified = true;
+}
+
+/*!
+ * \brief SearchIndex::removeMissingEntries
+ * Removes the entries of the files that are no longer part of the library.
+ * \param fileNames - the current files of the library.
+ */
+void SearchIndex::removeMissingEntries(const QStringList &fileNames)
+{
+  QSet<QString> files = fileNames.toSet();
+  QHash<QString, Entry>::iterator i = mEntries.begin();
+  while (i != mEntries.end()) {
+    if (files.contains(i.key())) {
+      ++i;
+    } else {
+      i = mEntries.erase(i);
+      mModified = true;
+    }
+  }
+}
+
+/*!
+ * \brief SearchIndex::signature
+ * Computes the trigram bitmap of the data.
+ * \param lowerData - the lower case data.
+ * \return the bitmap or an empty array if the data is shorter than a trigram.
+ */
+QByteArray SearchIndex::signature(const QByteArray &lowerData)
+{
+  if (lowerData.size() < 3) {
+    return QByteArray();
+  }
+  QByteArray bits(SEARCHINDEX_SIGNATURE_BITS / 8, '\0');
+  char *pBits = bits.data();
+  const uchar *pData = (const uchar*)lowerData.constData();
+  quint32 trigram = (pData[0] << 8) | pData[1];
+  for (int i = 2 ; i < lowerData.size() ; i++) {
+    trigram = ((trigram << 8) | pData[i]) & 0xffffff;
+    // Fibonacci hashing of the 24 bit trigram to 14 bits
+    quint32 bit = (trigram * 2654435761u) >> 18;
+    pBits[bit >> 3] |= (1 << (bit & 7));
+  }
+  return bits;
+}
+
+/*!
+ * \brief SearchIndex::mayContain
+ * \param signature - the bitmap of the file.
+ * \param querySignature - the bitmap of the search string.
+ * \return false if the file can not contain the search string.
+ */
+bool SearchIndex::mayContain(const QByteArray &signature, const QByteArray &querySignature)
+{
+  if (signature.size() != querySignature.size()) {
+    return signature.isEmpty() && querySignature.isEmpty();
+  }
+  const char *pBits = signature.constData();
+  const char *pQueryBits = querySignature.constData();
+  for (int i = 0 ; i < querySignature.size() ; i++) {
+    if ((pBits[i] & pQueryBits[i]) != pQueryBits[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \class SearchRunnable
+ * \brief Runs Search::searchFiles in a thread of the search thread pool.
+ */
+class SearchRunnable : public QRunnable
+{
+public:
+  SearchRunnable(Search *pSearch) : mpSearch(pSearch) {}
+  void run() {mpSearch->searchFiles();}
+private:
+  Search *mpSearch;
+};
+
 /*!
  * \brief Search::Search
  * class which runs the Search operation
@@ -451,74 +684,232 @@ Search::Search(QObject *parent):
   QObject(parent)
 {
   mStop = false;
+  mRegularExpression = false;
+  mUseIndex = false;
+  mFoundFiles = 0;
+}
+
+Search::~Search()
+{
+  qDeleteAll(mSearchIndexes);
+}
+
+/*!
+ * \brief Search::setSearchOptions
+ * Sets the options of the search. Must be called before run().
+ * \param searchString
+ * \param filePatterns
+ * \param searchPaths - the files or directories of the libraries to search.
+ * \param regularExpression - if true then searchString is a regular expression.
+ * \param useIndex - if true then the files are filtered through the search index of their library.
+ */
+void Search::setSearchOptions(const QString &searchString, const QStringList &filePatterns, const QStringList &searchPaths,
+                              bool regularExpression, bool useIndex)
+{
+  mSearchString = searchString;
+  mFilePatterns = filePatterns;
+  mSearchPaths = searchPaths;
+  mRegularExpression = regularExpression;
+  mUseIndex = useIndex;
 }
 
 /*!
  * \brief Search::run
  * main function which runs the Search operation
- * in a seperate thread using the QTConcurrent
+ * in a seperate thread using the QTConcurrent.
+ * The files are searched by a thread pool and the results are sent to the SearchResultWidget in batches.
  */
 void Search::run()
 {
   mStop = false;
-  SearchWidget *pSearchWidget = MainWindow::instance()->getSearchWidget();
-  LibraryTreeModel *pLibraryTreeModel = MainWindow::instance()->getLibraryWidget()->getLibraryTreeModel();
-  QStringList filelist;
-  QString searchString = pSearchWidget->getSearchStringComboBox()->currentText();
-  QStringList pattern= pSearchWidget->getSearchFilePatternComboBox()->currentText().split(',');
-  if (!searchString.isEmpty()) {
-    if (pSearchWidget->getSearchScopeComboBox()->currentIndex() != 0) {
-      LibraryTreeItem *pLibraryTreeItem = pLibraryTreeModel->getRootLibraryTreeItem()->child(pSearchWidget->getSearchScopeComboBox()->currentIndex());
-      getFiles(pLibraryTreeItem->getFileName(), pattern, filelist);
-    } else {
-      // start the index from 1 as 0 is dummy root item
-      for (int i = 1; i < pLibraryTreeModel->getRootLibraryTreeItem()->childrenSize(); ++i) {
-        LibraryTreeItem *pLibraryTreeItem = pLibraryTreeModel->getRootLibraryTreeItem()->child(i);
-        getFiles(pLibraryTreeItem->getFileName(), pattern, filelist);
-      }
+  if (mSearchString.isEmpty()) {
+    return;
+  }
+  mFiles.clear();
+  mFileLibraries.clear();
+  qDeleteAll(mSearchIndexes);
+  mSearchIndexes.clear();
+  for (int i = 0 ; i < mSearchPaths.size() ; i++) {
+    QStringList files;
+    getFiles(mSearchPaths.at(i), mFilePatterns, files);
+    mFiles.append(files);
+    mFileLibraries.insert(mFileLibraries.size(), files.size(), i);
+    if (mUseIndex) {
+      SearchIndex *pSearchIndex = new SearchIndex(mSearchPaths.at(i));
+      pSearchIndex->load();
+      pSearchIndex->removeMissingEntries(files);
+      mSearchIndexes.append(pSearchIndex);
     }
-    emit setProgressBarRange(filelist.size());
-    int count=1;
-    for (int i = 0; i < filelist.size(); ++i) {
-      Sleep::msleep(10);
-      // check for cancel operation
-      if (mStop) {
-        emit setProgressBarCancelValue(i,filelist.size());
-        emit setFoundFilesLabel(count-1);
-        return;
+  }
+  /* The fast path matches the lower case bytes of the file. It is only valid for ASCII search strings since the file contents are not
+   * decoded. Other search strings and regular expressions are matched line by line on the decoded text.
+   */
+  mLowerSearchBytes.clear();
+  mQuerySignature.clear();
+  if (!mRegularExpression) {
+    QByteArray searchBytes = mSearchString.toUtf8();
+    bool ascii = true;
+    for (int i = 0 ; i < searchBytes.size() ; i++) {
+      if ((uchar)searchBytes.at(i) >= 0x80) {
+        ascii = false;
+        break;
       }
-      emit setProgressBarValue(i,filelist.size());
-      QString fileName = filelist.at(i);
-      QFile file(fileName);
-      if (file.open(QIODevice::ReadOnly)) {
-        QString line;
-        QStringList foundLines;
-        QMap<int,QString> lineCounts;
-        QTextStream in(&file);
-        int linenumber = 0;
-        bool value=false;
-        while (!in.atEnd()) {
-          line = in.readLine();
-          linenumber+=1;
-          if (line.contains(searchString, Qt::CaseInsensitive)) {
-            foundLines << line;
-            lineCounts[linenumber].append(line);
-            //break;
-            value=true;
-          }
-        }
-        if (value==true) {
-          emit setTreeWidgetItems(SearchFileDetails(fileName, lineCounts));
-          emit setFoundFilesLabel(count);
-          count+=1;
+    }
+    if (ascii) {
+      mLowerSearchBytes = searchBytes.toLower();
+      mQuerySignature = SearchIndex::signature(mLowerSearchBytes);
+    }
+  }
+  emit setProgressBarRange(mFiles.size());
+  mNextFile = 0;
+  mSearchedFiles = 0;
+  mFoundFiles = 0;
+  mPendingResults.clear();
+  mIndexUpdates.clear();
+  QThreadPool threadPool;
+  threadPool.setMaxThreadCount(qMax(QThread::idealThreadCount(), 1));
+  for (int i = 0 ; i < threadPool.maxThreadCount() ; i++) {
+    threadPool.start(new SearchRunnable(this));
+  }
+  while (!threadPool.waitForDone(100)) {
+    flushResults();
+  }
+  flushResults();
+  // the index is only read by the search threads so update it once they are done
+  foreach (const IndexUpdate &indexUpdate, mIndexUpdates) {
+    mSearchIndexes.at(indexUpdate.mLibrary)->setEntry(indexUpdate.mFileName, indexUpdate.mEntry);
+  }
+  mIndexUpdates.clear();
+  foreach (SearchIndex *pSearchIndex, mSearchIndexes) {
+    pSearchIndex->save();
+  }
+  if (mStop) {
+    emit setProgressBarCancelValue(mSearchedFiles.fetchAndAddRelaxed(0) - 1, mFiles.size());
+  } else {
+    emit setProgressBarFinishedValue(mFiles.size());
+  }
+  emit setFoundFilesLabel(mFoundFiles);
+}
+
+/*!
+ * \brief Search::searchFiles
+ * Searches the files until all files are taken or the search is cancelled.
+ * Called from the threads of the search thread pool.
+ */
+void Search::searchFiles()
+{
+  QByteArrayMatcher matcher(mLowerSearchBytes);
+  QRegExp regExp(mSearchString, Qt::CaseInsensitive);
+  forever {
+    if (mStop) {
+      return;
+    }
+    int fileIndex = mNextFile.fetchAndAddRelaxed(1);
+    if (fileIndex >= mFiles.size()) {
+      return;
+    }
+    searchFile(fileIndex, matcher, regExp);
+    mSearchedFiles.fetchAndAddRelaxed(1);
+  }
+}
+
+/*!
+ * \brief Search::searchFile
+ * Searches one file and queues the found lines and the refreshed index entry of the file.
+ * \param fileIndex
+ * \param matcher - matches mLowerSearchBytes.
+ * \param regExp - the regular expression of this search thread.
+ */
+void Search::searchFile(int fileIndex, const QByteArrayMatcher &matcher, QRegExp &regExp)
+{
+  const QString &fileName = mFiles.at(fileIndex);
+  QFileInfo fileInfo(fileName);
+  SearchIndex *pSearchIndex = mUseIndex ? mSearchIndexes.at(mFileLibraries.at(fileIndex)) : 0;
+  const SearchIndex::Entry *pEntry = pSearchIndex ? pSearchIndex->entry(fileName) : 0;
+  qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+  bool upToDate = pEntry && pEntry->mSize == fileInfo.size() && pEntry->mLastModified == lastModified;
+  if (upToDate && !mQuerySignature.isEmpty() && !SearchIndex::mayContain(pEntry->mSignature, mQuerySignature)) {
+    return;
+  }
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  QByteArray data = file.readAll();
+  file.close();
+  QByteArray lowerData = data.toLower();
+  QMap<int,QString> lineCounts;
+  if (!mLowerSearchBytes.isEmpty()) {
+    const char *pData = data.constData();
+    int from = 0, lineStart = 0, lineNumber = 1;
+    while ((from = matcher.indexIn(lowerData, from)) != -1) {
+      // count the lines between the previous match line and this match
+      for (int i = lineStart ; i < from ; i++) {
+        if (pData[i] == '\n') {
+          lineNumber++;
+          lineStart = i + 1;
         }
       }
+      int lineEnd = data.indexOf('\n', from);
+      if (lineEnd == -1) {
+        lineEnd = data.size();
+      }
+      int length = lineEnd - lineStart;
+      if (length > 0 && pData[lineEnd - 1] == '\r') {
+        length--;
+      }
+      lineCounts[lineNumber] = QString::fromUtf8(pData + lineStart, length);
+      from = lineEnd;
     }
-    emit setProgressBarFinishedValue(filelist.size());
-    if (count==1) {
-      emit setFoundFilesLabel(0);
+  } else {
+    QStringList lines = QString::fromUtf8(data).split('\n');
+    for (int i = 0 ; i < lines.size() ; i++) {
+      QString line = lines.at(i);
+      if (line.endsWith('\r')) {
+        line.chop(1);
+      }
+      if (mRegularExpression ? regExp.indexIn(line) != -1 : line.contains(mSearchString, Qt::CaseInsensitive)) {
+        lineCounts[i + 1] = line;
+      }
     }
   }
+  bool updateIndex = pSearchIndex && !upToDate;
+  IndexUpdate indexUpdate;
+  if (updateIndex) {
+    indexUpdate.mLibrary = mFileLibraries.at(fileIndex);
+    indexUpdate.mFileName = fileName;
+    indexUpdate.mEntry.mSize = fileInfo.size();
+    indexUpdate.mEntry.mLastModified = lastModified;
+    indexUpdate.mEntry.mSignature = SearchIndex::signature(lowerData);
+  }
+  QMutexLocker locker(&mResultsMutex);
+  if (!lineCounts.isEmpty()) {
+    mPendingResults.append(SearchFileDetails(fileName, lineCounts));
+  }
+  if (updateIndex) {
+    mIndexUpdates.append(indexUpdate);
+  }
+}
+
+/*!
+ * \brief Search::flushResults
+ * Sends the results found since the last call and the progress to the SearchResultWidget.
+ */
+void Search::flushResults()
+{
+  QList<SearchFileDetails> results;
+  mResultsMutex.lock();
+  results.swap(mPendingResults);
+  mResultsMutex.unlock();
+  if (!results.isEmpty()) {
+    mFoundFiles += results.size();
+    emit setTreeWidgetItems(results);
+    emit setFoundFilesLabel(mFoundFiles);
+  }
+  int searchedFiles = mSearchedFiles.fetchAndAddRelaxed(0);
+  if (searchedFiles > 0) {
+    emit setProgressBarValue(searchedFiles - 1, mFiles.size());
+  }
 }
 
 /*!
@@ -38,6 +38,13 @@
 #include <QPushButton>
 #include <QStackedWidget>
 #include <QProgressBar>
+#include <QCheckBox>
+#include <QHash>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QByteArrayMatcher>
+#include <QRegExp>
+#include <QVector>
 
 class Label;
 class SearchFileDetails;
@@ -72,6 +79,8 @@ private:
   QComboBox *mpSearchScopeComboBox;
   QComboBox *mpSearchStringComboBox;
   QComboBox *mpSearchFilePatternComboBox;
+  QCheckBox *mpRegularExpressionCheckBox;
+  QCheckBox *mpUseSearchIndexCheckBox;
   QComboBox *mpSearchHistoryComboBox;
   QStackedWidget *mpSearchStackedWidget;
   QAction * mpClearAction;
@@ -92,7 +101,7 @@ signals:
   void setCancelSearchResult();
 public slots:
   void findAndOpenTreeWidgetItems(QTreeWidgetItem *item, int column);
-  void updateTreeWidgetItems(SearchFileDetails fileDetails);
+  void updateTreeWidgetItems(QList<SearchFileDetails> fileDetailsList);
   void updateProgressBarRange(int);
   void updateProgressBarValue(int,int);
   void updateProgressBarCancelValue(int,int);
@@ -118,15 +127,44 @@ public:
 
 Q_DECLARE_METATYPE(SearchFileDetails)
 
+class SearchIndex
+{
+public:
+  class Entry
+  {
+  public:
+    Entry() : mSize(0), mLastModified(0) {}
+    qint64 mSize;
+    qint64 mLastModified;
+    QByteArray mSignature;
+  };
+  SearchIndex(const QString &path);
+  void load();
+  void save();
+  const Entry* entry(const QString &fileName) const;
+  void setEntry(const QString &fileName, const Entry &entry);
+  void removeMissingEntries(const QStringList &fileNames);
+  static QByteArray signature(const QByteArray &lowerData);
+  static bool mayContain(const QByteArray &signature, const QByteArray &querySignature);
+private:
+  QString mIndexFileName;
+  QHash<QString, Entry> mEntries;
+  bool mModified;
+};
+
 class Search : public QObject
 {
   Q_OBJECT
 public:
   Search(QObject * parent = 0);
+  ~Search();
+  void setSearchOptions(const QString &searchString, const QStringList &filePatterns, const QStringList &searchPaths, bool regularExpression,
+                        bool useIndex);
   void run();
+  void searchFiles();
   void getFiles(QString path, QStringList pattern, QStringList & filelist);
 signals:
-  void setTreeWidgetItems(SearchFileDetails);
+  void setTreeWidgetItems(QList<SearchFileDetails>);
   void setProgressBarRange(int);
   void setProgressBarValue(int,int);
   void setFoundFilesLabel(int);
@@ -135,5 +173,30 @@ signals:
 public slots:
   void updateCancelSearch();
 private:
-  bool mStop;
+  class IndexUpdate
+  {
+  public:
+    int mLibrary;
+    QString mFileName;
+    SearchIndex::Entry mEntry;
+  };
+  volatile bool mStop;
+  QString mSearchString;
+  QByteArray mLowerSearchBytes;
+  QByteArray mQuerySignature;
+  QStringList mFilePatterns;
+  QStringList mSearchPaths;
+  bool mRegularExpression;
+  bool mUseIndex;
+  QStringList mFiles;
+  QVector<int> mFileLibraries;
+  QList<SearchIndex*> mSearchIndexes;
+  QAtomicInt mNextFile;
+  QAtomicInt mSearchedFiles;
+  int mFoundFiles;
+  QMutex mResultsMutex;
+  QList<SearchFileDetails> mPendingResults;
+  QList<IndexUpdate> mIndexUpdates;
+  void searchFile(int fileIndex, const QByteArrayMatcher &matcher, QRegExp &regExp);
+  void flushResults();
 };
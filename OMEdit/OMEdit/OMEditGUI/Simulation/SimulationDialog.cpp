@@ -63,11 +63,13 @@ SimulationDialog::SimulationDialog(QWidget *pParent)
   : QDialog(pParent)
 {
   resize(550, 550);
+  mParameterSweepRunningCount = 0;
   setUpForm();
 }
 
 SimulationDialog::~SimulationDialog()
 {
+  mParameterSweepRunsList.clear();
   foreach (SimulationOutputWidget *pSimulationOutputWidget, mSimulationOutputWidgetsList) {
     SimulationProcessThread *pSimulationProcessThread = pSimulationOutputWidget->getSimulationProcessThread();
     /* If the SimulationProcessThread is running then we need to stop it i.e exit its event loop.
@@ -333,6 +335,19 @@ void SimulationDialog::setUpForm()
   // Launch Animation
   mpLaunchAnimationCheckBox = new QCheckBox(tr("Launch Animation"));
 #endif
+  // parameter sweep
+  mpParameterSweepGroupBox = new QGroupBox(tr("Parameter Sweep"));
+  mpParameterSweepGroupBox->setCheckable(true);
+  mpParameterSweepGroupBox->setChecked(false);
+  mpParameterSweepGroupBox->setToolTip(tr("Builds the model once and runs the simulation executable once for each line.\n"
+                                          "The runs are started in parallel on all the available processors."));
+  mpParameterSweepLabel = new Label(tr("Overrides per run, e.g., <i>a=1,b=2</i>. One line per run:"));
+  mpParameterSweepTextBox = new QPlainTextEdit;
+  mpParameterSweepTextBox->setLineWrapMode(QPlainTextEdit::NoWrap);
+  QGridLayout *pParameterSweepLayout = new QGridLayout;
+  pParameterSweepLayout->addWidget(mpParameterSweepLabel, 0, 0);
+  pParameterSweepLayout->addWidget(mpParameterSweepTextBox, 1, 0);
+  mpParameterSweepGroupBox->setLayout(pParameterSweepLayout);
   // set General Tab Layout
   QGridLayout *pGeneralTabLayout = new QGridLayout;
   pGeneralTabLayout->setAlignment(Qt::AlignTop);
@@ -350,6 +365,7 @@ void SimulationDialog::setUpForm()
 #if !defined(WITHOUT_OSG)
   pGeneralTabLayout->addWidget(mpLaunchAnimationCheckBox, 8, 0, 1, 3);
 #endif
+  pGeneralTabLayout->addWidget(mpParameterSweepGroupBox, 9, 0, 1, 3);
   mpGeneralTab->setLayout(pGeneralTabLayout);
   // add General Tab to Simulation TabWidget
   mpSimulationTabWidget->addTab(mpGeneralTabScrollArea, Helper::general);
@@ -1296,6 +1312,17 @@ SimulationOptions SimulationDialog::createSimulationOptions()
   simulationFlags.append(QString("-inputPath=%1").arg(simulationOptions.getWorkingDirectory()));
   simulationFlags.append(QString("-outputPath=%1").arg(simulationOptions.getWorkingDirectory()));
   simulationOptions.setSimulationFlags(simulationFlags);
+  // parameter sweep
+  if (mpParameterSweepGroupBox->isChecked() && !mpInteractiveSimulationGroupBox->isChecked() && !mpBuildOnlyCheckBox->isChecked()) {
+    QStringList parameterSweep;
+    foreach (QString overrides, mpParameterSweepTextBox->toPlainText().split("\n", QString::SkipEmptyParts)) {
+      overrides = overrides.simplified().remove(' ');
+      if (!overrides.isEmpty()) {
+        parameterSweep.append(overrides);
+      }
+    }
+    simulationOptions.setParameterSweep(parameterSweep);
+  }
   simulationOptions.setIsValid(true);
   simulationOptions.setReSimulate(mIsReSimulate);
 
@@ -1316,6 +1343,9 @@ void SimulationDialog::createAndShowSimulationOutputWidget(SimulationOptions sim
    */
   if (simulationOptions.isReSimulate() && simulationOptions.getLaunchAlgorithmicDebugger()) {
     showAlgorithmicDebugger(simulationOptions);
+  } else if (simulationOptions.isReSimulate() && !simulationOptions.getParameterSweep().isEmpty()) {
+    // the simulation executable already exists so start the runs directly.
+    runParameterSweep(simulationOptions);
   } else {
     if (simulationOptions.isReSimulate() && simulationOptions.isInteractiveSimulation()) {
       removeVariablesFromTree(simulationOptions.getClassName());
@@ -1332,6 +1362,8 @@ void SimulationDialog::createAndShowSimulationOutputWidget(SimulationOptions sim
       }
     }
 
+    // a re-simulation of a parameter sweep run result is a normal simulation
+    simulationOptions.setParameterSweepRun(false);
     SimulationOutputWidget *pSimulationOutputWidget = new SimulationOutputWidget(simulationOptions);
     mSimulationOutputWidgetsList.append(pSimulationOutputWidget);
     int xPos = QApplication::desktop()->availableGeometry().width() - pSimulationOutputWidget->frameSize().width() - 20;
@@ -1839,6 +1871,10 @@ OpcUaClient* SimulationDialog::getOpcUaClient(int port)
  */
 void SimulationDialog::simulationProcessFinished(SimulationOptions simulationOptions, QDateTime resultFileLastModifiedDateTime)
 {
+  // start the next run of the parameter sweep
+  if (simulationOptions.isParameterSweepRun()) {
+    parameterSweepRunFinished();
+  }
   // Simulation is over, the sampling thread should stop sampling...
   if (simulationOptions.isInteractiveSimulation()) {
     OpcUaClient *pOpcUaClient = getOpcUaClient(simulationOptions.getInteractiveSimulationPortNumber());
@@ -1870,7 +1906,9 @@ void SimulationDialog::simulationProcessFinished(SimulationOptions simulationOpt
     OMCProxy *pOMCProxy = MainWindow::instance()->getOMCProxy();
     QStringList list = pOMCProxy->readSimulationResultVars(resultFileInfo.absoluteFilePath());
     if (list.size() > 0) {
-      if (OptionsDialog::instance()->getSimulationPage()->getSwitchToPlottingPerspectiveCheckBox()->isChecked()) {
+      // the parameter sweep runs only add their results to the variables browser.
+      if (!simulationOptions.isParameterSweepRun()
+          && OptionsDialog::instance()->getSimulationPage()->getSwitchToPlottingPerspectiveCheckBox()->isChecked()) {
         bool showPlotWindow = true;
 #if !defined(WITHOUT_OSG)
         // if simulated with animation then open the animation directly.
@@ -1912,12 +1950,93 @@ void SimulationDialog::simulationProcessFinished(SimulationOptions simulationOpt
       pVariablesWidget->insertVariablesItemsToTree(simulationOptions.getFullResultFileName(), workingDirectory, list, simulationOptions);
     }
   }
-  if (OptionsDialog::instance()->getDebuggerPage()->getAlwaysShowTransformationsCheckBox()->isChecked() ||
-      simulationOptions.getLaunchTransformationalDebugger() || simulationOptions.getProfiling() != "none") {
+  if (!simulationOptions.isParameterSweepRun()
+      && (OptionsDialog::instance()->getDebuggerPage()->getAlwaysShowTransformationsCheckBox()->isChecked() ||
+          simulationOptions.getLaunchTransformationalDebugger() || simulationOptions.getProfiling() != "none")) {
     MainWindow::instance()->showTransformationsWidget(simulationOptions.getWorkingDirectory() + "/" + simulationOptions.getOutputFileName() + "_info.json");
   }
 }
 
+/*!
+ * \brief SimulationDialog::runParameterSweep
+ * Queues one run of the compiled simulation executable for each set of overrides of the parameter sweep.\n
+ * Each run writes its own result file and the runs are started by startParameterSweepRuns().
+ * \param simulationOptions - the options of the compiled model containing the parameter sweep.
+ */
+void SimulationDialog::runParameterSweep(SimulationOptions simulationOptions)
+{
+  QStringList parameterSweep = simulationOptions.getParameterSweep();
+  QString resultFileName = simulationOptions.getFullResultFileName();
+  int extensionIndex = resultFileName.lastIndexOf('.');
+  QString resultFileBaseName = extensionIndex > 0 ? resultFileName.left(extensionIndex) : resultFileName;
+  QString resultFileExtension = extensionIndex > 0 ? resultFileName.mid(extensionIndex) : QString("");
+  for (int i = 0 ; i < parameterSweep.size() ; i++) {
+    SimulationOptions runSimulationOptions = simulationOptions;
+    runSimulationOptions.setParameterSweep(QStringList());
+    runSimulationOptions.setParameterSweepRun(true);
+    runSimulationOptions.setReSimulate(true);
+    runSimulationOptions.setLaunchTransformationalDebugger(false);
+    runSimulationOptions.setLaunchAlgorithmicDebugger(false);
+    runSimulationOptions.setSimulateWithAnimation(false);
+    runSimulationOptions.setShowGeneratedFiles(false);
+    runSimulationOptions.setResultFileName(QString("%1_%2%3").arg(resultFileBaseName).arg(i + 1).arg(resultFileExtension));
+    QStringList simulationFlags = runSimulationOptions.getSimulationFlags();
+    for (int j = 0 ; j < simulationFlags.size() ; j++) {
+      if (simulationFlags.at(j).startsWith("-override=")) {
+        simulationFlags[j] = QString("%1,%2").arg(simulationFlags.at(j), parameterSweep.at(i));
+      } else if (simulationFlags.at(j).startsWith("-r=")) {
+        simulationFlags[j] = QString("-r=%1/%2").arg(runSimulationOptions.getWorkingDirectory(), runSimulationOptions.getFullResultFileName());
+      }
+    }
+    runSimulationOptions.setSimulationFlags(simulationFlags);
+    mParameterSweepRunsList.append(runSimulationOptions);
+  }
+  QString msg = tr("Running the parameter sweep of <b>%1</b> with %2 runs. The runs are listed in the archived simulations.")
+      .arg(simulationOptions.getClassName()).arg(parameterSweep.size());
+  MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0, msg, Helper::scriptingKind,
+                                                        Helper::notificationLevel));
+  startParameterSweepRuns();
+}
+
+/*!
+ * \brief SimulationDialog::startParameterSweepRuns
+ * Starts the queued parameter sweep runs while fewer runs than the number of processors are running.
+ */
+void SimulationDialog::startParameterSweepRuns()
+{
+  int maximumRunningCount = qMax(1, MainWindow::instance()->getNumberOfProcessors());
+  while (mParameterSweepRunningCount < maximumRunningCount && !mParameterSweepRunsList.isEmpty()) {
+    SimulationOutputWidget *pSimulationOutputWidget = new SimulationOutputWidget(mParameterSweepRunsList.takeFirst());
+    mSimulationOutputWidgetsList.append(pSimulationOutputWidget);
+    mParameterSweepRunningCount++;
+  }
+}
+
+/*!
+ * \brief SimulationDialog::parameterSweepRunFinished
+ * Frees the slot of a finished or failed parameter sweep run and starts the next queued run.
+ */
+void SimulationDialog::parameterSweepRunFinished()
+{
+  mParameterSweepRunningCount = qMax(0, mParameterSweepRunningCount - 1);
+  startParameterSweepRuns();
+}
+
+/*!
+ * \brief SimulationDialog::cancelParameterSweepRuns
+ * Removes the queued parameter sweep runs. The running runs are not affected.
+ */
+void SimulationDialog::cancelParameterSweepRuns()
+{
+  if (mParameterSweepRunsList.isEmpty()) {
+    return;
+  }
+  QString msg = tr("Cancelled %1 queued runs of the parameter sweep.").arg(mParameterSweepRunsList.size());
+  mParameterSweepRunsList.clear();
+  MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0, msg, Helper::scriptingKind,
+                                                        Helper::notificationLevel));
+}
+
 /*!
  * \brief SimulationDialog::numberOfIntervalsRadioToggled
  * \param toggle
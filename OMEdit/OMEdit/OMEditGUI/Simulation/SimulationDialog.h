@@ -52,6 +52,7 @@
 #include <QDialogButtonBox>
 #include <QGridLayout>
 #include <QDateTime>
+#include <QPlainTextEdit>
 
 class Label;
 class SimulationOutputWidget;
@@ -140,6 +141,9 @@ private:
 #if !defined(WITHOUT_OSG)
   QCheckBox *mpLaunchAnimationCheckBox;
 #endif
+  QGroupBox *mpParameterSweepGroupBox;
+  Label *mpParameterSweepLabel;
+  QPlainTextEdit *mpParameterSweepTextBox;
   // Translation Tab
   QWidget *mpTranslationTab;
   TranslationFlagsWidget *mpTranslationFlagsWidget;
@@ -216,6 +220,9 @@ private:
   bool mIsReSimulate;
   // interactive simulation
   QMap<int, OpcUaClient*> mOpcUaClientsMap;
+  // parameter sweep
+  QList<SimulationOptions> mParameterSweepRunsList;
+  int mParameterSweepRunningCount;
 
   void setUpForm();
   bool validate();
@@ -234,11 +241,15 @@ private:
   void removeVariablesFromTree(QString className);
   void terminateSimulationProcess(SimulationOutputWidget *pSimulationOutputWidget);
   void setInteractiveControls(bool enabled);
+  void startParameterSweepRuns();
 public:
   void reSimulate(SimulationOptions simulationOptions);
   void showAlgorithmicDebugger(SimulationOptions simulationOptions);
   void simulationProcessFinished(SimulationOptions simulationOptions, QDateTime resultFileLastModifiedDateTime);
   void createOpcUaClient(SimulationOptions simulationOptions);
+  void runParameterSweep(SimulationOptions simulationOptions);
+  void parameterSweepRunFinished();
+  void cancelParameterSweepRuns();
 public slots:
   void numberOfIntervalsRadioToggled(bool toggle);
   void intervalRadioToggled(bool toggle);
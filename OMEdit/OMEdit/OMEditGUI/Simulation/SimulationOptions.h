@@ -108,6 +108,8 @@ public:
     setSimulationFlags(QStringList());
     setIsValid(false);
     setReSimulate(false);
+    setParameterSweep(QStringList());
+    setParameterSweepRun(false);
     setWorkingDirectory("");
     setFileName("");
     setTargetLanguage("C");
@@ -233,6 +235,10 @@ public:
   bool isValid() {return mValid;}
   void setReSimulate(bool reSimulate) {mReSimulate = reSimulate;}
   bool isReSimulate() {return mReSimulate;}
+  void setParameterSweep(QStringList parameterSweep) {mParameterSweep = parameterSweep;}
+  QStringList getParameterSweep() const {return mParameterSweep;}
+  void setParameterSweepRun(bool parameterSweepRun) {mParameterSweepRun = parameterSweepRun;}
+  bool isParameterSweepRun() const {return mParameterSweepRun;}
   void setWorkingDirectory(QString workingDirectory) {mWorkingDirectory = workingDirectory;}
   QString getWorkingDirectory() const {return mWorkingDirectory;}
   void setFileName(QString fileName) {mFileName = fileName;}
@@ -301,6 +307,8 @@ private:
   QStringList mSimulationFlags;
   bool mValid;
   bool mReSimulate;
+  QStringList mParameterSweep;
+  bool mParameterSweepRun;
   QString mWorkingDirectory;
   QString mFileName;
   QString mTargetLanguage;
@@ -33,6 +33,10 @@
 
 #include "SimulationOutputHandler.h"
 
+#include <ctype.h>
+#include <string.h>
+#include <QFileInfo>
+
 /*!
   \class SimulationMessageModel
   \brief Data model for Simulation output messages.
@@ -46,6 +50,9 @@ SimulationMessageModel::SimulationMessageModel(SimulationOutputWidget *pSimulati
 {
   mpSimulationOutputWidget = pSimulationOutputWidget;
   mpRootSimulationMessage = new SimulationMessage;
+  mInsertPendingSimulationMessagesTimer.setSingleShot(true);
+  mInsertPendingSimulationMessagesTimer.setInterval(100);
+  connect(&mInsertPendingSimulationMessagesTimer, SIGNAL(timeout()), SLOT(insertPendingSimulationMessages()));
 }
 
 /*!
@@ -184,16 +191,17 @@ int SimulationMessageModel::getDepth(const QModelIndex &index) const
 }
 
 /*!
-  Inserts the simulation message in the data.
+  Inserts the simulation message in the data.\n
+  The messages are collected and inserted together at most every 100 ms so that a flood of messages doesn't update the view for each message.
   \param pSimulationMessage - the simulation message to insert.
   */
 void SimulationMessageModel::insertSimulationMessage(SimulationMessage *pSimulationMessage)
 {
   if (pSimulationMessage) {
-    int row = mpRootSimulationMessage->children().size();
-    beginInsertRows(QModelIndex(), row, row);
-    mpRootSimulationMessage->insertChild(row, pSimulationMessage);
-    endInsertRows();
+    mPendingSimulationMessages.append(pSimulationMessage);
+    if (!mInsertPendingSimulationMessagesTimer.isActive()) {
+      mInsertPendingSimulationMessagesTimer.start();
+    }
   }
 }
 
@@ -248,6 +256,24 @@ void SimulationMessageModel::selectedRowsHelper(SimulationMessage *pParentSimula
   }
 }
 
+/*!
+  Inserts the collected simulation messages with one rows insertion.
+  Slot activated when mInsertPendingSimulationMessagesTimer timeout signal is raised.
+  Also called directly to flush the collected messages when the simulation ends.
+  */
+void SimulationMessageModel::insertPendingSimulationMessages()
+{
+  mInsertPendingSimulationMessagesTimer.stop();
+  if (mPendingSimulationMessages.isEmpty()) {
+    return;
+  }
+  int row = mpRootSimulationMessage->mChildren.size();
+  beginInsertRows(QModelIndex(), row, row + mPendingSimulationMessages.size() - 1);
+  mpRootSimulationMessage->mChildren.append(mPendingSimulationMessages);
+  endInsertRows();
+  mPendingSimulationMessages.clear();
+}
+
 /*!
   Helper function to find the QModelIndex.
   \sa simulationMessageIndex()
@@ -281,11 +307,82 @@ QModelIndex SimulationMessageModel::simulationMessageIndexHelper(const Simulatio
     <used index="2" />
   </message>
   */
+/*!
+  The largest incomplete element kept while waiting for more simulation output.
+  */
+static const int maximumPendingOutputSize = 16 * 1024 * 1024;
+/*!
+  The number of top level messages shown before the rest of the messages are written to a file.
+  */
+static const int maximumSimulationMessages = 50000;
+
+/*!
+  Returns true if the name is equal to the string.
+  */
+static bool isXmlName(const char *pName, int nameLength, const char *pString)
+{
+  return qstrlen(pString) == (uint)nameLength && memcmp(pName, pString, nameLength) == 0;
+}
+
+/*!
+  Decodes the attribute value as an xml parser does i.e., replaces the entities and normalizes the white space characters.
+  */
+static QString decodeXmlAttributeValue(const char *pValue, int valueLength)
+{
+  int i = 0;
+  while (i < valueLength && pValue[i] != '&' && pValue[i] != '\n' && pValue[i] != '\r' && pValue[i] != '\t') {
+    i++;
+  }
+  if (i == valueLength) {
+    return QString::fromUtf8(pValue, valueLength);
+  }
+  QString value;
+  value.reserve(valueLength);
+  int start = 0;
+  for (i = 0 ; i < valueLength ; i++) {
+    if (pValue[i] == '\n' || pValue[i] == '\r' || pValue[i] == '\t') {
+      value.append(QString::fromUtf8(pValue + start, i - start));
+      value.append(QChar(' '));
+      start = i + 1;
+    } else if (pValue[i] == '&') {
+      int end = i + 1;
+      while (end < valueLength && pValue[end] != ';') {
+        end++;
+      }
+      if (end == valueLength) {
+        break;
+      }
+      value.append(QString::fromUtf8(pValue + start, i - start));
+      QByteArray entity(pValue + i + 1, end - i - 1);
+      if (entity == "lt") {
+        value.append(QChar('<'));
+      } else if (entity == "gt") {
+        value.append(QChar('>'));
+      } else if (entity == "amp") {
+        value.append(QChar('&'));
+      } else if (entity == "quot") {
+        value.append(QChar('"'));
+      } else if (entity == "apos") {
+        value.append(QChar('\''));
+      } else if (entity.startsWith('#')) {
+        bool ok;
+        uint code = entity.startsWith("#x") ? entity.mid(2).toUInt(&ok, 16) : entity.mid(1).toUInt(&ok, 10);
+        if (ok) {
+          value.append(QString::fromUcs4(&code, 1));
+        }
+      }
+      start = end + 1;
+      i = end;
+    }
+  }
+  value.append(QString::fromUtf8(pValue + start, valueLength - start));
+  return value;
+}
+
 /*!
   \param pSimulationOutputWidget - a pointer to SimulationOutputWidget.
-  \param simulationOutput - the simulation output
   */
-SimulationOutputHandler::SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget, QString simulationOutput)
+SimulationOutputHandler::SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget)
 {
   mpSimulationOutputWidget = pSimulationOutputWidget;
   mLevel = 0;
@@ -295,51 +392,230 @@ SimulationOutputHandler::SimulationOutputHandler(SimulationOutputWidget *pSimula
   } else {
     mpSimulationMessageModel = 0;
   }
-  mXmlSimpleReader.setContentHandler(this);
-  mXmlSimpleReader.setErrorHandler(this);
-  mpXmlInputSource = new QXmlInputSource;
-  mpXmlInputSource->setData(simulationOutput.prepend("<root>"));
-  mXmlSimpleReader.parse(mpXmlInputSource, true);
+  mScanPosition = 0;
+  mScanQuote = 0;
+  mParsingFailed = false;
+  mMessagesCount = 0;
+  mSpilling = false;
 }
 
-SimulationOutputHandler::~SimulationOutputHandler()
+/*!
+  Inserts the simulation messages that are still waiting for the next batch insertion into the model.\n
+  Called when the simulation is finished so that the last messages don't wait for the timer.
+  */
+void SimulationOutputHandler::flushSimulationMessages()
 {
-  delete mpXmlInputSource;
+  if (mpSimulationMessageModel) {
+    mpSimulationMessageModel->insertPendingSimulationMessages();
+  }
+  if (mSpillFile.isOpen()) {
+    mSpillFile.flush();
+  }
 }
 
 /*!
-  Sets the new simulation output data and continues the parsing.
+  Parses the simulation output.\n
+  The output may end anywhere in the stream. The incomplete element is kept and parsed together with the next output.
+  \param output - the utf-8 encoded simulation output.
   */
-void SimulationOutputHandler::parseSimulationOutput(QString output)
+void SimulationOutputHandler::parseSimulationOutput(const QByteArray &output)
 {
-  mpXmlInputSource->setData(output);
-  mXmlSimpleReader.parseContinue();
+  if (mParsingFailed) {
+    return;
+  }
+  mBuffer.append(output);
+  const char *pData = mBuffer.constData();
+  int size = mBuffer.size();
+  int position = 0;
+  while (position < size) {
+    // the text between the elements is not part of the messages
+    const char *pTagStart = (const char*)memchr(pData + position, '<', size - position);
+    if (!pTagStart) {
+      position = size;
+      break;
+    }
+    int tagStart = pTagStart - pData;
+    int tagEnd = -1;
+    if (size - tagStart >= 4 && memcmp(pTagStart, "<!--", 4) == 0) {
+      tagEnd = mBuffer.indexOf("-->", qMax(tagStart + 4, tagStart + mScanPosition));
+      if (tagEnd >= 0) {
+        position = tagEnd + 3;
+        mScanPosition = 0;
+        continue;
+      }
+      mScanPosition = qMax(4, size - tagStart - 2);
+      position = tagStart;
+      break;
+    }
+    // find the end of the element outside of the attribute values. Continue the scan where the last output ended.
+    char quote = mScanPosition > 0 ? mScanQuote : 0;
+    for (int i = tagStart + qMax(1, mScanPosition) ; i < size ; i++) {
+      char c = pData[i];
+      if (quote) {
+        if (c == quote) {
+          quote = 0;
+        }
+      } else if (c == '"' || c == '\'') {
+        quote = c;
+      } else if (c == '>') {
+        tagEnd = i;
+        break;
+      }
+    }
+    if (tagEnd < 0) {
+      mScanPosition = size - tagStart;
+      mScanQuote = quote;
+      position = tagStart;
+      break;
+    }
+    mScanPosition = 0;
+    mScanQuote = 0;
+    if (!parseElement(pData + tagStart + 1, pData + tagEnd)) {
+      fatalError(QString("Fatal error: malformed element %1").arg(QString::fromUtf8(pTagStart, qMin(tagEnd - tagStart + 1, 256))));
+      return;
+    }
+    position = tagEnd + 1;
+  }
+  mBuffer.remove(0, position);
+  if (mBuffer.size() > maximumPendingOutputSize) {
+    fatalError(QString("Fatal error: the simulation output element exceeds %1 bytes.").arg(maximumPendingOutputSize));
+  }
+}
+
+/*!
+  Adds the plain text output of the simulation process as a top level message of the structured output.
+  \param text
+  \param type
+  */
+void SimulationOutputHandler::addTextMessage(const QString &text, StringHandler::SimulationMessageType type)
+{
+  SimulationMessage *pSimulationMessage = new SimulationMessage;
+  pSimulationMessage->mStream = "stdout";
+  pSimulationMessage->mType = type;
+  // the spilled messages are written as plain text
+  pSimulationMessage->mText = mMessagesCount < maximumSimulationMessages ? Qt::convertFromPlainText(text) : text;
+  pSimulationMessage->mLevel = 0;
+  addSimulationMessage(pSimulationMessage);
+}
+
+/*!
+  Parses the element between < and >.
+  \param pBegin - the first character after <.
+  \param pEnd - the position of >.
+  \return false if the element is malformed.
+  */
+bool SimulationOutputHandler::parseElement(const char *pBegin, const char *pEnd)
+{
+  const char *p = pBegin;
+  // skip the xml declaration, processing instructions and doctype
+  if (p < pEnd && (*p == '?' || *p == '!')) {
+    return true;
+  }
+  bool isEndElement = false;
+  if (p < pEnd && *p == '/') {
+    isEndElement = true;
+    p++;
+  }
+  const char *pName = p;
+  while (p < pEnd && !isspace((unsigned char)*p) && *p != '/') {
+    p++;
+  }
+  int nameLength = p - pName;
+  if (nameLength == 0) {
+    return false;
+  }
+  if (isEndElement) {
+    if (isXmlName(pName, nameLength, "message")) {
+      endMessageElement();
+    }
+    return true;
+  }
+  XmlAttributes attributes;
+  bool isEmptyElement = false;
+  while (p < pEnd) {
+    if (isspace((unsigned char)*p)) {
+      p++;
+      continue;
+    }
+    if (*p == '/') {
+      isEmptyElement = true;
+      p++;
+      continue;
+    }
+    XmlAttribute attribute;
+    attribute.mpName = p;
+    while (p < pEnd && *p != '=' && !isspace((unsigned char)*p)) {
+      p++;
+    }
+    attribute.mNameLength = p - attribute.mpName;
+    while (p < pEnd && isspace((unsigned char)*p)) {
+      p++;
+    }
+    if (p == pEnd || *p != '=') {
+      return false;
+    }
+    p++;
+    while (p < pEnd && isspace((unsigned char)*p)) {
+      p++;
+    }
+    if (p == pEnd || (*p != '"' && *p != '\'')) {
+      return false;
+    }
+    const char quote = *p++;
+    attribute.mpValue = p;
+    while (p < pEnd && *p != quote) {
+      p++;
+    }
+    if (p == pEnd) {
+      return false;
+    }
+    attribute.mValueLength = p - attribute.mpValue;
+    p++;
+    attributes.append(attribute);
+  }
+  startElement(pName, nameLength, attributes);
+  if (isEmptyElement && isXmlName(pName, nameLength, "message")) {
+    endMessageElement();
+  }
+  return true;
 }
 
 /*!
-  The reader calls this function when it has parsed a start element tag.
+  Handles the start of an element.
+  \param pName
+  \param nameLength
+  \param attributes
   */
-bool SimulationOutputHandler::startElement(const QString &namespaceURI, const QString &localName, const QString &qName,
-                                           const QXmlAttributes &atts)
+void SimulationOutputHandler::startElement(const char *pName, int nameLength, const XmlAttributes &attributes)
 {
-  Q_UNUSED(namespaceURI);
-  Q_UNUSED(localName);
-  if (qName == "message") {
-    if (mpSimulationOutputWidget->isOutputStructured()) {
+  if (isXmlName(pName, nameLength, "message")) {
+    if (mLevel == 0) {
+      mSpilling = mMessagesCount >= maximumSimulationMessages;
+    }
+    if (mpSimulationOutputWidget->isOutputStructured() && !mSpilling) {
       mpSimulationMessage = new SimulationMessage(mpSimulationMessageModel->getRootSimulationMessage());
     } else {
       mpSimulationMessage = new SimulationMessage;
     }
-    mpSimulationMessage->mStream = atts.value("stream");
-    mpSimulationMessage->mType = StringHandler::getSimulationMessageType(atts.value("type"));
+    QString text;
+    for (int i = 0 ; i < attributes.size() ; i++) {
+      const XmlAttribute &attribute = attributes.at(i);
+      if (isXmlName(attribute.mpName, attribute.mNameLength, "stream")) {
+        mpSimulationMessage->mStream = decodeXmlAttributeValue(attribute.mpValue, attribute.mValueLength);
+      } else if (isXmlName(attribute.mpName, attribute.mNameLength, "type")) {
+        mpSimulationMessage->mType = StringHandler::getSimulationMessageType(decodeXmlAttributeValue(attribute.mpValue, attribute.mValueLength));
+      } else if (isXmlName(attribute.mpName, attribute.mNameLength, "text")) {
+        text = decodeXmlAttributeValue(attribute.mpValue, attribute.mValueLength);
+      }
+    }
     // check if we get the message about embedded opc-ua server initialized.
-    if (atts.value("text").compare("The embedded server is initialized.") == 0) {
+    if (text.compare("The embedded server is initialized.") == 0) {
       mpSimulationOutputWidget->embeddedServerInitialized();
     }
-    if (mpSimulationOutputWidget->isOutputStructured()) {
-      mpSimulationMessage->mText = Qt::convertFromPlainText(atts.value("text"));
+    if (mpSimulationOutputWidget->isOutputStructured() && !mSpilling) {
+      mpSimulationMessage->mText = Qt::convertFromPlainText(text);
     } else {
-      mpSimulationMessage->mText = atts.value("text");
+      mpSimulationMessage->mText = text;
     }
     mpSimulationMessage->mLevel = mLevel;
     mSimulationMessagesLevelMap.insert(mLevel, mpSimulationMessage);
@@ -351,63 +627,136 @@ bool SimulationOutputHandler::startElement(const QString &namespaceURI, const QS
       }
     }
     mLevel++;
-  } else if (qName == "used") {
+  } else if (isXmlName(pName, nameLength, "used")) {
     if (mpSimulationMessage) {
-      mpSimulationMessage->mIndex = atts.value("index");
+      for (int i = 0 ; i < attributes.size() ; i++) {
+        if (isXmlName(attributes.at(i).mpName, attributes.at(i).mNameLength, "index")) {
+          mpSimulationMessage->mIndex = decodeXmlAttributeValue(attributes.at(i).mpValue, attributes.at(i).mValueLength);
+        }
+      }
+    }
+  } else if (isXmlName(pName, nameLength, "status")) {
+    for (int i = 0 ; i < attributes.size() ; i++) {
+      if (isXmlName(attributes.at(i).mpName, attributes.at(i).mNameLength, "progress")) {
+        int progress = QByteArray::fromRawData(attributes.at(i).mpValue, attributes.at(i).mValueLength).toInt();
+        mpSimulationOutputWidget->getProgressBar()->setValue(progress/100);
+      }
     }
-  } else if (qName == "status") {
-    int progress = atts.value("progress").toInt();
-    mpSimulationOutputWidget->getProgressBar()->setValue(progress/100);
   }
-  return true;
 }
 
 /*!
-  The reader calls this function when it has parsed a end element tag.
+  Handles the end of a message element.
   */
-bool SimulationOutputHandler::endElement(const QString &namespaceURI, const QString &localName, const QString &qName)
+void SimulationOutputHandler::endMessageElement()
 {
-  Q_UNUSED(namespaceURI);
-  Q_UNUSED(localName);
-  if (qName == "message") {
-    mLevel--;
-    // if mLevel is 0 then we have finished the one complete top level message tag. Add it to SimulationMessageModel now.
-    if (mLevel == 0) {
-      if (mpSimulationOutputWidget->isOutputStructured()) {
-        mpSimulationMessageModel->insertSimulationMessage(mSimulationMessagesLevelMap.value(0, 0));
-      } else {
-        mpSimulationOutputWidget->writeSimulationMessage(mSimulationMessagesLevelMap.value(0, 0));
-      }
+  if (mLevel == 0) {
+    return;
+  }
+  mLevel--;
+  // if mLevel is 0 then we have finished the one complete top level message tag. Add it to SimulationMessageModel now.
+  if (mLevel == 0) {
+    SimulationMessage *pSimulationMessage = mSimulationMessagesLevelMap.value(0, 0);
+    mSimulationMessagesLevelMap.clear();
+    mpSimulationMessage = 0;
+    addSimulationMessage(pSimulationMessage);
+  }
+}
+
+/*!
+  Adds the complete top level message to the SimulationMessageModel or the simulation output browser.\n
+  Once the number of messages reaches maximumSimulationMessages the messages are written to a file instead.
+  \param pSimulationMessage
+  */
+void SimulationOutputHandler::addSimulationMessage(SimulationMessage *pSimulationMessage)
+{
+  if (!pSimulationMessage) {
+    return;
+  }
+  if (mMessagesCount < maximumSimulationMessages) {
+    mMessagesCount++;
+    insertSimulationMessage(pSimulationMessage);
+    return;
+  }
+  if (mMessagesCount == maximumSimulationMessages) {
+    mMessagesCount++;
+    SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
+    // name the file after the result file since the parameter sweep runs share the output file name.
+    QString baseName = QFileInfo(simulationOptions.getResultFileName()).completeBaseName();
+    if (baseName.isEmpty()) {
+      baseName = simulationOptions.getOutputFileName();
+    }
+    mSpillFile.setFileName(QString("%1/%2_messages.log").arg(simulationOptions.getWorkingDirectory()).arg(baseName));
+    SimulationMessage *pInfoSimulationMessage = new SimulationMessage;
+    pInfoSimulationMessage->mStream = "stdout";
+    pInfoSimulationMessage->mType = StringHandler::OMEditInfo;
+    pInfoSimulationMessage->mLevel = 0;
+    if (mSpillFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+      pInfoSimulationMessage->mText = QString("The simulation output has more than %1 messages. The remaining messages are written to %2.")
+          .arg(maximumSimulationMessages).arg(mSpillFile.fileName());
+    } else {
+      pInfoSimulationMessage->mText = QString("The simulation output has more than %1 messages. The remaining messages are discarded. %2")
+          .arg(maximumSimulationMessages).arg(mSpillFile.errorString());
     }
+    insertSimulationMessage(pInfoSimulationMessage);
   }
-  return true;
+  spillSimulationMessage(pSimulationMessage);
+  delete pSimulationMessage;
 }
 
 /*!
-  Reports a non-recoverable error. Details of the error are stored in exception.
+  Inserts the top level message in the SimulationMessageModel or writes it to the simulation output browser.
+  \param pSimulationMessage
   */
-bool SimulationOutputHandler::fatalError(const QXmlParseException &exception)
+void SimulationOutputHandler::insertSimulationMessage(SimulationMessage *pSimulationMessage)
 {
-  // read the error message
-  QString error = QString("Fatal error on line %1, column %2: %3")
-      .arg(exception.lineNumber())
-      .arg(exception.columnNumber())
-      .arg(exception.message());
-  // construct the SimulationMessage object with error
-  SimulationMessage *pSimulationMessage;
   if (mpSimulationOutputWidget->isOutputStructured()) {
-    pSimulationMessage = new SimulationMessage(mpSimulationMessageModel->getRootSimulationMessage());
+    pSimulationMessage->setParent(mpSimulationMessageModel->getRootSimulationMessage());
+    mpSimulationMessageModel->insertSimulationMessage(pSimulationMessage);
   } else {
-    pSimulationMessage = new SimulationMessage;
+    mpSimulationOutputWidget->writeSimulationMessage(pSimulationMessage);
+    delete pSimulationMessage;
   }
+}
+
+/*!
+  Writes the message and its child messages to the messages file.
+  \param pSimulationMessage
+  */
+void SimulationOutputHandler::spillSimulationMessage(SimulationMessage *pSimulationMessage)
+{
+  if (!mSpillFile.isOpen()) {
+    return;
+  }
+  QString line = QString("%1 | %2 | ").arg(pSimulationMessage->mStream)
+      .arg(StringHandler::getSimulationMessageTypeString(pSimulationMessage->mType));
+  for (int i = 0 ; i < pSimulationMessage->mLevel ; ++i) {
+    line += "| ";
+  }
+  line += pSimulationMessage->mText;
+  if (!pSimulationMessage->mIndex.isEmpty()) {
+    line += QString(" (index %1)").arg(pSimulationMessage->mIndex);
+  }
+  line += "\n";
+  mSpillFile.write(line.toUtf8());
+  foreach (SimulationMessage *pChildSimulationMessage, pSimulationMessage->mChildren) {
+    spillSimulationMessage(pChildSimulationMessage);
+  }
+}
+
+/*!
+  Reports a non-recoverable error and stops parsing the simulation output.
+  \param error
+  */
+void SimulationOutputHandler::fatalError(const QString &error)
+{
+  mParsingFailed = true;
+  mBuffer.clear();
+  // construct the SimulationMessage object with error
+  SimulationMessage *pSimulationMessage = new SimulationMessage;
   pSimulationMessage->mStream = "stderr";
   pSimulationMessage->mType = StringHandler::getSimulationMessageType("error");
   pSimulationMessage->mText = error;
   pSimulationMessage->mLevel = 0;
-  if (mpSimulationOutputWidget->isOutputStructured()) {
-    mpSimulationMessageModel->insertSimulationMessage(pSimulationMessage);
-  } else {
-    mpSimulationOutputWidget->writeSimulationMessage(pSimulationMessage);
-  }
-  return false;
+  insertSimulationMessage(pSimulationMessage);
 }
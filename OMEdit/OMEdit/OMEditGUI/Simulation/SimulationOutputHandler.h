@@ -36,7 +36,9 @@
 
 #include "Simulation/SimulationOutputWidget.h"
 
-#include <QXmlDefaultHandler>
+#include <QFile>
+#include <QTimer>
+#include <QVarLengthArray>
 
 class SimulationMessage
 {
@@ -52,6 +54,7 @@ public:
   SimulationMessage(SimulationMessage *pParentSimulationMessage = 0)
     : mpParentSimulationMessage(pParentSimulationMessage)
   {mStream = ""; mType = StringHandler::Unknown; mText = ""; mIndex = "";}
+  ~SimulationMessage() {qDeleteAll(mChildren);}
   void setParent(SimulationMessage *pParentSimulationMessage) {mpParentSimulationMessage = pParentSimulationMessage;}
   SimulationMessage *parent() {return mpParentSimulationMessage;}
   SimulationMessage *child(int row) {return mChildren.value(row);}
@@ -87,31 +90,54 @@ private:
   SimulationOutputWidget *mpSimulationOutputWidget;
   SimulationMessage* mpRootSimulationMessage;
   QModelIndexList mSelectedRowsList;
+  QList<SimulationMessage*> mPendingSimulationMessages;
+  QTimer mInsertPendingSimulationMessagesTimer;
 
   void selectedRowsHelper(SimulationMessage *pParentSimulationMessage);
   QModelIndex simulationMessageIndexHelper(const SimulationMessage *pSimulationMessage, const SimulationMessage *pParentSimulationMessage,
                                            const QModelIndex &parentIndex) const;
+public slots:
+  void insertPendingSimulationMessages();
 };
 
-class SimulationOutputHandler : private QXmlDefaultHandler
+class SimulationOutputHandler
 {
 private:
+  struct XmlAttribute
+  {
+    const char *mpName;
+    int mNameLength;
+    const char *mpValue;
+    int mValueLength;
+  };
+  typedef QVarLengthArray<XmlAttribute, 8> XmlAttributes;
+
   SimulationOutputWidget *mpSimulationOutputWidget;
   int mLevel;
   SimulationMessage* mpSimulationMessage;
   QMap<int, SimulationMessage*> mSimulationMessagesLevelMap;
   SimulationMessageModel *mpSimulationMessageModel;
-  QXmlSimpleReader mXmlSimpleReader;
-  QXmlInputSource *mpXmlInputSource;
+  QByteArray mBuffer;
+  int mScanPosition;
+  char mScanQuote;
+  bool mParsingFailed;
+  int mMessagesCount;
+  bool mSpilling;
+  QFile mSpillFile;
 
-  bool startElement(const QString &namespaceURI, const QString &localName, const QString &qName, const QXmlAttributes &atts);
-  bool endElement(const QString &namespaceURI, const QString &localName, const QString &qName);
-  bool fatalError(const QXmlParseException &exception);
+  bool parseElement(const char *pBegin, const char *pEnd);
+  void startElement(const char *pName, int nameLength, const XmlAttributes &attributes);
+  void endMessageElement();
+  void addSimulationMessage(SimulationMessage *pSimulationMessage);
+  void insertSimulationMessage(SimulationMessage *pSimulationMessage);
+  void spillSimulationMessage(SimulationMessage *pSimulationMessage);
+  void fatalError(const QString &error);
 public:
-  SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget, QString simulationOutput);
-  ~SimulationOutputHandler();
+  SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget);
   SimulationMessageModel* getSimulationMessageModel() {return mpSimulationMessageModel;}
-  void parseSimulationOutput(QString output);
+  void parseSimulationOutput(const QByteArray &output);
+  void addTextMessage(const QString &text, StringHandler::SimulationMessageType type);
+  void flushSimulationMessages();
 };
 
 #endif // SIMULATIONOUTPUTHANDLER_H
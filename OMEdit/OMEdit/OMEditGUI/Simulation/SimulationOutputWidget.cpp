@@ -377,6 +377,7 @@ SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptio
           SLOT(writeSimulationOutput(QString,StringHandler::SimulationMessageType,bool)));
   connect(mpSimulationProcessThread, SIGNAL(sendSimulationFinished(int,QProcess::ExitStatus)),
           SLOT(simulationProcessFinished(int,QProcess::ExitStatus)));
+  connect(mpSimulationProcessThread, SIGNAL(sendSimulationFailedToStart()), SLOT(simulationProcessFailedToStart()));
   mpSimulationProcessThread->start();
 }
 
@@ -387,6 +388,7 @@ SimulationOutputWidget::~SimulationOutputWidget()
     Utilities::removeDirectoryRecursivly(mSimulationOptions.getWorkingDirectory());
   }
   if (mpSimulationOutputHandler) {
+    mpSimulationOutputHandler->flushSimulationMessages();
     delete mpSimulationOutputHandler;
   }
   if (mpTcpServer) {
@@ -456,6 +458,22 @@ void SimulationOutputWidget::writeSimulationMessage(SimulationMessage *pSimulati
   }
 }
 
+/*!
+ * \brief SimulationOutputWidget::getSimulationOutputHandler
+ * Returns the SimulationOutputHandler. Creates it when the first simulation output arrives.
+ * \return
+ */
+SimulationOutputHandler* SimulationOutputWidget::getSimulationOutputHandler()
+{
+  if (!mpSimulationOutputHandler) {
+    mpSimulationOutputHandler = new SimulationOutputHandler(this);
+    if (isOutputStructured()) {
+      mpSimulationOutputTree->setModel(mpSimulationOutputHandler->getSimulationMessageModel());
+    }
+  }
+  return mpSimulationOutputHandler;
+}
+
 /*!
  * \brief SimulationOutputWidget::embeddedServerInitialized
  * Calls a function for creating an OpcUaClient object.
@@ -521,9 +539,11 @@ void SimulationOutputWidget::readSimulationProgress()
   if (sender()) {
     QTcpSocket *pTcpSocket = qobject_cast<QTcpSocket*>(const_cast<QObject*>(sender()));
     if (pTcpSocket) {
-      QString output = QString(pTcpSocket->readAll());
+      QByteArray output = pTcpSocket->readAll();
       if (!output.isEmpty()) {
-        writeSimulationOutput(output, StringHandler::Unknown, false);
+        mpGeneratedFilesTabWidget->setTabEnabled(0, true);
+        getSimulationOutputHandler()->parseSimulationOutput(output);
+        mpGeneratedFilesTabWidget->setCurrentIndex(0);
       }
     }
   }
@@ -537,6 +557,9 @@ void SimulationOutputWidget::readSimulationProgress()
 void SimulationOutputWidget::socketDisconnected()
 {
   mSocketDisconnected = true;
+  if (mpSimulationOutputHandler) {
+    mpSimulationOutputHandler->flushSimulationMessages();
+  }
 }
 
 /*!
@@ -590,6 +613,9 @@ void SimulationOutputWidget::compilationProcessFinished(int exitCode, QProcess::
       MainWindow::instance()->showTransformationsWidget(mSimulationOptions.getWorkingDirectory() + "/" + mSimulationOptions.getOutputFileName() + "_info.json");
     }
     MainWindow::instance()->getSimulationDialog()->showAlgorithmicDebugger(mSimulationOptions);
+    if (!mSimulationOptions.getParameterSweep().isEmpty()) {
+      MainWindow::instance()->getSimulationDialog()->runParameterSweep(mSimulationOptions);
+    }
   }
   mpArchivedSimulationItem->setStatus(Helper::finished);
   // remove the generated files
@@ -614,6 +640,9 @@ void SimulationOutputWidget::simulationProcessStarted()
   mpProgressBar->setTextVisible(true);
   mpCancelButton->setText(Helper::cancelSimulation);
   mpCancelButton->setEnabled(true);
+  if (mSimulationOptions.isParameterSweepRun()) {
+    mpCancelButton->setToolTip(tr("Cancels this run and the queued runs of the parameter sweep"));
+  }
   // save the current datetime as last modified datetime for result file.
   mResultFileLastModifiedDateTime = QDateTime::currentDateTime();
   mpArchivedSimulationItem->setStatus(Helper::running);
@@ -632,20 +661,9 @@ void SimulationOutputWidget::writeSimulationOutput(QString output, StringHandler
   mpGeneratedFilesTabWidget->setTabEnabled(0, true);
   if (isOutputStructured()) {
     if (textFormat) {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
-      QString escaped = QString(output).toHtmlEscaped();
-#else /* Qt4 */
-      QString escaped = Qt::escape(output);
-#endif
-      output = QString("<message stream=\"stdout\" type=\"%1\" text=\"%2\" />")
-          .arg(StringHandler::getSimulationMessageTypeString(type))
-          .arg(escaped);
-    }
-    if (!mpSimulationOutputHandler) {
-      mpSimulationOutputHandler = new SimulationOutputHandler(this, output);
-      mpSimulationOutputTree->setModel(mpSimulationOutputHandler->getSimulationMessageModel());
+      getSimulationOutputHandler()->addTextMessage(output, type);
     } else {
-      mpSimulationOutputHandler->parseSimulationOutput(output);
+      getSimulationOutputHandler()->parseSimulationOutput(output.toUtf8());
     }
   } else {
     /* move the cursor down before adding to the logger. */
@@ -659,10 +677,8 @@ void SimulationOutputWidget::writeSimulationOutput(QString output, StringHandler
     /* append the output */
     if (textFormat) {
       mpSimulationOutputTextBrowser->insertPlainText(output + "\n");
-    } else if (!mpSimulationOutputHandler) {
-      mpSimulationOutputHandler = new SimulationOutputHandler(this, output);
     } else {
-      mpSimulationOutputHandler->parseSimulationOutput(output);
+      getSimulationOutputHandler()->parseSimulationOutput(output.toUtf8());
     }
     /* move the cursor */
     textCursor.movePosition(QTextCursor::End);
@@ -683,6 +699,10 @@ void SimulationOutputWidget::simulationProcessFinished(int exitCode, QProcess::E
 {
   Q_UNUSED(exitCode);
   Q_UNUSED(exitStatus);
+  // show the messages still waiting for the next batch insertion
+  if (mpSimulationOutputHandler) {
+    mpSimulationOutputHandler->flushSimulationMessages();
+  }
   mpProgressLabel->setText(tr("Simulation of <b>%1</b> is finished.").arg(mSimulationOptions.getClassName()));
   mpProgressBar->setValue(mpProgressBar->maximum());
   mpCancelButton->setEnabled(false);
@@ -694,13 +714,34 @@ void SimulationOutputWidget::simulationProcessFinished(int exitCode, QProcess::E
   }
 }
 
+/*!
+ * \brief SimulationOutputWidget::simulationProcessFailedToStart
+ * Slot activated when SimulationProcessThread sendSimulationFailedToStart signal is raised.\n
+ * Updates the controls and lets the SimulationDialog start the next queued run of a parameter sweep.
+ */
+void SimulationOutputWidget::simulationProcessFailedToStart()
+{
+  mpProgressLabel->setText(tr("Simulation of <b>%1</b> failed to start.").arg(mSimulationOptions.getClassName()));
+  mpProgressBar->setRange(0, 1);
+  mpProgressBar->setValue(1);
+  mpCancelButton->setEnabled(false);
+  mpArchivedSimulationItem->setStatus(Helper::finished);
+  if (mSimulationOptions.isParameterSweepRun()) {
+    MainWindow::instance()->getSimulationDialog()->parameterSweepRunFinished();
+  }
+}
+
 /*!
  * \brief SimulationOutputWidget::cancelCompilationOrSimulation
  * Slot activated when mpCancelButton clicked signal is raised.\n
- * Cancels a running compilaiton/simulation by killing the compilation/simulation process.
+ * Cancels a running compilaiton/simulation by killing the compilation/simulation process.\n
+ * Cancelling a run of a parameter sweep also removes the queued runs of the sweep.
  */
 void SimulationOutputWidget::cancelCompilationOrSimulation()
 {
+  if (mSimulationOptions.isParameterSweepRun()) {
+    MainWindow::instance()->getSimulationDialog()->cancelParameterSweepRuns();
+  }
   if (mpSimulationProcessThread->isCompilationProcessRunning()) {
     mpSimulationProcessThread->setCompilationProcessKilled(true);
     mpSimulationProcessThread->getCompilationProcess()->kill();
@@ -765,10 +806,10 @@ void SimulationOutputWidget::openTransformationBrowser(QUrl url)
 #else /* Qt4 */
     int equationIndex = url.queryItemValue("index").toInt();
 #endif
-    QTreeWidgetItem *pTreeWidgetItem = pTransformationsWidget->findEquationTreeItem(equationIndex);
-    if (pTreeWidgetItem) {
-      pTransformationsWidget->getEquationsTreeWidget()->clearSelection();
-      pTransformationsWidget->getEquationsTreeWidget()->setCurrentItem(pTreeWidgetItem);
+    QModelIndex equationModelIndex = pTransformationsWidget->findEquationModelIndex(equationIndex);
+    if (equationModelIndex.isValid()) {
+      pTransformationsWidget->getEquationsTreeView()->clearSelection();
+      pTransformationsWidget->getEquationsTreeView()->setCurrentIndex(equationModelIndex);
     }
     pTransformationsWidget->fetchEquationData(equationIndex);
   } else {
@@ -113,6 +113,7 @@ private:
   SimulationProcessThread *mpSimulationProcessThread;
   QDateTime mResultFileLastModifiedDateTime;
 
+  SimulationOutputHandler* getSimulationOutputHandler();
   void deleteIntermediateCompilationFiles();
 public slots:
   void createSimulationProgressSocket();
@@ -124,6 +125,7 @@ public slots:
   void simulationProcessStarted();
   void writeSimulationOutput(QString output, StringHandler::SimulationMessageType type, bool textFormat);
   void simulationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+  void simulationProcessFailedToStart();
   void cancelCompilationOrSimulation();
   void openTransformationalDebugger();
   void openTransformationBrowser(QUrl url);
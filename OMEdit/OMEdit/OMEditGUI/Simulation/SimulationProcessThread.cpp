@@ -35,6 +35,9 @@
 #include "Options/OptionsDialog.h"
 
 #include <QDir>
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include <QSet>
 
 SimulationProcessThread::SimulationProcessThread(SimulationOutputWidget *pSimulationOutputWidget)
   : QThread(pSimulationOutputWidget), mpSimulationOutputWidget(pSimulationOutputWidget)
@@ -88,6 +91,10 @@ void SimulationProcessThread::compileModel()
     numProcs = QString::number(simulationOptions.getNumberOfProcessors());
   }
   SimulationPage *pSimulationPage = OptionsDialog::instance()->getSimulationPage();
+  mObjectFilesKeys.clear();
+  if (pSimulationPage->getReuseCompiledObjectFilesCheckBox()->isChecked() && simulationOptions.getTargetLanguage().compare("C") == 0) {
+    restoreCachedObjectFiles();
+  }
   QStringList args;
 #ifdef WIN32
 #if defined(__MINGW32__) && defined(__MINGW64__) /* on 64 bit */
@@ -112,6 +119,138 @@ void SimulationProcessThread::compileModel()
 #endif
 }
 
+/*!
+ * \brief SimulationProcessThread::getObjectFilesCacheDirectory
+ * Returns the directory of the compiled object files cache of the model.
+ * \return
+ */
+QString SimulationProcessThread::getObjectFilesCacheDirectory()
+{
+  SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
+  return QString("%1/%2.objectcache").arg(simulationOptions.getWorkingDirectory(), simulationOptions.getOutputFileName());
+}
+
+/*!
+ * \brief SimulationProcessThread::restoreCachedObjectFiles
+ * Copies the cached object files of the generated C files that didn't change since they were compiled.\n
+ * The cache is keyed on the contents of the C file, the generated header files, the makefile and the OpenModelica version and runtime headers.
+ * The models that include external C code are not cached since the included files are only referenced by name.\n
+ * The object files are rewritten instead of copied so they are newer than the regenerated C files and make doesn't compile them again.
+ */
+void SimulationProcessThread::restoreCachedObjectFiles()
+{
+  SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
+  QDir workingDirectory(simulationOptions.getWorkingDirectory());
+  QString outputFileName = simulationOptions.getOutputFileName();
+  // the Include annotations of the model end up in the includes header.
+  QFile includesFile(workingDirectory.filePath(outputFileName + "_includes.h"));
+  if (includesFile.open(QIODevice::ReadOnly)) {
+    bool hasExternalIncludes = includesFile.readAll().contains("#include");
+    includesFile.close();
+    if (hasExternalIncludes) {
+      emit sendCompilationOutput(tr("Not reusing the object files since the model includes external C code.\n"), Qt::blue);
+      return;
+    }
+  }
+  // the headers and the compiler flags in the makefile are shared by all the C files.
+  QCryptographicHash commonHash(QCryptographicHash::Sha1);
+  /* The makefile doesn't change when OpenModelica is upgraded in place.
+   * So also key on the OpenModelica version and the runtime headers the object files are compiled against.
+   */
+  commonHash.addData(Helper::OpenModelicaVersion.toUtf8());
+  QDirIterator runtimeHeaders(QString("%1/include/omc").arg(Helper::OpenModelicaHome), QStringList() << "*.h", QDir::Files,
+                              QDirIterator::Subdirectories);
+  QStringList runtimeHeaderFiles;
+  while (runtimeHeaders.hasNext()) {
+    runtimeHeaders.next();
+    runtimeHeaderFiles.append(QString("%1 %2 %3").arg(runtimeHeaders.filePath()).arg(runtimeHeaders.fileInfo().size())
+                              .arg(runtimeHeaders.fileInfo().lastModified().toMSecsSinceEpoch()));
+  }
+  runtimeHeaderFiles.sort();
+  commonHash.addData(runtimeHeaderFiles.join("\n").toUtf8());
+  QStringList commonFiles = workingDirectory.entryList(QStringList() << outputFileName + "*.h", QDir::Files, QDir::Name);
+  commonFiles.append(outputFileName + ".makefile");
+  foreach (QString fileName, commonFiles) {
+    QFile file(workingDirectory.filePath(fileName));
+    if (file.open(QIODevice::ReadOnly)) {
+      commonHash.addData(fileName.toUtf8());
+      commonHash.addData(file.readAll());
+      file.close();
+    }
+  }
+  QByteArray commonKey = commonHash.result();
+  QString cacheDirectory = getObjectFilesCacheDirectory();
+  int reusedObjectFiles = 0;
+  foreach (QString fileName, workingDirectory.entryList(QStringList() << outputFileName + "*.c", QDir::Files, QDir::Name)) {
+    QFile file(workingDirectory.filePath(fileName));
+    if (!file.open(QIODevice::ReadOnly)) {
+      continue;
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(commonKey);
+    hash.addData(fileName.toUtf8());
+    hash.addData(file.readAll());
+    file.close();
+    QString key = QString(hash.result().toHex());
+    QString objectFileName = workingDirectory.filePath(fileName.left(fileName.length() - 2) + ".o");
+    mObjectFilesKeys.insert(objectFileName, key);
+    QString cachedObjectFileName = QString("%1/%2.o").arg(cacheDirectory, key);
+    QFile cachedObjectFile(cachedObjectFileName);
+    if (cachedObjectFile.open(QIODevice::ReadOnly)) {
+      // QFile::copy keeps the modification time of the cached file on some platforms.
+      QByteArray objectFileData = cachedObjectFile.readAll();
+      cachedObjectFile.close();
+      QFile objectFile(objectFileName);
+      if (objectFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        bool written = objectFile.write(objectFileData) == objectFileData.size() && objectFile.flush();
+        objectFile.close();
+        if (written) {
+          reusedObjectFiles++;
+        } else {
+          QFile::remove(objectFileName);
+        }
+      }
+    }
+  }
+  if (reusedObjectFiles > 0) {
+    emit sendCompilationOutput(tr("Reusing %1 of %2 object files of unchanged generated C files.\n").arg(reusedObjectFiles)
+                               .arg(mObjectFilesKeys.size()), Qt::blue);
+  }
+}
+
+/*!
+ * \brief SimulationProcessThread::updateObjectFilesCache
+ * Stores the object files of the successful compilation in the cache.\n
+ * The cache only keeps the object files of the last compilation.
+ */
+void SimulationProcessThread::updateObjectFilesCache()
+{
+  if (mObjectFilesKeys.isEmpty()) {
+    return;
+  }
+  QString cacheDirectory = getObjectFilesCacheDirectory();
+  if (!QDir().mkpath(cacheDirectory)) {
+    return;
+  }
+  QSet<QString> cachedObjectFiles;
+  QHash<QString, QString>::const_iterator iterator;
+  for (iterator = mObjectFilesKeys.constBegin() ; iterator != mObjectFilesKeys.constEnd() ; ++iterator) {
+    QString cachedObjectFileName = QString("%1.o").arg(iterator.value());
+    if (QFile::exists(iterator.key())) {
+      if (!QFile::exists(QString("%1/%2").arg(cacheDirectory, cachedObjectFileName))) {
+        QFile::copy(iterator.key(), QString("%1/%2").arg(cacheDirectory, cachedObjectFileName));
+      }
+      cachedObjectFiles.insert(cachedObjectFileName);
+    }
+  }
+  foreach (QString fileName, QDir(cacheDirectory).entryList(QStringList() << "*.o", QDir::Files)) {
+    if (!cachedObjectFiles.contains(fileName)) {
+      QFile::remove(QString("%1/%2").arg(cacheDirectory, fileName));
+    }
+  }
+  mObjectFilesKeys.clear();
+}
+
 /*!
  * \brief SimulationProcessThread::runSimulationExecutable
  * Runs the simulation executable.
@@ -213,11 +352,14 @@ void SimulationProcessThread::compilationProcessFinished(int exitCode, QProcess:
   mIsCompilationProcessRunning = false;
   QString exitCodeStr = tr("Compilation process failed. Exited with code %1.").arg(exitCode);
   if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+    updateObjectFilesCache();
     emit sendCompilationOutput(tr("Compilation process finished successfully."), Qt::blue);
     emit sendCompilationFinished(exitCode, exitStatus);
     // if not build only and launch the algorithmic debugger is false then run the simulation process.
+    // The runs of a parameter sweep are started by the SimulationDialog.
     SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
-    if (!simulationOptions.getBuildOnly() && !simulationOptions.getLaunchAlgorithmicDebugger()) {
+    if (!simulationOptions.getBuildOnly() && !simulationOptions.getLaunchAlgorithmicDebugger()
+        && simulationOptions.getParameterSweep().isEmpty()) {
       runSimulationExecutable();
     }
   } else if (mpCompilationProcess->error() == QProcess::UnknownError) {
@@ -270,18 +412,21 @@ void SimulationProcessThread::readSimulationStandardError()
 /*!
  * \brief SimulationProcessThread::simulationProcessError
  * Slot activated when mpSimulationProcess errorOccurred signal is raised.\n
- * Notifies the SimulationOutputWidget about the erro by emitting the sendSimulationOutput signal.
+ * Notifies the SimulationOutputWidget about the erro by emitting the sendSimulationOutput signal.\n
+ * The finished signal is not raised when the process fails to start so emit sendSimulationFailedToStart in that case.
  * \param error
  */
 void SimulationProcessThread::simulationProcessError(QProcess::ProcessError error)
 {
-  Q_UNUSED(error);
   mIsSimulationProcessRunning = false;
   /* this signal is raised when we kill the simulation process forcefully. */
   if (isSimulationProcessKilled()) {
     return;
   }
   emit sendSimulationOutput(mpSimulationProcess->errorString(), StringHandler::Error, true);
+  if (error == QProcess::FailedToStart) {
+    emit sendSimulationFailedToStart();
+  }
 }
 
 /*!
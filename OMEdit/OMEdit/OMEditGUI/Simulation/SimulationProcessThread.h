@@ -38,6 +38,7 @@
 #include "Util/StringHandler.h"
 
 #include <QThread>
+#include <QHash>
 
 class SimulationOutputWidget;
 class SimulationProcessThread : public QThread
@@ -63,8 +64,12 @@ private:
   QProcess *mpSimulationProcess;
   bool mIsSimulationProcessKilled;
   bool mIsSimulationProcessRunning;
+  QHash<QString, QString> mObjectFilesKeys;
 
   void compileModel();
+  QString getObjectFilesCacheDirectory();
+  void restoreCachedObjectFiles();
+  void updateObjectFilesCache();
   void runSimulationExecutable();
 private slots:
   void compilationProcessStarted();
@@ -85,6 +90,7 @@ signals:
   void sendEstablishConnectionRunning();
   void sendSimulationOutput(QString, StringHandler::SimulationMessageType type, bool);
   void sendSimulationFinished(int, QProcess::ExitStatus);
+  void sendSimulationFailedToStart();
 };
 
 #endif // SIMULATIONPROCESSTHREAD_H
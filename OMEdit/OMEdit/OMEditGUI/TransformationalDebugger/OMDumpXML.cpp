@@ -38,6 +38,8 @@
 #include <QXmlStreamReader>
 #include <QTextDocument>
 
+#include <ctype.h>
+
 QString OMOperation::toString()
 {
   return "unknown operation";
@@ -275,15 +277,40 @@ QString OMEquation::toString()
 MyHandler::MyHandler(QFile &file, QHash<QString,OMVariable> &variables, QList<OMEquation*> &equations) : variables(variables), equations(equations)
 {
   hasOperationsEnabled = false;
-  QXmlSimpleReader xmlReader;
-  QXmlInputSource *source = new QXmlInputSource(&file);
-  xmlReader.setContentHandler(this);
-  xmlReader.setErrorHandler(this);
-  bool ok = xmlReader.parse(source);
-  delete source;
-  if (!ok) {
+  if (!file.isOpen() && !file.open(QIODevice::ReadOnly)) {
     throw QString("Parsing failed: %1").arg(file.fileName());
   }
+  /* QXmlStreamReader hands out element names and attributes as references into its buffer,
+   * so only the values we keep are turned into strings.
+   */
+  QXmlStreamReader xml(&file);
+  startDocument();
+  while (!xml.atEnd()) {
+    switch (xml.readNext()) {
+      case QXmlStreamReader::StartElement:
+        currentText.clear();
+        startElement(xml.name().toString(), xml.attributes());
+        break;
+      case QXmlStreamReader::EndElement:
+        if (!endElement(xml.name().toString())) {
+          xml.raiseError(QString("Unexpected equation index %1").arg(currentEquation->index));
+        }
+        currentText.clear();
+        break;
+      case QXmlStreamReader::Characters:
+        currentText.append(xml.text());
+        break;
+      default:
+        break;
+    }
+  }
+  if (xml.hasError()) {
+    qWarning() << "Fatal error on line" << xml.lineNumber()
+               << ", column" << xml.columnNumber() << ":"
+               << xml.errorString();
+    throw QString("Parsing failed: %1").arg(file.fileName());
+  }
+  strings.clear();
 }
 
 MyHandler::~MyHandler()
@@ -294,55 +321,38 @@ MyHandler::~MyHandler()
   }
 }
 
-bool MyHandler::startDocument()
+void MyHandler::startDocument()
 {
   variables.clear();
   equations.clear();
   /* use index from 1; add dummy element 0 */
   equations.append(new OMEquation());
   currentSection = "unknown section";
-  return true;
 }
 
-bool MyHandler::endDocument()
+void MyHandler::startElement(const QString &qName, const QXmlStreamAttributes &atts)
 {
-  currentVariable.ops.clear(); /* avoid double delete */
-  return true;
-}
-
-bool MyHandler::characters( const QString & ch )
-{
-  currentText = ch;
-  return true;
-}
-
-bool MyHandler::startElement( const QString & namespaceURI, const QString & localName, const QString & qName, const QXmlAttributes & atts)
-{
-  Q_UNUSED(namespaceURI);
-  Q_UNUSED(localName);
   if (qName == "variable") {
-    currentVariable.name = atts.value("name");
-    currentVariable.comment = atts.value("comment");
-    currentVariable.definedIn.clear();
-    currentVariable.usedIn.clear();
+    currentVariable.name = atts.value("name").toString();
+    currentVariable.comment = atts.value("comment").toString();
     currentVariable.types.clear();
     currentInfo = OMInfo();
   } else if (qName == "info") {
-    currentInfo.file = atts.value("file");
-    currentInfo.lineStart = atts.value("lineStart").toLong();
-    currentInfo.lineEnd = atts.value("lineEnd").toLong();
-    currentInfo.colStart = atts.value("colStart").toLong();
-    currentInfo.colEnd = atts.value("colEnd").toLong();
+    currentInfo.file = intern(atts.value("file").toString());
+    currentInfo.lineStart = atts.value("lineStart").toString().toLong();
+    currentInfo.lineEnd = atts.value("lineEnd").toString().toLong();
+    currentInfo.colStart = atts.value("colStart").toString().toLong();
+    currentInfo.colEnd = atts.value("colEnd").toString().toLong();
     currentInfo.isValid = true;
   } else if (qName == "equation") {
     currentEquation = new OMEquation();
-    currentEquation->index = atts.value("index").toLong();
-    currentEquation->parent = atts.value("parent").toLong(); // Returns 0 on failure, which suits us
+    currentEquation->index = atts.value("index").toString().toLong();
+    currentEquation->parent = atts.value("parent").toString().toLong(); // Returns 0 on failure, which suits us
     currentEquation->section = currentSection;
     nestedEquations.clear();
     currentInfo = OMInfo();
   } else if (qName == "eq") {
-    nestedEquations.append(atts.value("index").toLong());
+    nestedEquations.append(atts.value("index").toString().toLong());
   } else if (qName == "equations" ||
              qName == "jacobian-equations" ||
              qName == "initial-equations" ||
@@ -350,9 +360,9 @@ bool MyHandler::startElement( const QString & namespaceURI, const QString & loca
              qName == "start-equations") {
     currentSection = qName;
   } else if (qName == "defines") {
-    currentEquation->defines.append(atts.value("name"));
+    currentEquation->defines.append(atts.value("name").toString());
   } else if (qName == "depends") {
-    currentEquation->depends.append(atts.value("name"));
+    currentEquation->depends.append(atts.value("name").toString());
   } else if (qName == "operations") {
     operations.clear();
     hasOperationsEnabled = true;
@@ -361,26 +371,27 @@ bool MyHandler::startElement( const QString & namespaceURI, const QString & loca
   } else if (operationTags.contains(qName)) {
     texts.clear();
     if (qName == "scalarize") {
-      currentIndex = atts.value("index").toLong();
+      currentIndex = atts.value("index").toString().toLong();
     }
   }
-  return true;
 }
 
-bool MyHandler::endElement( const QString & namespaceURI, const QString & localName, const QString & qName)
+bool MyHandler::endElement(const QString &qName)
 {
-  Q_UNUSED(namespaceURI);
-  Q_UNUSED(localName);
   if (qName == "type") {
     currentVariable.types.append(currentText);
   } else if (operationExpTags.contains(qName) || equationPartTags.contains(qName)) {
     texts.append(currentText.trimmed());
   }
   if (qName == "variable") {
-    currentVariable.info = currentInfo;
-    currentVariable.ops = operations;
+    /* fill the entry in place instead of copying a temporary variable and its operations into the hash */
+    OMVariable &variable = variables[currentVariable.name];
+    variable.name = currentVariable.name;
+    variable.comment = currentVariable.comment;
+    variable.types = currentVariable.types;
+    variable.info = currentInfo;
+    variable.ops = operations;
     operations.clear();
-    variables[currentVariable.name] = currentVariable;
   } else if (qName == "equation") {
     currentEquation->info = currentInfo;
     currentEquation->ops = operations;
@@ -391,20 +402,8 @@ bool MyHandler::endElement( const QString & namespaceURI, const QString & localN
       return false;
     }
     equations.append(currentEquation);
-    foreach (QString def, currentEquation->defines) {
-      if (!variables.contains(def)) {
-        qDebug() << "Defines " << def << " not found in variables.";
-        continue;
-      }
-      variables[def].definedIn.append(currentEquation->index);
-    }
-    foreach (QString def, currentEquation->depends) {
-      if (variables.contains(def)) {
-        variables[def].usedIn.append(currentEquation->index);
-      } else {
-        qDebug() << "Depends " << def << " not found in variables.";
-      }
-    }
+    linkVariables(currentEquation->defines, &OMVariable::definedIn, "Defines");
+    linkVariables(currentEquation->depends, &OMVariable::usedIn, "Depends");
   } else if (equationTags.contains(qName)) {
     currentEquation->text = texts;
     currentEquation->tag = qName;
@@ -435,12 +434,37 @@ bool MyHandler::endElement( const QString & namespaceURI, const QString & localN
   return true;
 }
 
-bool MyHandler::fatalError(const QXmlParseException & exception)
+/*!
+ * \brief MyHandler::linkVariables
+ * Adds the current equation to the definedIn/usedIn list of each variable in names.
+ * Looks every variable up once and replaces the name by the hash key so all equations share one copy of it.
+ * A name missing from the variables gets an empty OMVariable, as before.
+ * \param names
+ * \param indexes
+ * \param kind
+ */
+void MyHandler::linkVariables(QStringList &names, QList<int> OMVariable::*indexes, const char *kind)
 {
-  qWarning() << "Fatal error on line" << exception.lineNumber()
-             << ", column" << exception.columnNumber() << ":"
-              << exception.message();
-  return false;
+  for (int i = 0 ; i < names.size() ; i++) {
+    QHash<QString,OMVariable>::iterator it = variables.find(names[i]);
+    if (it == variables.end()) {
+      qDebug() << kind << names[i] << " not found in variables.";
+      it = variables.insert(names[i], OMVariable());
+    }
+    names[i] = it.key();
+    (it.value().*indexes).append(currentEquation->index);
+  }
+}
+
+/*!
+ * \brief MyHandler::intern
+ * Returns the shared copy of str, e.g., the file names repeated in every info element.
+ * \param str
+ * \return
+ */
+QString MyHandler::intern(const QString &str)
+{
+  return *strings.insert(str);
 }
 
 const QSet<QString> MyHandler::operationTags = QSet<QString>() << "simplify" << "substitution" << "inline" << "scalarize" << "solved" << "linear-solved" << "solve" << "derivative" << "op-residual" << "dummyderivative" << "flattening";
@@ -448,6 +472,586 @@ const QSet<QString> MyHandler::operationExpTags = QSet<QString>() << "before" <<
 const QSet<QString> MyHandler::equationTags = QSet<QString>() << "residual" << "assign" << "statement" << "linear" << "nonlinear" << "mixed" << "when" << "ifequation";
 const QSet<QString> MyHandler::equationPartTags = QSet<QString>() << "residual" << "rhs" << "statement" << "row" << "cell";
 
+/*!
+ * \class OMInfoJSONReader
+ * \brief Streaming reader for the _info.json files.
+ * Walks the document token by token and fills the variables and equations directly,
+ * instead of first building a QVariant tree of the whole file.
+ */
+OMInfoJSONReader::OMInfoJSONReader(QHash<QString,OMVariable> &variables, QList<OMEquation*> &equations)
+  : variables(variables), equations(equations)
+{
+  hasOperationsEnabled = false;
+  pos = end = 0;
+}
+
+/*!
+ * \brief OMInfoJSONReader::read
+ * Reads the file. The file is memory mapped when possible.
+ * \param file
+ * \return false on parse error, see errorString().
+ */
+bool OMInfoJSONReader::read(QFile &file)
+{
+  variables.clear();
+  equations.clear();
+  nestedEquations.clear();
+  hasOperationsEnabled = false;
+  error.clear();
+  if (!file.isOpen() && !file.open(QIODevice::ReadOnly)) {
+    return fail(file.errorString());
+  }
+  QByteArray contents;
+  uchar *pData = file.size() > 0 ? file.map(0, file.size()) : 0;
+  if (pData) {
+    pos = reinterpret_cast<const char*>(pData);
+    end = pos + file.size();
+  } else {
+    contents = file.readAll();
+    pos = contents.constData();
+    end = pos + contents.size();
+  }
+  const char *begin = pos;
+  bool ok = readDocument();
+  if (!ok) {
+    error = QString("%1 at offset %2").arg(error).arg(pos - begin);
+  }
+  if (pData) {
+    file.unmap(pData);
+  }
+  pos = end = 0;
+  strings.clear();
+  /* nested equations are listed before the system they belong to */
+  for (int i = 0 ; ok && i < nestedEquations.size() ; i++) {
+    int parent = nestedEquations[i].first;
+    if (parent >= 0 && parent < equations.size()) {
+      equations[parent]->eqs << nestedEquations[i].second;
+    }
+  }
+  nestedEquations.clear();
+  return ok;
+}
+
+bool OMInfoJSONReader::fail(const QString &message)
+{
+  if (error.isEmpty()) {
+    error = message;
+  }
+  return false;
+}
+
+QString OMInfoJSONReader::intern(const QString &str)
+{
+  return *strings.insert(str);
+}
+
+void OMInfoJSONReader::skipSpace()
+{
+  while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+    pos++;
+  }
+}
+
+bool OMInfoJSONReader::expect(char c)
+{
+  skipSpace();
+  if (pos < end && *pos == c) {
+    pos++;
+    return true;
+  }
+  return fail(QString("expected '%1'").arg(c));
+}
+
+/*!
+ * \brief OMInfoJSONReader::atClose
+ * Loop condition for the members of an object or the elements of an array.
+ * Consumes the separating comma or the closing bracket.
+ * \param close - '}' or ']'.
+ * \param first - true before the first member.
+ * \return true when the container is done or on error.
+ */
+bool OMInfoJSONReader::atClose(char close, bool first)
+{
+  skipSpace();
+  if (pos < end && *pos == close) {
+    pos++;
+    return true;
+  }
+  if (first) {
+    return pos >= end ? !fail("unexpected end of file") : false;
+  }
+  if (pos < end && *pos == ',') {
+    pos++;
+    return false;
+  }
+  return !fail(QString("expected ',' or '%1'").arg(close));
+}
+
+/*!
+ * \brief OMInfoJSONReader::readRawString
+ * Reads a string token without decoding it.
+ * \param begin - start of the string contents.
+ * \param length - length of the string contents in bytes.
+ * \param escaped - true if the contents contain escape sequences.
+ * \return
+ */
+bool OMInfoJSONReader::readRawString(const char *&begin, int &length, bool &escaped)
+{
+  if (!expect('"')) {
+    return false;
+  }
+  begin = pos;
+  escaped = false;
+  while (pos < end && *pos != '"') {
+    if (*pos == '\\') {
+      escaped = true;
+      pos++;
+    }
+    pos++;
+  }
+  if (pos >= end) {
+    return fail("unterminated string");
+  }
+  length = pos - begin;
+  pos++;
+  return true;
+}
+
+bool OMInfoJSONReader::readKey(QByteArray &key)
+{
+  const char *begin;
+  int length;
+  bool escaped;
+  if (!readRawString(begin, length, escaped) || !expect(':')) {
+    return false;
+  }
+  /* the member names we look for never contain escapes */
+  key = QByteArray::fromRawData(begin, length);
+  return true;
+}
+
+bool OMInfoJSONReader::readString(QString &str)
+{
+  skipSpace();
+  if (pos < end && *pos == 'n') {
+    str.clear();
+    return skipValue();
+  }
+  const char *begin;
+  int length;
+  bool escaped;
+  if (!readRawString(begin, length, escaped)) {
+    return false;
+  }
+  if (!escaped) {
+    str = QString::fromUtf8(begin, length);
+    return true;
+  }
+  str.clear();
+  const char *stop = begin + length;
+  const char *chunk = begin;
+  for (const char *p = begin ; p < stop ; p++) {
+    if (*p != '\\') {
+      continue;
+    }
+    str.append(QString::fromUtf8(chunk, p - chunk));
+    p++;
+    switch (*p) {
+      case 'b': str.append(QChar('\b')); break;
+      case 'f': str.append(QChar('\f')); break;
+      case 'n': str.append(QChar('\n')); break;
+      case 'r': str.append(QChar('\r')); break;
+      case 't': str.append(QChar('\t')); break;
+      case 'u':
+        if (stop - p < 5) {
+          return fail("invalid unicode escape");
+        } else {
+          bool ok;
+          ushort code = QByteArray(p + 1, 4).toUShort(&ok, 16);
+          if (!ok) {
+            return fail("invalid unicode escape");
+          }
+          /* surrogate pairs come as two escapes and end up as two QChars */
+          str.append(QChar(code));
+          p += 4;
+        }
+        break;
+      default: str.append(QChar(*p)); break;
+    }
+    chunk = p + 1;
+  }
+  str.append(QString::fromUtf8(chunk, stop - chunk));
+  return true;
+}
+
+bool OMInfoJSONReader::readInt(int &value)
+{
+  skipSpace();
+  const char *begin = pos;
+  bool negative = pos < end && *pos == '-';
+  if (negative) {
+    pos++;
+  }
+  long long result = 0;
+  while (pos < end && *pos >= '0' && *pos <= '9') {
+    result = result * 10 + (*pos - '0');
+    pos++;
+  }
+  if (pos < end && (*pos == '.' || *pos == 'e' || *pos == 'E')) {
+    /* not an integer literal; let Qt do the conversion */
+    while (pos < end && (isdigit((unsigned char)*pos) || *pos == '.' || *pos == 'e' || *pos == 'E' || *pos == '-' || *pos == '+')) {
+      pos++;
+    }
+    bool ok;
+    value = (int) QByteArray(begin, pos - begin).toDouble(&ok);
+    return ok || fail("invalid number");
+  }
+  if (pos == begin + (negative ? 1 : 0)) {
+    pos = begin;
+    value = 0;
+    /* e.g., null or a string; convert like QVariant::toInt() would */
+    return skipValue();
+  }
+  value = (int) (negative ? -result : result);
+  return true;
+}
+
+/*!
+ * \brief OMInfoJSONReader::readStringList
+ * Reads an array of strings. Each string is trimmed.
+ * \param list
+ * \return
+ */
+bool OMInfoJSONReader::readStringList(QStringList &list)
+{
+  if (!expect('[')) {
+    return false;
+  }
+  QString str;
+  for (bool first = true ; !atClose(']', first) ; first = false) {
+    if (!readString(str)) {
+      return false;
+    }
+    list << str.trimmed();
+  }
+  return error.isEmpty();
+}
+
+bool OMInfoJSONReader::skipValue()
+{
+  skipSpace();
+  if (pos >= end) {
+    return fail("unexpected end of file");
+  }
+  const char *begin;
+  int length;
+  bool escaped;
+  if (*pos == '"') {
+    return readRawString(begin, length, escaped);
+  } else if (*pos == '{' || *pos == '[') {
+    int depth = 0;
+    do {
+      if (*pos == '"') {
+        if (!readRawString(begin, length, escaped)) {
+          return false;
+        }
+        continue;
+      } else if (*pos == '{' || *pos == '[') {
+        depth++;
+      } else if (*pos == '}' || *pos == ']') {
+        depth--;
+      }
+      pos++;
+    } while (depth > 0 && pos < end);
+    return depth == 0 || fail("unexpected end of file");
+  }
+  begin = pos;
+  while (pos < end && (isalnum((unsigned char)*pos) || *pos == '-' || *pos == '+' || *pos == '.')) {
+    pos++;
+  }
+  return pos > begin || fail("unexpected character");
+}
+
+bool OMInfoJSONReader::readDocument()
+{
+  if (!expect('{')) {
+    return false;
+  }
+  QByteArray key;
+  for (bool first = true ; !atClose('}', first) ; first = false) {
+    if (!readKey(key)) {
+      return false;
+    }
+    if (key == "variables") {
+      if (!readVariables()) {
+        return false;
+      }
+    } else if (key == "equations") {
+      if (!readEquations()) {
+        return false;
+      }
+    } else if (!skipValue()) {
+      return false;
+    }
+  }
+  return error.isEmpty();
+}
+
+bool OMInfoJSONReader::readVariables()
+{
+  if (!expect('{')) {
+    return false;
+  }
+  QString name;
+  for (bool first = true ; !atClose('}', first) ; first = false) {
+    if (!readString(name) || !expect(':')) {
+      return false;
+    }
+    /* the hash key is shared by variable.name and by the defines/uses of the equations */
+    OMVariable &variable = variables[name];
+    variable.name = name;
+    if (!readVariable(variable)) {
+      return false;
+    }
+  }
+  return error.isEmpty();
+}
+
+bool OMInfoJSONReader::readVariable(OMVariable &variable)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  variable.info.isValid = true;
+  QByteArray key;
+  for (bool first = true ; !atClose('}', first) ; first = false) {
+    bool ok;
+    if (!readKey(key)) {
+      return false;
+    } else if (key == "comment") {
+      ok = readString(variable.comment);
+    } else if (key == "source") {
+      ok = readSource(variable.info, variable.ops);
+    } else {
+      ok = skipValue();
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return error.isEmpty();
+}
+
+bool OMInfoJSONReader::readEquations()
+{
+  if (!expect('[')) {
+    return false;
+  }
+  for (bool first = true ; !atClose(']', first) ; first = false) {
+    if (!readEquation(equations.size())) {
+      return false;
+    }
+  }
+  return error.isEmpty();
+}
+
+bool OMInfoJSONReader::readEquation(int index)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  OMEquation *pEquation = new OMEquation();
+  equations.append(pEquation);
+  pEquation->index = index;
+  pEquation->parent = 0;
+  pEquation->unknowns = 0;
+  pEquation->info.isValid = true;
+  int eqIndex = 0;
+  bool hasParent = false, hasDisplay = false;
+  QString str;
+  QByteArray key;
+  for (bool first = true ; !atClose('}', first) ; first = false) {
+    bool ok;
+    if (!readKey(key)) {
+      return false;
+    } else if (key == "eqIndex") {
+      ok = readInt(eqIndex);
+    } else if (key == "section") {
+      ok = readString(str);
+      pEquation->section = intern(str);
+    } else if (key == "parent") {
+      ok = readInt(pEquation->parent);
+      hasParent = true;
+    } else if (key == "defines") {
+      ok = readVariableList(pEquation->defines, &OMVariable::definedIn, index);
+    } else if (key == "uses") {
+      ok = readVariableList(pEquation->depends, &OMVariable::usedIn, index);
+    } else if (key == "equation") {
+      ok = readStringList(pEquation->text);
+    } else if (key == "tag") {
+      ok = readString(str);
+      pEquation->tag = intern(str);
+    } else if (key == "display") {
+      ok = readString(str);
+      pEquation->display = intern(str);
+      hasDisplay = true;
+    } else if (key == "unknowns") {
+      ok = readInt(pEquation->unknowns);
+    } else if (key == "source") {
+      ok = readSource(pEquation->info, pEquation->ops);
+    } else {
+      ok = skipValue();
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  if (!error.isEmpty()) {
+    return false;
+  }
+  if (eqIndex != index) {
+    return fail(QString("got index %1 expected %2").arg(eqIndex).arg(index));
+  }
+  if (!hasDisplay) {
+    pEquation->display = pEquation->tag;
+  }
+  if (hasParent) {
+    nestedEquations << qMakePair(pEquation->parent, index);
+  }
+  return true;
+}
+
+/*!
+ * \brief OMInfoJSONReader::readVariableList
+ * Reads the defines/uses of an equation and adds the equation to the definedIn/usedIn list of each variable.
+ * Each variable is looked up once and the name is replaced by the hash key.
+ * A name missing from the variables gets an empty OMVariable, as before.
+ * \param names
+ * \param indexes - OMVariable::definedIn or OMVariable::usedIn.
+ * \param index - the equation index.
+ * \return
+ */
+bool OMInfoJSONReader::readVariableList(QStringList &names, QList<int> OMVariable::*indexes, int index)
+{
+  if (!readStringList(names)) {
+    return false;
+  }
+  for (int i = 0 ; i < names.size() ; i++) {
+    QHash<QString,OMVariable>::iterator it = variables.find(names[i]);
+    if (it == variables.end()) {
+      it = variables.insert(names[i], OMVariable());
+    }
+    names[i] = it.key();
+    (it.value().*indexes).append(index);
+  }
+  return true;
+}
+
+bool OMInfoJSONReader::readSource(OMInfo &info, QList<OMOperation*> &ops)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  QByteArray key;
+  for (bool first = true ; !atClose('}', first) ; first = false) {
+    bool ok;
+    if (!readKey(key)) {
+      return false;
+    } else if (key == "info") {
+      ok = readInfo(info);
+    } else if (key == "operations") {
+      hasOperationsEnabled = true;
+      ok = expect('[');
+      for (bool firstOperation = true ; ok && !atClose(']', firstOperation) ; firstOperation = false) {
+        ok = readOperation(ops);
+      }
+      ok = ok && error.isEmpty();
+    } else {
+      ok = skipValue();
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return error.isEmpty();
+}
+
+bool OMInfoJSONReader::readInfo(OMInfo &info)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  info.isValid = true;
+  QString file;
+  QByteArray key;
+  for (bool first = true ; !atClose('}', first) ; first = false) {
+    bool ok;
+    if (!readKey(key)) {
+      return false;
+    } else if (key == "file") {
+      ok = readString(file);
+      info.file = intern(file);
+    } else if (key == "lineStart") {
+      ok = readInt(info.lineStart);
+    } else if (key == "lineEnd") {
+      ok = readInt(info.lineEnd);
+    } else if (key == "colStart") {
+      ok = readInt(info.colStart);
+    } else if (key == "colEnd") {
+      ok = readInt(info.colEnd);
+    } else {
+      ok = skipValue();
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return error.isEmpty();
+}
+
+bool OMInfoJSONReader::readOperation(QList<OMOperation*> &ops)
+{
+  if (!expect('{')) {
+    return false;
+  }
+  QString op, display;
+  QStringList data;
+  QByteArray key;
+  for (bool first = true ; !atClose('}', first) ; first = false) {
+    bool ok;
+    if (!readKey(key)) {
+      return false;
+    } else if (key == "op") {
+      ok = readString(op);
+    } else if (key == "display") {
+      ok = readString(display);
+    } else if (key == "data") {
+      ok = readStringList(data);
+    } else {
+      ok = skipValue();
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  if (!error.isEmpty()) {
+    return false;
+  }
+  QString name = display != "" ? display : op;
+  if (op == "before-after" || op == "before-after-assert") {
+    ops << new OMOperationBeforeAfter(name, data);
+  } else if (op == "chain") {
+    QStringList firstLast;
+    if (!data.isEmpty()) {
+      firstLast << data.first() << data.last();
+    }
+    ops << new OMOperationBeforeAfter(name, firstLast);
+  } else if (op == "info") {
+    ops << new OMOperationInfo(name, data.join(", "));
+  }
+  return true;
+}
+
 #if 0
 
 #include <time.h>
@@ -36,8 +36,10 @@
 #define OMDUMPXML_H
 
 #include <QFile>
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 #include <QHash>
+#include <QSet>
+#include <QPair>
 
 #include "diff_match_patch.h"
 
@@ -189,7 +191,7 @@ struct OMEquation {
   QString toString();
 };
 
-class MyHandler : private QXmlDefaultHandler {
+class MyHandler {
 public:
   bool hasOperationsEnabled;
   MyHandler(QFile &file, QHash<QString,OMVariable> &variables, QList<OMEquation*> &equations);
@@ -197,6 +199,7 @@ public:
 private:
   QHash<QString,OMVariable> &variables;
   QList<OMEquation*> &equations;
+  QSet<QString> strings;
   OMVariable currentVariable;
   OMEquation *currentEquation;
   QList<int> nestedEquations;
@@ -210,12 +213,46 @@ private:
   static const QSet<QString> equationPartTags;
   static const QSet<QString> operationTags;
   static const QSet<QString> operationExpTags;
-  bool startDocument();
-  bool endDocument();
-  bool characters( const QString & ch );
-  bool startElement( const QString & namespaceURI, const QString & localName, const QString & qName, const QXmlAttributes & atts);
-  bool endElement( const QString & namespaceURI, const QString & localName, const QString & qName);
-  bool fatalError(const QXmlParseException & exception);
+  void startDocument();
+  void startElement(const QString &qName, const QXmlStreamAttributes &atts);
+  bool endElement(const QString &qName);
+  void linkVariables(QStringList &names, QList<int> OMVariable::*indexes, const char *kind);
+  QString intern(const QString &str);
+};
+
+class OMInfoJSONReader {
+public:
+  bool hasOperationsEnabled;
+  OMInfoJSONReader(QHash<QString,OMVariable> &variables, QList<OMEquation*> &equations);
+  bool read(QFile &file);
+  QString errorString() const {return error;}
+private:
+  QHash<QString,OMVariable> &variables;
+  QList<OMEquation*> &equations;
+  QSet<QString> strings;
+  QList<QPair<int,int> > nestedEquations;
+  const char *pos, *end;
+  QString error;
+  bool fail(const QString &message);
+  QString intern(const QString &str);
+  void skipSpace();
+  bool expect(char c);
+  bool atClose(char close, bool first);
+  bool readRawString(const char *&begin, int &length, bool &escaped);
+  bool readKey(QByteArray &key);
+  bool readString(QString &str);
+  bool readInt(int &value);
+  bool readStringList(QStringList &list);
+  bool skipValue();
+  bool readDocument();
+  bool readVariables();
+  bool readVariable(OMVariable &variable);
+  bool readEquations();
+  bool readEquation(int index);
+  bool readVariableList(QStringList &names, QList<int> OMVariable::*indexes, int index);
+  bool readSource(OMInfo &info, QList<OMOperation*> &ops);
+  bool readInfo(OMInfo &info);
+  bool readOperation(QList<OMOperation*> &ops);
 };
 
 #endif
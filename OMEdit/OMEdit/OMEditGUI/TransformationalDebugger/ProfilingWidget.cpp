@@ -0,0 +1,692 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ProfilingWidget.h"
+#include "TransformationsWidget.h"
+#include "Modeling/ItemDelegate.h"
+#include "Util/Helper.h"
+#include "Util/Utilities.h"
+
+#include <QPainter>
+#include <QMouseEvent>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QResizeEvent>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+/*!
+ * \brief recordColumns
+ * Returns the number of columns of the records in a profiling data file.
+ * Uses the number of steps from the _prof.json file when the file size matches it,
+ * otherwise assumes the given number of leading columns and updates steps.
+ * \param size - the file size.
+ * \param elementSize
+ * \param steps
+ * \param blocks
+ * \param leadingColumns
+ * \return the number of columns or -1 if the file does not match.
+ */
+static int recordColumns(qint64 size, int elementSize, int &steps, int blocks, int leadingColumns)
+{
+  if (steps > 0 && size % ((qint64)elementSize * steps) == 0 && size / ((qint64)elementSize * steps) >= blocks) {
+    return size / ((qint64)elementSize * steps);
+  }
+  int columns = blocks + leadingColumns;
+  if (columns > 0 && size > 0 && size % ((qint64)elementSize * columns) == 0) {
+    steps = size / ((qint64)elementSize * columns);
+    return columns;
+  }
+  return -1;
+}
+
+/*!
+ * \class ProfilingData
+ * \brief Memory mapped per step profiling data.
+ */
+ProfilingData::ProfilingData()
+{
+  mpRealData = 0;
+  mpIntData = 0;
+  mSteps = 0;
+  mBlocks = 0;
+  mRealColumns = mRealBlocksColumn = 0;
+  mIntColumns = mIntBlocksColumn = 0;
+}
+
+ProfilingData::~ProfilingData()
+{
+  close();
+}
+
+/*!
+ * \brief ProfilingData::open
+ * Maps the profiling data files. The int data file is optional.
+ * \param realFileName - the _prof.realdata file.
+ * \param intFileName - the _prof.intdata file.
+ * \param steps - the number of records, i.e., numStep + 1 from the _prof.json file.
+ * \param blocks - the number of profile blocks, i.e., functions and equations.
+ * \return true if the real data file could be mapped.
+ */
+bool ProfilingData::open(const QString &realFileName, const QString &intFileName, int steps, int blocks)
+{
+  close();
+  mBlocks = blocks;
+  mRealFile.setFileName(realFileName);
+  if (!mRealFile.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  int realSteps = steps;
+  mRealColumns = recordColumns(mRealFile.size(), sizeof(double), realSteps, blocks, 2);
+  uchar *pRealData = mRealColumns > 0 ? mRealFile.map(0, mRealFile.size()) : 0;
+  if (!pRealData) {
+    close();
+    return false;
+  }
+  mpRealData = reinterpret_cast<const double*>(pRealData);
+  mRealBlocksColumn = mRealColumns - blocks;
+  mSteps = realSteps;
+  /* the call counts are optional */
+  mIntFile.setFileName(intFileName);
+  if (mIntFile.open(QIODevice::ReadOnly)) {
+    int intSteps = steps;
+    mIntColumns = recordColumns(mIntFile.size(), sizeof(quint32), intSteps, blocks, 1);
+    uchar *pIntData = (mIntColumns > 0 && intSteps >= mSteps) ? mIntFile.map(0, mIntFile.size()) : 0;
+    if (pIntData) {
+      mpIntData = reinterpret_cast<const quint32*>(pIntData);
+      mIntBlocksColumn = mIntColumns - blocks;
+    } else {
+      mIntFile.close();
+    }
+  }
+  return true;
+}
+
+void ProfilingData::close()
+{
+  if (mpRealData) {
+    mRealFile.unmap(reinterpret_cast<uchar*>(const_cast<double*>(mpRealData)));
+    mpRealData = 0;
+  }
+  if (mpIntData) {
+    mIntFile.unmap(reinterpret_cast<uchar*>(const_cast<quint32*>(mpIntData)));
+    mpIntData = 0;
+  }
+  mRealFile.close();
+  mIntFile.close();
+  mSteps = 0;
+}
+
+/*!
+ * \brief ProfilingData::time
+ * \param step
+ * \return the simulation time of the step, or the step number if the file has no time column.
+ */
+double ProfilingData::time(int step) const
+{
+  return mRealBlocksColumn > 0 ? mpRealData[(qint64)step * mRealColumns] : step;
+}
+
+/*!
+ * \brief ProfilingData::stepTime
+ * \param step
+ * \return the measured time of the whole step, or -1 if the file has no such column.
+ */
+double ProfilingData::stepTime(int step) const
+{
+  return mRealBlocksColumn > 1 ? mpRealData[(qint64)step * mRealColumns + 1] : -1;
+}
+
+/*!
+ * \class SparklineWidget
+ * \brief Draws a compact line of per step values.
+ * When there are more values than pixels each pixel column shows the minimum and maximum of its values.
+ */
+SparklineWidget::SparklineWidget(const QString &title, QWidget *pParent)
+  : QWidget(pParent), mTitle(title)
+{
+  mMinimum = mMaximum = 0;
+  mMarker = -1;
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+void SparklineWidget::setValues(const QVector<double> &values)
+{
+  mValues = values;
+  mMinimum = mMaximum = 0;
+  for (int i = 0 ; i < mValues.size() ; i++) {
+    mMinimum = qMin(mMinimum, mValues[i]);
+    mMaximum = qMax(mMaximum, mValues[i]);
+  }
+  update();
+}
+
+void SparklineWidget::setMarker(int index)
+{
+  mMarker = index;
+  update();
+}
+
+QSize SparklineWidget::sizeHint() const
+{
+  return QSize(300, fontMetrics().height() + 40);
+}
+
+void SparklineWidget::paintEvent(QPaintEvent *pEvent)
+{
+  Q_UNUSED(pEvent);
+  QPainter painter(this);
+  painter.fillRect(rect(), palette().base());
+  painter.setPen(palette().mid().color());
+  painter.drawRect(rect().adjusted(0, 0, -1, -1));
+  int textHeight = fontMetrics().height();
+  painter.setPen(palette().text().color());
+  painter.drawText(QRect(4, 1, width() - 8, textHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                   mValues.isEmpty() ? mTitle : QString("%1 (max %2)").arg(mTitle).arg(mMaximum, 0, 'g', 3));
+  int n = mValues.size();
+  int w = width() - 2;
+  if (n == 0 || w <= 0) {
+    return;
+  }
+  QRectF plotRect(1, textHeight + 2, w, height() - textHeight - 4);
+  double range = mMaximum - mMinimum;
+  if (range <= 0) {
+    range = 1;
+  }
+  double yScale = plotRect.height() / range;
+  painter.setPen(palette().highlight().color());
+  if (n <= w) {
+    QPolygonF line;
+    for (int i = 0 ; i < n ; i++) {
+      double x = plotRect.left() + (n > 1 ? i * (plotRect.width() - 1) / (n - 1) : 0);
+      line << QPointF(x, plotRect.bottom() - (mValues[i] - mMinimum) * yScale);
+    }
+    painter.drawPolyline(line);
+  } else {
+    for (int x = 0 ; x < w ; x++) {
+      int begin = (qint64)x * n / w;
+      int end = qMax(begin + 1, (int)((qint64)(x + 1) * n / w));
+      double minimum = mValues[begin], maximum = mValues[begin];
+      for (int i = begin + 1 ; i < end ; i++) {
+        minimum = qMin(minimum, mValues[i]);
+        maximum = qMax(maximum, mValues[i]);
+      }
+      painter.drawLine(QPointF(plotRect.left() + x, plotRect.bottom() - (minimum - mMinimum) * yScale),
+                       QPointF(plotRect.left() + x, plotRect.bottom() - (maximum - mMinimum) * yScale));
+    }
+  }
+  if (mMarker >= 0 && mMarker < n) {
+    double x = plotRect.left() + (n > 1 ? (double)mMarker * (plotRect.width() - 1) / (n - 1) : 0);
+    painter.setPen(Qt::red);
+    painter.drawLine(QPointF(x, plotRect.top()), QPointF(x, plotRect.bottom()));
+  }
+}
+
+void SparklineWidget::mousePressEvent(QMouseEvent *pEvent)
+{
+  int n = mValues.size();
+  int w = width() - 2;
+  if (n > 0 && w > 0 && pEvent->button() == Qt::LeftButton) {
+    int index = n > 1 ? qRound((double)(pEvent->pos().x() - 1) * (n - 1) / qMax(w - 1, 1)) : 0;
+    emit indexClicked(qBound(0, index, n - 1));
+  }
+  QWidget::mousePressEvent(pEvent);
+}
+
+/*!
+ * \class BlockTimeGreaterThan
+ * \brief Orders profile blocks by decreasing time.
+ */
+class BlockTimeGreaterThan
+{
+public:
+  BlockTimeGreaterThan(const QVector<double> &times) : mTimes(times) {}
+  bool operator()(int block1, int block2) const {return mTimes[block1] > mTimes[block2];}
+private:
+  const QVector<double> &mTimes;
+};
+
+/*!
+ * \class ProfilingStepWidget
+ * \brief Flame-style breakdown of one step.
+ * The first row is the whole step. Below it the equation blocks are drawn with a width proportional to their time,
+ * and the blocks of nested equations below the system they belong to.
+ * Functions are not drawn since their time is part of the equations calling them.
+ */
+ProfilingStepWidget::ProfilingStepWidget(QWidget *pParent)
+  : QWidget(pParent)
+{
+  mpProfilingData = 0;
+  mpBlocks = 0;
+  mStep = -1;
+  mStepTime = 0;
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+}
+
+/*!
+ * \brief ProfilingStepWidget::setStep
+ * Shows the breakdown of step. The data and blocks are owned by the ProfilingWidget and must outlive this widget.
+ * \param pProfilingData
+ * \param pBlocks
+ * \param step
+ */
+void ProfilingStepWidget::setStep(const ProfilingData *pProfilingData, const QList<ProfilingBlock> *pBlocks, int step)
+{
+  mpProfilingData = pProfilingData;
+  mpBlocks = pBlocks;
+  mStep = step;
+  layoutBars();
+  update();
+}
+
+QSize ProfilingStepWidget::sizeHint() const
+{
+  return QSize(300, 5 * (fontMetrics().height() + 4));
+}
+
+void ProfilingStepWidget::layoutBars()
+{
+  mBars.clear();
+  mNames.clear();
+  mStepTime = 0;
+  const ProfilingData *pProfilingData = mpProfilingData;
+  const QList<ProfilingBlock> *pBlocks = mpBlocks;
+  int step = mStep;
+  if (!pProfilingData || !pProfilingData->isOpen() || !pBlocks || step < 0 || step >= pProfilingData->steps()) {
+    return;
+  }
+  /* group the equation blocks that took time in this step by the block of their system */
+  QVector<double> times(pBlocks->size());
+  QHash<int, QList<int> > children;
+  double rootsTime = 0;
+  for (int block = 0 ; block < pBlocks->size() ; block++) {
+    const ProfilingBlock &profilingBlock = pBlocks->at(block);
+    times[block] = pProfilingData->blockTime(step, block);
+    if (profilingBlock.equation < 0 || times[block] <= 0) {
+      continue;
+    }
+    children[profilingBlock.parentBlock].append(block);
+    if (profilingBlock.parentBlock < 0) {
+      rootsTime += times[block];
+    }
+  }
+  mStepTime = qMax(pProfilingData->stepTime(step), rootsTime);
+  if (mStepTime <= 0) {
+    return;
+  }
+  double barHeight = fontMetrics().height() + 4;
+  double scale = (width() - 1) / mStepTime;
+  Bar stepBar;
+  stepBar.rect = QRectF(0, 0, width() - 1, barHeight);
+  stepBar.block = -1;
+  stepBar.time = mStepTime;
+  mBars.append(stepBar);
+  /* breadth first over the levels; each entry is a parent block and the x position of its bar */
+  QList<QPair<int, double> > parents;
+  parents << qMakePair(-1, 0.0);
+  for (int level = 1 ; !parents.isEmpty() && level < 32 ; level++) {
+    QList<QPair<int, double> > nextParents;
+    for (int i = 0 ; i < parents.size() ; i++) {
+      QList<int> blocks = children.value(parents[i].first);
+      std::sort(blocks.begin(), blocks.end(), BlockTimeGreaterThan(times));
+      double x = parents[i].second;
+      foreach (int block, blocks) {
+        double barWidth = times[block] * scale;
+        if (barWidth >= 1) {
+          Bar bar;
+          bar.rect = QRectF(x, level * barHeight, barWidth, barHeight);
+          bar.block = block;
+          bar.time = times[block];
+          mBars.append(bar);
+          nextParents << qMakePair(block, x);
+        }
+        x += barWidth;
+      }
+    }
+    parents = nextParents;
+  }
+  foreach (const Bar &bar, mBars) {
+    mNames.append(bar.block < 0 ? tr("Step %1").arg(step) : pBlocks->at(bar.block).name);
+  }
+}
+
+void ProfilingStepWidget::paintEvent(QPaintEvent *pEvent)
+{
+  Q_UNUSED(pEvent);
+  QPainter painter(this);
+  painter.fillRect(rect(), palette().base());
+  for (int i = 0 ; i < mBars.size() ; i++) {
+    const Bar &bar = mBars[i];
+    /* warm colors as in flame graphs, varied per block */
+    QColor color = bar.block < 0 ? palette().mid().color() : QColor::fromHsv((bar.block * 7) % 50, 140 + (bar.block * 13) % 80, 230);
+    painter.fillRect(bar.rect, color);
+    painter.setPen(palette().base().color());
+    painter.drawRect(bar.rect);
+    if (bar.rect.width() > 20) {
+      painter.setPen(Qt::black);
+      QRectF textRect = bar.rect.adjusted(2, 0, -2, 0);
+      painter.drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, fontMetrics().elidedText(mNames[i], Qt::ElideRight, (int)textRect.width()));
+    }
+  }
+}
+
+void ProfilingStepWidget::resizeEvent(QResizeEvent *pEvent)
+{
+  QWidget::resizeEvent(pEvent);
+  layoutBars();
+}
+
+bool ProfilingStepWidget::event(QEvent *pEvent)
+{
+  if (pEvent->type() == QEvent::ToolTip) {
+    QHelpEvent *pHelpEvent = static_cast<QHelpEvent*>(pEvent);
+    int i = blockAt(pHelpEvent->pos());
+    if (i >= 0) {
+      QToolTip::showText(pHelpEvent->globalPos(), QString("%1: %2 s (%3%)").arg(mNames[i]).arg(mBars[i].time, 0, 'g', 3)
+                         .arg(100 * mBars[i].time / mStepTime, 0, 'g', 3));
+    } else {
+      QToolTip::hideText();
+      pEvent->ignore();
+    }
+    return true;
+  }
+  return QWidget::event(pEvent);
+}
+
+void ProfilingStepWidget::mousePressEvent(QMouseEvent *pEvent)
+{
+  int i = blockAt(pEvent->pos());
+  if (i >= 0 && mBars[i].block >= 0 && pEvent->button() == Qt::LeftButton) {
+    emit blockClicked(mBars[i].block);
+  }
+  QWidget::mousePressEvent(pEvent);
+}
+
+/*!
+ * \brief ProfilingStepWidget::blockAt
+ * \param position
+ * \return the index of the bar at position or -1.
+ */
+int ProfilingStepWidget::blockAt(const QPoint &position) const
+{
+  for (int i = mBars.size() - 1 ; i >= 0 ; i--) {
+    if (mBars[i].rect.contains(position)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*!
+ * \class ProfilingWidget
+ * \brief Shows the profiling information of a simulation in the TransformationsWidget.
+ * Lists the most expensive profile blocks, the per step cost of the selected block and a breakdown of a single step.
+ */
+ProfilingWidget::ProfilingWidget(TransformationsWidget *pTransformationsWidget)
+  : QWidget(pTransformationsWidget), mpTransformationsWidget(pTransformationsWidget)
+{
+  mTotalTime = 0;
+  mCurrentBlock = -1;
+  Label *pProfilingHeadingLabel = new Label(tr("Profiling"));
+  pProfilingHeadingLabel->setObjectName("LabelWithBorder");
+  /* top blocks */
+  mpTopBlocksCountSpinBox = new QSpinBox;
+  mpTopBlocksCountSpinBox->setRange(1, 100000);
+  mpTopBlocksCountSpinBox->setValue(20);
+  connect(mpTopBlocksCountSpinBox, SIGNAL(valueChanged(int)), SLOT(updateTopBlocks()));
+  mpTopBlocksOrderComboBox = new QComboBox;
+  mpTopBlocksOrderComboBox->addItem(tr("by time"));
+  mpTopBlocksOrderComboBox->addItem(tr("by calls"));
+  connect(mpTopBlocksOrderComboBox, SIGNAL(currentIndexChanged(int)), SLOT(updateTopBlocks()));
+  QHBoxLayout *pTopBlocksFilterLayout = new QHBoxLayout;
+  pTopBlocksFilterLayout->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+  pTopBlocksFilterLayout->addWidget(new Label(tr("Top")));
+  pTopBlocksFilterLayout->addWidget(mpTopBlocksCountSpinBox);
+  pTopBlocksFilterLayout->addWidget(new Label(tr("blocks")));
+  pTopBlocksFilterLayout->addWidget(mpTopBlocksOrderComboBox);
+  mpTopBlocksTreeWidget = new QTreeWidget;
+  mpTopBlocksTreeWidget->setItemDelegate(new ItemDelegate(mpTopBlocksTreeWidget));
+  mpTopBlocksTreeWidget->setIndentation(0);
+  mpTopBlocksTreeWidget->setColumnCount(6);
+  mpTopBlocksTreeWidget->setTextElideMode(Qt::ElideMiddle);
+  mpTopBlocksTreeWidget->setSortingEnabled(true);
+  QStringList headerLabels;
+  headerLabels << tr("Block") << Helper::name << Helper::executionTime << Helper::executionCount << Helper::executionMaxTime << Helper::executionFraction;
+  mpTopBlocksTreeWidget->setHeaderLabels(headerLabels);
+  connect(mpTopBlocksTreeWidget, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), SLOT(topBlockDoubleClicked(QTreeWidgetItem*,int)));
+  QGridLayout *pTopBlocksGridLayout = new QGridLayout;
+  pTopBlocksGridLayout->setSpacing(1);
+  pTopBlocksGridLayout->setContentsMargins(0, 0, 0, 0);
+  pTopBlocksGridLayout->addLayout(pTopBlocksFilterLayout, 0, 0, Qt::AlignLeft);
+  pTopBlocksGridLayout->addWidget(mpTopBlocksTreeWidget, 1, 0);
+  QFrame *pTopBlocksFrame = new QFrame;
+  pTopBlocksFrame->setLayout(pTopBlocksGridLayout);
+  /* per step cost of the selected block */
+  mpBlockLabel = new Label;
+  mpBlockLabel->setElideMode(Qt::ElideMiddle);
+  mpTimeSparklineWidget = new SparklineWidget(tr("Time per step"));
+  connect(mpTimeSparklineWidget, SIGNAL(indexClicked(int)), SLOT(showStep(int)));
+  mpCallsSparklineWidget = new SparklineWidget(tr("Calls per step"));
+  connect(mpCallsSparklineWidget, SIGNAL(indexClicked(int)), SLOT(showStep(int)));
+  /* step breakdown */
+  mpStepSpinBox = new QSpinBox;
+  mpStepSpinBox->setRange(0, 0);
+  connect(mpStepSpinBox, SIGNAL(valueChanged(int)), SLOT(showStep(int)));
+  mpStepTimeLabel = new Label;
+  QHBoxLayout *pStepLayout = new QHBoxLayout;
+  pStepLayout->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+  pStepLayout->addWidget(new Label(tr("Step:")));
+  pStepLayout->addWidget(mpStepSpinBox);
+  pStepLayout->addWidget(mpStepTimeLabel);
+  mpProfilingStepWidget = new ProfilingStepWidget;
+  connect(mpProfilingStepWidget, SIGNAL(blockClicked(int)), SLOT(selectBlock(int)));
+  QVBoxLayout *pStepsLayout = new QVBoxLayout;
+  pStepsLayout->setSpacing(1);
+  pStepsLayout->setContentsMargins(0, 0, 0, 0);
+  pStepsLayout->addWidget(mpBlockLabel);
+  pStepsLayout->addWidget(mpTimeSparklineWidget);
+  pStepsLayout->addWidget(mpCallsSparklineWidget);
+  pStepsLayout->addLayout(pStepLayout);
+  pStepsLayout->addWidget(mpProfilingStepWidget, 1);
+  QFrame *pStepsFrame = new QFrame;
+  pStepsFrame->setLayout(pStepsLayout);
+  /* profiling splitter */
+  mpProfilingSplitter = new QSplitter;
+  mpProfilingSplitter->setChildrenCollapsible(false);
+  mpProfilingSplitter->setHandleWidth(4);
+  mpProfilingSplitter->setContentsMargins(0, 0, 0, 0);
+  mpProfilingSplitter->addWidget(pTopBlocksFrame);
+  mpProfilingSplitter->addWidget(pStepsFrame);
+  QVBoxLayout *pMainLayout = new QVBoxLayout;
+  pMainLayout->setSpacing(1);
+  pMainLayout->setContentsMargins(0, 0, 0, 0);
+  pMainLayout->addWidget(pProfilingHeadingLabel);
+  pMainLayout->addWidget(mpProfilingSplitter);
+  setLayout(pMainLayout);
+  showProfileBlock(-1);
+}
+
+/*!
+ * \brief ProfilingWidget::setProfilingBlocks
+ * Sets the aggregated profiling information. The position in blocks is the profile block number.
+ * \param blocks
+ * \param totalTime - the total time of all profile blocks.
+ */
+void ProfilingWidget::setProfilingBlocks(const QList<ProfilingBlock> &blocks, double totalTime)
+{
+  mBlocks = blocks;
+  mTotalTime = totalTime;
+  updateTopBlocks();
+}
+
+/*!
+ * \brief ProfilingWidget::openProfilingData
+ * Maps the per step profiling data of the blocks set with setProfilingBlocks.
+ * \param realFileName
+ * \param intFileName
+ * \param steps
+ * \return
+ */
+bool ProfilingWidget::openProfilingData(const QString &realFileName, const QString &intFileName, int steps)
+{
+  bool ok = mProfilingData.open(realFileName, intFileName, steps, mBlocks.size());
+  mpCallsSparklineWidget->setVisible(mProfilingData.hasCalls());
+  mpStepSpinBox->setRange(0, qMax(mProfilingData.steps() - 1, 0));
+  mpStepSpinBox->setEnabled(ok);
+  showProfileBlock(mCurrentBlock);
+  showStep(mpStepSpinBox->value());
+  return ok;
+}
+
+void ProfilingWidget::clearProfiling()
+{
+  mProfilingData.close();
+  mBlocks.clear();
+  mTotalTime = 0;
+  mCurrentBlock = -1;
+  mpTopBlocksTreeWidget->clear();
+  mpStepSpinBox->setRange(0, 0);
+  mpStepTimeLabel->clear();
+  mpProfilingStepWidget->setStep(0, 0, -1);
+  showProfileBlock(-1);
+}
+
+/*!
+ * \brief ProfilingWidget::showProfileBlock
+ * Shows the per step time and calls of the profile block.
+ * \param block - the profile block, -1 if the selected equation is not profiled.
+ */
+void ProfilingWidget::showProfileBlock(int block)
+{
+  mCurrentBlock = block;
+  QVector<double> times, calls;
+  if (block < 0 || block >= mBlocks.size()) {
+    mpBlockLabel->setText(tr("The selected equation has no profiling information."));
+  } else {
+    const ProfilingBlock &profilingBlock = mBlocks[block];
+    mpBlockLabel->setText(QString("%1: %2 s, %3 calls").arg(profilingBlock.name).arg(profilingBlock.time, 0, 'g', 3).arg(profilingBlock.ncall));
+    if (mProfilingData.isOpen()) {
+      times.resize(mProfilingData.steps());
+      for (int step = 0 ; step < mProfilingData.steps() ; step++) {
+        times[step] = mProfilingData.blockTime(step, block);
+      }
+      if (mProfilingData.hasCalls()) {
+        calls.resize(mProfilingData.steps());
+        for (int step = 0 ; step < mProfilingData.steps() ; step++) {
+          calls[step] = mProfilingData.blockCalls(step, block);
+        }
+      }
+    }
+  }
+  mpTimeSparklineWidget->setValues(times);
+  mpCallsSparklineWidget->setValues(calls);
+}
+
+/*!
+ * \brief ProfilingWidget::selectBlock
+ * Selects the equation of the profile block in the equations browser, or shows the block if it is a function.
+ * \param block
+ */
+void ProfilingWidget::selectBlock(int block)
+{
+  if (block < 0 || block >= mBlocks.size()) {
+    return;
+  }
+  if (mBlocks[block].equation > 0) {
+    /* also selects the block through TransformationsWidget::fetchEquationData */
+    mpTransformationsWidget->showEquation(mBlocks[block].equation);
+  } else {
+    showProfileBlock(block);
+  }
+}
+
+/*!
+ * \brief ProfilingWidget::updateTopBlocks
+ * Lists the profile blocks with the largest time or the most calls.
+ */
+void ProfilingWidget::updateTopBlocks()
+{
+  mpTopBlocksTreeWidget->clear();
+  QVector<int> blocks(mBlocks.size());
+  QVector<double> keys(mBlocks.size());
+  bool byCalls = mpTopBlocksOrderComboBox->currentIndex() == 1;
+  for (int block = 0 ; block < mBlocks.size() ; block++) {
+    blocks[block] = block;
+    keys[block] = byCalls ? mBlocks[block].ncall : mBlocks[block].time;
+  }
+  int count = qMin(mpTopBlocksCountSpinBox->value(), blocks.size());
+  std::partial_sort(blocks.begin(), blocks.begin() + count, blocks.end(), BlockTimeGreaterThan(keys));
+  QList<QTreeWidgetItem*> items;
+  for (int i = 0 ; i < count ; i++) {
+    const ProfilingBlock &profilingBlock = mBlocks[blocks[i]];
+    QStringList values;
+    values << QString::number(blocks[i])
+           << profilingBlock.name
+           << QString::number(profilingBlock.time, 'g', 3)
+           << QString::number(profilingBlock.ncall)
+           << QString::number(profilingBlock.maxTime, 'g', 3)
+           << (mTotalTime > 0 ? QString::number(100 * profilingBlock.time / mTotalTime, 'g', 3) + "%" : QString());
+    QTreeWidgetItem *pTopBlockTreeItem = new IntegerTreeWidgetItem(values, mpTopBlocksTreeWidget);
+    pTopBlockTreeItem->setToolTip(1, profilingBlock.name);
+    items << pTopBlockTreeItem;
+  }
+  mpTopBlocksTreeWidget->addTopLevelItems(items);
+  mpTopBlocksTreeWidget->sortByColumn(byCalls ? 3 : 2, Qt::DescendingOrder);
+}
+
+void ProfilingWidget::showStep(int step)
+{
+  if (mpStepSpinBox->value() != step) {
+    mpStepSpinBox->setValue(step);  /* calls showStep again */
+    return;
+  }
+  mpTimeSparklineWidget->setMarker(step);
+  mpCallsSparklineWidget->setMarker(step);
+  if (mProfilingData.isOpen() && step < mProfilingData.steps()) {
+    double stepTime = mProfilingData.stepTime(step);
+    mpStepTimeLabel->setText(stepTime < 0 ? tr("time = %1").arg(mProfilingData.time(step))
+                                          : tr("time = %1, step time = %2 s").arg(mProfilingData.time(step)).arg(stepTime, 0, 'g', 3));
+  } else {
+    mpStepTimeLabel->clear();
+  }
+  mpProfilingStepWidget->setStep(&mProfilingData, &mBlocks, step);
+}
+
+void ProfilingWidget::topBlockDoubleClicked(QTreeWidgetItem *pTreeWidgetItem, int column)
+{
+  Q_UNUSED(column);
+  if (pTreeWidgetItem) {
+    selectBlock(pTreeWidgetItem->text(0).toInt());
+  }
+}
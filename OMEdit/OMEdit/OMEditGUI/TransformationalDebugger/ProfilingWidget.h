@@ -0,0 +1,173 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef PROFILINGWIDGET_H
+#define PROFILINGWIDGET_H
+
+#include <QFile>
+#include <QWidget>
+#include <QTreeWidget>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QSplitter>
+
+class TransformationsWidget;
+class Label;
+
+/*!
+ * \brief The ProfilingBlock struct
+ * Aggregated profiling information of a function or an equation from the _prof.json file.
+ */
+struct ProfilingBlock {
+  QString name;
+  int equation; /* equation index, -1 for functions */
+  int parentBlock; /* profile block of the system the equation belongs to, -1 if none */
+  int ncall;
+  double time, maxTime;
+};
+
+/*!
+ * \brief The ProfilingData class
+ * Memory maps the _prof.realdata and _prof.intdata files.
+ * Each file holds one record per step. A record starts with some leading columns (time and step time for the real data)
+ * followed by one column per profile block. The number of leading columns is derived from the file size.
+ */
+class ProfilingData
+{
+public:
+  ProfilingData();
+  ~ProfilingData();
+  bool open(const QString &realFileName, const QString &intFileName, int steps, int blocks);
+  void close();
+  bool isOpen() const {return mpRealData != 0;}
+  bool hasCalls() const {return mpIntData != 0;}
+  int steps() const {return mSteps;}
+  double time(int step) const;
+  double stepTime(int step) const;
+  double blockTime(int step, int block) const {return mpRealData[(qint64)step * mRealColumns + mRealBlocksColumn + block];}
+  quint32 blockCalls(int step, int block) const {return mpIntData[(qint64)step * mIntColumns + mIntBlocksColumn + block];}
+private:
+  QFile mRealFile;
+  QFile mIntFile;
+  const double *mpRealData;
+  const quint32 *mpIntData;
+  int mSteps;
+  int mBlocks;
+  int mRealColumns;
+  int mRealBlocksColumn;
+  int mIntColumns;
+  int mIntBlocksColumn;
+};
+
+class SparklineWidget : public QWidget
+{
+  Q_OBJECT
+public:
+  SparklineWidget(const QString &title, QWidget *pParent = 0);
+  void setValues(const QVector<double> &values);
+  void setMarker(int index);
+  QSize sizeHint() const;
+protected:
+  void paintEvent(QPaintEvent *pEvent);
+  void mousePressEvent(QMouseEvent *pEvent);
+private:
+  QString mTitle;
+  QVector<double> mValues;
+  double mMinimum;
+  double mMaximum;
+  int mMarker;
+signals:
+  void indexClicked(int index);
+};
+
+class ProfilingStepWidget : public QWidget
+{
+  Q_OBJECT
+public:
+  ProfilingStepWidget(QWidget *pParent = 0);
+  void setStep(const ProfilingData *pProfilingData, const QList<ProfilingBlock> *pBlocks, int step);
+  QSize sizeHint() const;
+protected:
+  void paintEvent(QPaintEvent *pEvent);
+  void resizeEvent(QResizeEvent *pEvent);
+  bool event(QEvent *pEvent);
+  void mousePressEvent(QMouseEvent *pEvent);
+private:
+  struct Bar {
+    QRectF rect;
+    int block;
+    double time;
+  };
+  const ProfilingData *mpProfilingData;
+  const QList<ProfilingBlock> *mpBlocks;
+  int mStep;
+  QList<Bar> mBars;
+  QStringList mNames;
+  double mStepTime;
+  void layoutBars();
+  int blockAt(const QPoint &position) const;
+signals:
+  void blockClicked(int block);
+};
+
+class ProfilingWidget : public QWidget
+{
+  Q_OBJECT
+public:
+  ProfilingWidget(TransformationsWidget *pTransformationsWidget);
+  void setProfilingBlocks(const QList<ProfilingBlock> &blocks, double totalTime);
+  bool openProfilingData(const QString &realFileName, const QString &intFileName, int steps);
+  void clearProfiling();
+  void showProfileBlock(int block);
+private:
+  TransformationsWidget *mpTransformationsWidget;
+  ProfilingData mProfilingData;
+  QList<ProfilingBlock> mBlocks;
+  double mTotalTime;
+  int mCurrentBlock;
+  QComboBox *mpTopBlocksOrderComboBox;
+  QSpinBox *mpTopBlocksCountSpinBox;
+  QTreeWidget *mpTopBlocksTreeWidget;
+  Label *mpBlockLabel;
+  SparklineWidget *mpTimeSparklineWidget;
+  SparklineWidget *mpCallsSparklineWidget;
+  QSpinBox *mpStepSpinBox;
+  Label *mpStepTimeLabel;
+  ProfilingStepWidget *mpProfilingStepWidget;
+  QSplitter *mpProfilingSplitter;
+private slots:
+  void updateTopBlocks();
+  void showStep(int step);
+  void selectBlock(int block);
+  void topBlockDoubleClicked(QTreeWidgetItem *pTreeWidgetItem, int column);
+};
+
+#endif // PROFILINGWIDGET_H
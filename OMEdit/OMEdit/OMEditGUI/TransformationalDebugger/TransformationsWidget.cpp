@@ -34,6 +34,7 @@
 
 #include "MainWindow.h"
 #include "TransformationsWidget.h"
+#include "ProfilingWidget.h"
 #include "Options/OptionsDialog.h"
 #include "Util/StringHandler.h"
 #include "Modeling/LibraryTreeWidget.h"
@@ -48,6 +49,8 @@
 #include <QVBoxLayout>
 #include <QMessageBox>
 
+#include <algorithm>
+
 /*!
   \class TVariablesTreeItem
   \brief Contains the information about the result variable.
@@ -450,15 +453,352 @@ EquationTreeWidget::EquationTreeWidget(TransformationsWidget *pTransformationWid
   connect(this, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), mpTransformationWidget, SLOT(fetchEquationData(QTreeWidgetItem*,int)));
 }
 
+/*!
+ * \class EquationTreeModel
+ * \brief A model over the equations of the TransformationsWidget.
+ * Rows are the equation indexes kept in flat vectors. No item is created per equation.
+ * The top level rows are handed to the view in batches through canFetchMore/fetchMore.
+ * The internal id of a QModelIndex is the equation index.
+ */
+/*!
+ * \brief EquationTreeModel::EquationTreeModel
+ * \param equations - the equations of the TransformationsWidget. Index 0 is a dummy and is used as the root.
+ * \param pParent
+ */
+EquationTreeModel::EquationTreeModel(const QList<OMEquation*> &equations, QObject *pParent)
+  : QAbstractItemModel(pParent), mEquations(equations)
+{
+  mFetchedRows = 0;
+  mSortColumn = 0;
+  mSortOrder = Qt::AscendingOrder;
+}
+
+int EquationTreeModel::columnCount(const QModelIndex &parent) const
+{
+  Q_UNUSED(parent);
+  return 7;
+}
+
+int EquationTreeModel::rowCount(const QModelIndex &parent) const
+{
+  if (parent.column() > 0) {
+    return 0;
+  }
+  if (!parent.isValid()) {
+    return mFetchedRows;
+  }
+  return mChildEquationsCount[equationIndex(parent)];
+}
+
+bool EquationTreeModel::hasChildren(const QModelIndex &parent) const
+{
+  if (parent.column() > 0) {
+    return false;
+  }
+  int equation = equationIndex(parent);
+  return equation < mChildEquationsCount.size() && mChildEquationsCount[equation] > 0;
+}
+
+bool EquationTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+  return !parent.isValid() && !mChildEquationsCount.isEmpty() && mFetchedRows < mChildEquationsCount[0];
+}
+
+void EquationTreeModel::fetchMore(const QModelIndex &parent)
+{
+  if (canFetchMore(parent)) {
+    fetchTopLevelRows(qMin(mFetchedRows + 1000, mChildEquationsCount[0]));
+  }
+}
+
+QVariant EquationTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return QVariant();
+  }
+  switch (section) {
+    case 0: return Helper::index;
+    case 1: return Helper::type;
+    case 2: return Helper::equation;
+    case 3: return Helper::executionCount;
+    case 4: return Helper::executionMaxTime;
+    case 5: return Helper::executionTime;
+    case 6: return Helper::executionFraction;
+    default: return QVariant();
+  }
+}
+
+QModelIndex EquationTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+  if (!hasIndex(row, column, parent)) {
+    return QModelIndex();
+  }
+  int equation = mChildEquations[mFirstChildEquation[equationIndex(parent)] + row];
+  return createIndex(row, column, equation);
+}
+
+QModelIndex EquationTreeModel::parent(const QModelIndex &index) const
+{
+  if (!index.isValid()) {
+    return QModelIndex();
+  }
+  int parentEquation = mParentEquations[equationIndex(index)];
+  if (parentEquation <= 0) {
+    return QModelIndex();
+  }
+  return createIndex(mEquationRows[parentEquation], 0, parentEquation);
+}
+
+QVariant EquationTreeModel::data(const QModelIndex &index, int role) const
+{
+  if (!index.isValid()) {
+    return QVariant();
+  }
+  OMEquation *equation = mEquations[equationIndex(index)];
+  if (role == Qt::DisplayRole) {
+    if (index.column() > 2 && equation->profileBlock < 0) {
+      return QVariant();
+    }
+    switch (index.column()) {
+      case 0: return equation->index;
+      case 1: return equation->section;
+      case 2: return equation->toString();
+      case 3: return equation->ncall;
+      case 4: return QString::number(equation->maxTime, 'g', 3);
+      case 5: return QString::number(equation->time, 'g', 3);
+      case 6: return QString::number(100 * equation->fraction, 'g', 3) + "%";
+      default: return QVariant();
+    }
+  } else if (role == Qt::ToolTipRole) {
+    switch (index.column()) {
+      case 0: return QString::number(equation->index);
+      case 1: return equation->section;
+      case 2:
+        return "<html><div style=\"margin:3px;\">" +
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+          equation->toString().toHtmlEscaped()
+#else /* Qt4 */
+          Qt::escape(equation->toString())
+#endif
+          + "</div></html>";
+      case 4: return tr("Maximum execution time in a single step");
+      case 5: return tr("Total time excluding the overhead of measuring.");
+      case 6: return tr("Fraction of time, 100% is the total time of all non-child equations.");
+      default: return QVariant();
+    }
+  }
+  return QVariant();
+}
+
+Qt::ItemFlags EquationTreeModel::flags(const QModelIndex &index) const
+{
+  if (!index.isValid()) {
+    return 0;
+  }
+  return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+/*!
+ * \brief EquationTreeModel::sort
+ * Sorts the top level equations. Nested equations keep the order of their system.
+ * \param column
+ * \param order
+ */
+void EquationTreeModel::sort(int column, Qt::SortOrder order)
+{
+  mSortColumn = column;
+  mSortOrder = order;
+  if (mChildEquationsCount.isEmpty()) {
+    return;
+  }
+  emit layoutAboutToBeChanged();
+  sortTopLevelEquations();
+  /* the internal id is the equation index so only the row of the top level indexes changes */
+  QModelIndexList oldIndexes = persistentIndexList();
+  QModelIndexList newIndexes;
+  foreach (QModelIndex index, oldIndexes) {
+    int equation = equationIndex(index);
+    if (mParentEquations[equation] > 0) {
+      newIndexes << index;
+    } else if (mEquationRows[equation] < mFetchedRows) {
+      newIndexes << createIndex(mEquationRows[equation], index.column(), equation);
+    } else {
+      newIndexes << QModelIndex();
+    }
+  }
+  changePersistentIndexList(oldIndexes, newIndexes);
+  emit layoutChanged();
+}
+
+/*!
+ * \class EquationLessThan
+ * \brief Compares equation indexes by a precomputed key per equation.
+ */
+class EquationLessThan
+{
+public:
+  EquationLessThan(const QVector<double> &numbers, const QVector<QString> &texts, Qt::SortOrder order)
+    : mNumbers(numbers), mTexts(texts), mOrder(order) {}
+  bool operator()(int equation1, int equation2) const
+  {
+    if (mOrder == Qt::DescendingOrder) {
+      qSwap(equation1, equation2);
+    }
+    if (mTexts.isEmpty()) {
+      return mNumbers[equation1] < mNumbers[equation2];
+    }
+    return mTexts[equation1] < mTexts[equation2];
+  }
+private:
+  const QVector<double> &mNumbers;
+  const QVector<QString> &mTexts;
+  Qt::SortOrder mOrder;
+};
+
+void EquationTreeModel::sortTopLevelEquations()
+{
+  int count = mChildEquationsCount[0];
+  QVector<double> numbers;
+  QVector<QString> texts;
+  if (mSortColumn == 1 || mSortColumn == 2) {
+    texts.resize(mEquations.size());
+  } else {
+    numbers.resize(mEquations.size());
+  }
+  for (int row = 0 ; row < count ; row++) {
+    int index = mChildEquations[row];
+    OMEquation *equation = mEquations[index];
+    bool profiled = equation->profileBlock >= 0;
+    switch (mSortColumn) {
+      case 1: texts[index] = equation->section; break;
+      case 2: texts[index] = equation->toString(); break;
+      case 3: numbers[index] = profiled ? equation->ncall : -1; break;
+      case 4: numbers[index] = profiled ? equation->maxTime : -1; break;
+      case 5: numbers[index] = profiled ? equation->time : -1; break;
+      case 6: numbers[index] = profiled ? equation->fraction : -1; break;
+      default: numbers[index] = equation->index; break;
+    }
+  }
+  std::stable_sort(mChildEquations.begin(), mChildEquations.begin() + count, EquationLessThan(numbers, texts, mSortOrder));
+  for (int row = 0 ; row < count ; row++) {
+    mEquationRows[mChildEquations[row]] = row;
+  }
+}
+
+/*!
+ * \brief EquationTreeModel::resetEquations
+ * Builds the tree from the equations. Equations with a parent are only shown below their system.
+ */
+void EquationTreeModel::resetEquations()
+{
+  beginResetModel();
+  int size = mEquations.size();
+  mChildEquations.clear();
+  mChildEquations.reserve(size);
+  mFirstChildEquation.fill(0, size);
+  mChildEquationsCount.fill(0, size);
+  mParentEquations.fill(-1, size);
+  mEquationRows.fill(0, size);
+  mFetchedRows = 0;
+  if (size > 0) {
+    for (int i = 1 ; i < size ; i++) {
+      if (!mEquations[i]->parent) {
+        mParentEquations[i] = 0;
+        mEquationRows[i] = mChildEquations.size();
+        mChildEquations.append(i);
+      }
+    }
+    mChildEquationsCount[0] = mChildEquations.size();
+    /* the children of each equation are stored next to each other; visiting in append order reaches every nesting level */
+    for (int next = 0 ; next < mChildEquations.size() ; next++) {
+      int equation = mChildEquations[next];
+      mFirstChildEquation[equation] = mChildEquations.size();
+      foreach (int nestedEquation, mEquations[equation]->eqs) {
+        if (nestedEquation > 0 && nestedEquation < size && mParentEquations[nestedEquation] < 0) {
+          mParentEquations[nestedEquation] = equation;
+          mEquationRows[nestedEquation] = mChildEquationsCount[equation]++;
+          mChildEquations.append(nestedEquation);
+        }
+      }
+    }
+    sortTopLevelEquations();
+  }
+  endResetModel();
+}
+
+void EquationTreeModel::clearEquations()
+{
+  beginResetModel();
+  mChildEquations.clear();
+  mFirstChildEquation.clear();
+  mChildEquationsCount.clear();
+  mParentEquations.clear();
+  mEquationRows.clear();
+  mFetchedRows = 0;
+  endResetModel();
+}
+
+/*!
+ * \brief EquationTreeModel::equationModelIndex
+ * Returns the model index of the equation. Fetches the top level rows up to the equation if needed.
+ * \param equationIndex
+ * \return
+ */
+QModelIndex EquationTreeModel::equationModelIndex(int equationIndex)
+{
+  if (equationIndex <= 0 || equationIndex >= mParentEquations.size() || mParentEquations[equationIndex] < 0) {
+    return QModelIndex();
+  }
+  int topLevelEquation = equationIndex;
+  while (mParentEquations[topLevelEquation] > 0) {
+    topLevelEquation = mParentEquations[topLevelEquation];
+  }
+  fetchTopLevelRows(mEquationRows[topLevelEquation] + 1);
+  return createIndex(mEquationRows[equationIndex], 0, equationIndex);
+}
+
+void EquationTreeModel::fetchTopLevelRows(int rows)
+{
+  if (rows <= mFetchedRows) {
+    return;
+  }
+  beginInsertRows(QModelIndex(), mFetchedRows, rows - 1);
+  mFetchedRows = rows;
+  endInsertRows();
+}
+
+EquationTreeView::EquationTreeView(EquationTreeModel *pEquationTreeModel, TransformationsWidget *pTransformationsWidget)
+  : QTreeView(pTransformationsWidget), mpTransformationsWidget(pTransformationsWidget)
+{
+  setModel(pEquationTreeModel);
+  setItemDelegate(new ItemDelegate(this));
+  setIndentation(Helper::treeIndentation);
+  setTextElideMode(Qt::ElideMiddle);
+  setUniformRowHeights(true);
+  setSortingEnabled(true);
+  sortByColumn(0, Qt::AscendingOrder);
+  setColumnWidth(0, 55);
+  setColumnWidth(1, 60);
+  setColumnWidth(2, 200);
+  setColumnWidth(3, 55);
+  setColumnWidth(4, 80);
+  setColumnWidth(5, 80);
+  setColumnWidth(6, 60);
+  setExpandsOnDoubleClick(false);
+  connect(this, SIGNAL(doubleClicked(QModelIndex)), mpTransformationsWidget, SLOT(fetchEquationData(QModelIndex)));
+}
+
 TransformationsWidget::TransformationsWidget(QString infoJSONFullFileName, QWidget *pParent)
   : QWidget(pParent), mInfoJSONFullFileName(infoJSONFullFileName)
 {
   if (!mInfoJSONFullFileName.endsWith("_info.json")) {
     mProfJSONFullFileName = "";
     mProfilingDataRealFileName = "";
+    mProfilingDataIntFileName = "";
   } else {
     mProfJSONFullFileName = infoJSONFullFileName.left(infoJSONFullFileName.size() - 9) + "prof.json";
     mProfilingDataRealFileName = infoJSONFullFileName.left(infoJSONFullFileName.size() - 9) + "prof.realdata";
+    mProfilingDataIntFileName = infoJSONFullFileName.left(infoJSONFullFileName.size() - 9) + "prof.intdata";
   }
   mCurrentEquationIndex = 0;
   setWindowIcon(QIcon(":/Resources/icons/equational-debugger.svg"));
@@ -547,14 +887,14 @@ TransformationsWidget::TransformationsWidget(QString infoJSONFullFileName, QWidg
   /* Equations Heading */
   Label *pEquationsBrowserLabel = new Label(tr("Equations Browser"));
   pEquationsBrowserLabel->setObjectName("LabelWithBorder");
-  /* Equations tree widget */
-  mpEquationsTreeWidget = new EquationTreeWidget(this);
-  mpEquationsTreeWidget->setIndentation(Helper::treeIndentation);
+  /* Equations tree view */
+  mpEquationTreeModel = new EquationTreeModel(mEquations, this);
+  mpEquationsTreeView = new EquationTreeView(mpEquationTreeModel, this);
   QGridLayout *pEquationsGridLayout = new QGridLayout;
   pEquationsGridLayout->setSpacing(1);
   pEquationsGridLayout->setContentsMargins(0, 0, 0, 0);
   pEquationsGridLayout->addWidget(pEquationsBrowserLabel, 0, 0);
-  pEquationsGridLayout->addWidget(mpEquationsTreeWidget, 1, 0);
+  pEquationsGridLayout->addWidget(mpEquationsTreeView, 1, 0);
   QFrame *pEquationsFrame = new QFrame;
   pEquationsFrame->setLayout(pEquationsGridLayout);
   /* defines tree widget */
@@ -722,6 +1062,10 @@ TransformationsWidget::TransformationsWidget(QString infoJSONFullFileName, QWidg
   mpTransformationsVerticalSplitter->addWidget(pTSourceEditorFrame);
   mpTransformationsVerticalSplitter->addWidget(pVariablesMainFrame);
   mpTransformationsVerticalSplitter->addWidget(pEquationsMainFrame);
+  /* Profiling */
+  mpProfilingWidget = new ProfilingWidget(this);
+  mpProfilingWidget->hide();
+  mpTransformationsVerticalSplitter->addWidget(mpProfilingWidget);
   /* Load the transformations before setting the layout */
   loadTransformations();
   /* set the layout */
@@ -748,56 +1092,6 @@ TransformationsWidget::TransformationsWidget(QString infoJSONFullFileName, QWidg
   }
 }
 
-static QStringList variantListToStringList(const QVariantList lst)
-{
-  QStringList strs;
-  foreach(QVariant v, lst) {
-    strs << v.toString().trimmed();
-  }
-  return strs;
-}
-
-static OMOperation* variantToOperationPtr(QVariantMap var)
-{
-  QString op = var["op"].toString();
-  QString display = var["display"].toString();
-  QStringList dataStrings = variantListToStringList(var["data"].toList());
-
-  if (op == "before-after") {
-    return new OMOperationBeforeAfter(display != "" ? display : op, dataStrings);
-  } else if (op == "before-after-assert") {
-    return new OMOperationBeforeAfter(display != "" ? display : op, dataStrings);
-  } else if (op == "chain") {
-    QStringList firstLast;
-    firstLast << dataStrings.first() << dataStrings.last();
-    return new OMOperationBeforeAfter(display != "" ? display : op, firstLast);
-  } else if (op == "info") {
-    return new OMOperationInfo(display != "" ? display : op, dataStrings.join(", "));
-  }
-  // "chain"
-  return NULL;
-}
-
-
-static void variantToSource(QVariantMap var, OMInfo &info, QStringList &types, QList<OMOperation*> &ops)
-{
-  Q_UNUSED(types);
-  QVariantMap vinfo = var["info"].toMap();
-  info.file = vinfo["file"].toString();
-  info.lineStart = vinfo["lineStart"].toInt();
-  info.lineEnd = vinfo["lineEnd"].toInt();
-  info.colStart = vinfo["colStart"].toInt();
-  info.colEnd = vinfo["colEnd"].toInt();
-  info.isValid = true;
-  QVariantList vops = var["operations"].toList();
-  foreach (QVariant vop, vops) {
-    OMOperation *op = variantToOperationPtr(vop.toMap());
-    if (op) {
-      ops += op;
-    }
-  }
-}
-
 static OMEquation* getOMEquation(QList<OMEquation*> equations, int index)
 {
   for (int i = 1 ; i < equations.size() ; i++) {
@@ -815,74 +1109,13 @@ void TransformationsWidget::loadTransformations()
   mVariables.clear();
   hasOperationsEnabled = false;
   if (mInfoJSONFullFileName.endsWith(".json")) {
-    QJson::Parser parser;
-    bool ok;
-    QVariantMap result;
-    result = parser.parse(&file, &ok).toMap();
-    if (!ok) {
-      QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::parsingFailedJson), Helper::parsingFailedJson + ": " + mInfoJSONFullFileName, Helper::ok);
+    OMInfoJSONReader infoJSONReader(mVariables, mEquations);
+    if (!infoJSONReader.read(file)) {
+      QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::parsingFailedJson), Helper::parsingFailedJson + ": " + mInfoJSONFullFileName + ": " + infoJSONReader.errorString(), Helper::ok);
       return;
     }
-    QVariantMap vars = result["variables"].toMap();
-    QVariantList eqs = result["equations"].toList();
-    for(QVariantMap::const_iterator iter = vars.begin(); iter != vars.end(); ++iter) {
-      QVariantMap value = iter.value().toMap();
-      OMVariable *var = new OMVariable();
-      var->name = iter.key();
-      var->comment = value["comment"].toString();
-      QVariantMap sourceMap = value["source"].toMap();
-      variantToSource(value["source"].toMap(), var->info, var->types, var->ops);
-      if (!hasOperationsEnabled && sourceMap.contains("operations")) {
-        hasOperationsEnabled = true;
-      }
-      mVariables[iter.key()] = *var;
-    }
+    hasOperationsEnabled = infoJSONReader.hasOperationsEnabled;
     mpTVariablesTreeModel->insertTVariablesItems(mVariables);
-    for (int i=0; i<eqs.size(); i++) {
-      mEquations << new OMEquation();
-    }
-    for (int i=0; i<eqs.size(); i++) {
-      QVariantMap veq = eqs[i].toMap();
-      OMEquation *eq = mEquations[i];
-      eq->section = veq["section"].toString();
-      if (veq["eqIndex"].toInt() != i) {
-        QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::parsingFailedJson), Helper::parsingFailedJson + QString(": got index ") + veq["eqIndex"].toString() + QString(" expected ") + QString::number(i), Helper::ok);
-        return;
-      }
-      eq->index = i;
-      eq->profileBlock = -1;
-      if (veq.find("parent") != veq.end()) {
-        eq->parent = veq["parent"].toInt();
-        mEquations[eq->parent]->eqs << eq->index;
-      } else {
-        eq->parent = 0;
-      }
-      if (veq.find("defines") != veq.end()) {
-        eq->defines = variantListToStringList(veq["defines"].toList());
-        foreach (QString v, eq->defines) {
-          mVariables[v].definedIn << eq->index;
-        }
-      }
-      if (veq.find("uses") != veq.end()) {
-        eq->depends = variantListToStringList(veq["uses"].toList());
-        foreach (QString v, eq->depends) {
-          mVariables[v].usedIn << eq->index;
-        }
-      }
-      eq->text = variantListToStringList(veq["equation"].toList());
-      eq->tag = veq["tag"].toString();
-      if (veq.find("display") != veq.end()) {
-        eq->display = veq["display"].toString();
-      } else {
-        eq->display = eq->tag;
-      }
-      eq->unknowns = veq["unknowns"].toInt();
-      QVariantMap sourceMap = veq["source"].toMap();
-      variantToSource(veq["source"].toMap(), eq->info, eq->types, eq->ops);
-      if (!hasOperationsEnabled && sourceMap.contains("operations")) {
-        hasOperationsEnabled = true;
-      }
-    }
     parseProfiling(mProfJSONFullFileName);
     fetchEquations();
   } else {
@@ -959,79 +1192,31 @@ void TransformationsWidget::fetchOperations(const OMVariable &variable)
   mpVariableOperationsTreeWidget->resizeColumnToContents(0);
 }
 
-QTreeWidgetItem* TransformationsWidget::makeEquationTreeWidgetItem(int equationIndex, int allowChild)
-{
-  OMEquation *equation = mEquations[equationIndex];
-  if (!allowChild && equation->parent) {
-    return NULL; // Only output equations in one position
-  }
-  QStringList values;
-  values << QString::number(equation->index)
-         << equation->section
-         << equation->toString();
-  if (equation->profileBlock >= 0) {
-    values << QString::number(equation->ncall)
-         << QString::number(equation->maxTime, 'g', 3)
-         << QString::number(equation->time, 'g', 3)
-         << QString::number(100 * equation->fraction, 'g', 3) + "%";
-  }
-
-  QTreeWidgetItem *pEquationTreeItem = new IntegerTreeWidgetItem(values, mpEquationsTreeWidget);
-  pEquationTreeItem->setToolTip(0, values[0]);
-  pEquationTreeItem->setToolTip(1, values[1]);
-  pEquationTreeItem->setToolTip(2, "<html><div style=\"margin:3px;\">" +
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
-  QString(values[2]).toHtmlEscaped()
-#else /* Qt4 */
-  Qt::escape(values[2])
-#endif
-  + "</div></html>");
-  pEquationTreeItem->setToolTip(4, "Maximum execution time in a single step");
-  pEquationTreeItem->setToolTip(5, "Total time excluding the overhead of measuring.");
-  pEquationTreeItem->setToolTip(6, "Fraction of time, 100% is the total time of all non-child equations.");
-  return pEquationTreeItem;
-}
-
 void TransformationsWidget::fetchEquations()
 {
-  for (int i = 1 ; i < mEquations.size() ; i++)
-  {
-    QTreeWidgetItem *pEquationTreeItem = makeEquationTreeWidgetItem(i,0);
-    if (pEquationTreeItem) {
-      mpEquationsTreeWidget->addTopLevelItem(pEquationTreeItem);
-      fetchNestedEquations(pEquationTreeItem, i);
-    }
-  }
+  mpEquationTreeModel->resetEquations();
 }
 
-void TransformationsWidget::fetchNestedEquations(QTreeWidgetItem *pParentTreeWidgetItem, int index)
+QModelIndex TransformationsWidget::findEquationModelIndex(int equationIndex)
 {
-  foreach (int nestedIndex, mEquations[index]->eqs)
-  {
-    // OMEquation *nestedEquation = mpInfoXMLFileHandler->equations[nestedIndex];
-    QTreeWidgetItem *pNestedEquationTreeItem = makeEquationTreeWidgetItem(nestedIndex,1);
-    if (pNestedEquationTreeItem) {
-      pParentTreeWidgetItem->addChild(pNestedEquationTreeItem);
-      fetchNestedEquations(pNestedEquationTreeItem, nestedIndex);
-    }
-  }
+  return mpEquationTreeModel->equationModelIndex(equationIndex);
 }
 
-QTreeWidgetItem* TransformationsWidget::findEquationTreeItem(int equationIndex)
+/*!
+ * \brief TransformationsWidget::showEquation
+ * Selects the equation in the equations browser and shows its data.
+ * \param equationIndex
+ */
+void TransformationsWidget::showEquation(int equationIndex)
 {
-  QTreeWidgetItemIterator it(mpEquationsTreeWidget);
-  while (*it)
-  {
-    QTreeWidgetItem *pEquationTreeItem = dynamic_cast<QTreeWidgetItem*>(*it);
-    if (pEquationTreeItem->text(0).toInt() == equationIndex)
-      return pEquationTreeItem;
-    ++it;
+  QModelIndex index = findEquationModelIndex(equationIndex);
+  if (index.isValid()) {
+    mpEquationsTreeView->clearSelection();
+    mpEquationsTreeView->setCurrentIndex(index);
   }
-  return 0;
+  fetchEquationData(equationIndex);
 }
 
-#include <qwt_plot.h>
-
 void TransformationsWidget::fetchEquationData(int equationIndex)
 {
   OMEquation *equation = getOMEquation(mEquations, equationIndex);
@@ -1046,38 +1231,8 @@ void TransformationsWidget::fetchEquationData(int equationIndex)
   /* fetch operations */
   fetchOperations(equation, (HtmlDiff)mpEquationDiffFilterComboBox->itemData(mpEquationDiffFilterComboBox->currentIndex()).toInt());
 
-  /* TODO: This data is correct. Add this to some widget thingy somewhere.
-   * Maybe a small one that you can click to enlarge.
-   * Also add the count one (Model_prof.intdata)
-   */
-#if 0
-  if (equation->profileBlock >= 0) {
-    QFile file(mProfilingDataRealFileName);
-    if (file.open(QIODevice::ReadOnly)) {
-
-      QwtPlot *w;
-      long c1;
-      w = new QwtPlot();
-
-      size_t rowSize = sizeof(double) * profilingNumSteps;
-      file.seek(0);
-      QByteArray datax = file.read(rowSize);
-      file.seek((equation->profileBlock+2) * rowSize);
-      QByteArray datay = file.read(rowSize);
-      double *x = (double*)datax.data();
-      double *y = (double*)datay.data();
-
-      QwtPlotCurve *curve = new QwtPlotCurve("Curve 1");
-
-      curve->setData(x, y, profilingNumSteps);
-      curve->attach(w);
-      w->replot();
-      w->show();
-    }
-  } else {
-    qDebug() << equation->profileBlock;
-  }
-#endif
+  /* show the per step profiling data */
+  mpProfilingWidget->showProfileBlock(equation->profileBlock);
 
   if (!equation->info.isValid) {
     return;
@@ -1210,7 +1365,7 @@ void TransformationsWidget::reloadTransformations()
   mpTreeSearchFilters->getCaseSensitiveCheckBox()->blockSignals(signalsState);
   mpTVariableTreeProxyModel->setFilterRegExp(QRegExp());
   /* clear equations tree */
-  clearTreeWidgetItems(mpEquationsTreeWidget);
+  mpEquationTreeModel->clearEquations();
   /* clear defines in tree */
   clearTreeWidgetItems(mpDefinesVariableTreeWidget);
   /* clear depends tree */
@@ -1222,8 +1377,6 @@ void TransformationsWidget::reloadTransformations()
   mpTSourceEditorFileLabel->hide();
   mpTransformationsEditor->getPlainTextEdit()->clear();
   mpTSourceEditorInfoBar->hide();
-  /* Clear the equations tree. */
-  clearTreeWidgetItems(mpEquationsTreeWidget);
   /* initialize all fields again */
   loadTransformations();
 }
@@ -1294,17 +1447,15 @@ void TransformationsWidget::fetchEquationData(QTreeWidgetItem *pEquationTreeItem
     return;
   }
 
-  int equationIndex = pEquationTreeItem->text(0).toInt();
-  /* if the sender is mpEquationsTreeWidget then there is no need to select the item. */
-  EquationTreeWidget *pSender = qobject_cast<EquationTreeWidget*>(sender());
-  if (pSender != mpEquationsTreeWidget) {
-    QTreeWidgetItem *pTreeWidgetItem = findEquationTreeItem(equationIndex);
-    if (pTreeWidgetItem) {
-      mpEquationsTreeWidget->clearSelection();
-      mpEquationsTreeWidget->setCurrentItem(pTreeWidgetItem);
-    }
+  showEquation(pEquationTreeItem->text(0).toInt());
+}
+
+void TransformationsWidget::fetchEquationData(const QModelIndex &index)
+{
+  if (!index.isValid()) {
+    return;
   }
-  fetchEquationData(equationIndex);
+  fetchEquationData(mpEquationTreeModel->equationIndex(index));
 }
 
 void TransformationsWidget::filterEquationOperations(int index)
@@ -1321,6 +1472,8 @@ void TransformationsWidget::filterEquationOperations(int index)
 
 void TransformationsWidget::parseProfiling(QString fileName)
 {
+  mpProfilingWidget->clearProfiling();
+  mpProfilingWidget->hide();
   QFile *file = new QFile(fileName);
   if (!file->exists()) {
     delete file;
@@ -1333,6 +1486,19 @@ void TransformationsWidget::parseProfiling(QString fileName)
   QVariantList functions = result["functions"].toList();
   QVariantList list = result["profileBlocks"].toList();
   profilingNumSteps = result["numStep"].toInt() + 1; // Initialization is not a step, but part of the file
+  /* profile blocks are numbered functions first, then equations */
+  QList<ProfilingBlock> blocks;
+  foreach (QVariant function, functions) {
+    QVariantMap functionMap = function.toMap();
+    ProfilingBlock block;
+    block.name = functionMap["name"].toString();
+    block.equation = -1;
+    block.parentBlock = -1;
+    block.ncall = functionMap["ncall"].toInt();
+    block.time = functionMap["time"].toDouble();
+    block.maxTime = functionMap["maxTime"].toDouble();
+    blocks << block;
+  }
   for (int i=0; i<list.size(); i++) {
     QVariantMap eq = list[i].toMap();
     long id = eq["id"].toInt();
@@ -1342,6 +1508,28 @@ void TransformationsWidget::parseProfiling(QString fileName)
     mEquations[id]->time = time;
     mEquations[id]->fraction = time / totalStepsTime;
     mEquations[id]->profileBlock = i + functions.size();
+    ProfilingBlock block;
+    block.name = QString("%1 (%2)").arg(id).arg(mEquations[id]->display);
+    block.equation = id;
+    block.parentBlock = -1;
+    block.ncall = mEquations[id]->ncall;
+    block.time = time;
+    block.maxTime = mEquations[id]->maxTime;
+    blocks << block;
+  }
+  /* nest the equation blocks below the closest profiled system they belong to */
+  for (int i = functions.size() ; i < blocks.size() ; i++) {
+    int parent = mEquations[blocks[i].equation]->parent;
+    for (int depth = 0 ; parent > 0 && parent < mEquations.size() && depth < mEquations.size() ; depth++) {
+      if (mEquations[parent]->profileBlock >= 0) {
+        blocks[i].parentBlock = mEquations[parent]->profileBlock;
+        break;
+      }
+      parent = mEquations[parent]->parent;
+    }
   }
+  mpProfilingWidget->setProfilingBlocks(blocks, totalStepsTime);
+  mpProfilingWidget->openProfilingData(mProfilingDataRealFileName, mProfilingDataIntFileName, profilingNumSteps);
+  mpProfilingWidget->show();
   delete file;
 }
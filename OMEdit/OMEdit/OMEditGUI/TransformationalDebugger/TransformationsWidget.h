@@ -153,15 +153,59 @@ private:
   TransformationsWidget *mpTransformationWidget;
 };
 
+class EquationTreeModel : public QAbstractItemModel
+{
+  Q_OBJECT
+public:
+  EquationTreeModel(const QList<OMEquation*> &equations, QObject *pParent = 0);
+  int columnCount(const QModelIndex &parent = QModelIndex()) const;
+  int rowCount(const QModelIndex &parent = QModelIndex()) const;
+  bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+  bool canFetchMore(const QModelIndex &parent) const;
+  void fetchMore(const QModelIndex &parent);
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+  QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+  QModelIndex parent(const QModelIndex &index) const;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+  Qt::ItemFlags flags(const QModelIndex &index) const;
+  void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
+  void resetEquations();
+  void clearEquations();
+  QModelIndex equationModelIndex(int equationIndex);
+  int equationIndex(const QModelIndex &index) const {return index.isValid() ? (int)index.internalId() : 0;}
+private:
+  const QList<OMEquation*> &mEquations;
+  QVector<int> mChildEquations;
+  QVector<int> mFirstChildEquation;
+  QVector<int> mChildEquationsCount;
+  QVector<int> mParentEquations;
+  QVector<int> mEquationRows;
+  int mFetchedRows;
+  int mSortColumn;
+  Qt::SortOrder mSortOrder;
+  void sortTopLevelEquations();
+  void fetchTopLevelRows(int rows);
+};
+
+class EquationTreeView : public QTreeView
+{
+  Q_OBJECT
+public:
+  EquationTreeView(EquationTreeModel *pEquationTreeModel, TransformationsWidget *pTransformationsWidget);
+private:
+  TransformationsWidget *mpTransformationsWidget;
+};
+
 class InfoBar;
 class TransformationsEditor;
+class ProfilingWidget;
 class TransformationsWidget : public QWidget
 {
   Q_OBJECT
 public:
   TransformationsWidget(QString infoJSONFullFileName, QWidget *pParent = 0);
   MyHandler* getInfoXMLFileHandler() {return mpInfoXMLFileHandler;}
-  QTreeWidget* getEquationsTreeWidget() {return mpEquationsTreeWidget;}
+  EquationTreeView* getEquationsTreeView() {return mpEquationsTreeView;}
   InfoBar* getTSourceEditorInfoBar() {return mpTSourceEditorInfoBar;}
   QSplitter* getVariablesNestedHorizontalSplitter() {return mpVariablesNestedHorizontalSplitter;}
   QSplitter* getVariablesNestedVerticalSplitter() {return mpVariablesNestedVerticalSplitter;}
@@ -175,15 +219,15 @@ public:
   void fetchUsedInEquations(const OMVariable &variable);
   void fetchOperations(const OMVariable &variable);
   void fetchEquations();
-  void fetchNestedEquations(QTreeWidgetItem *pParentTreeWidgetItem, int index);
-  QTreeWidgetItem* findEquationTreeItem(int equationIndex);
+  QModelIndex findEquationModelIndex(int equationIndex);
+  void showEquation(int equationIndex);
   void fetchEquationData(int equationIndex);
   void fetchDefines(OMEquation *equation);
   void fetchDepends(OMEquation *equation);
   void fetchOperations(OMEquation *equation, HtmlDiff htmlDiff);
   void clearTreeWidgetItems(QTreeWidget *pTreeWidget);
 private:
-  QString mInfoJSONFullFileName, mProfJSONFullFileName, mProfilingDataRealFileName;
+  QString mInfoJSONFullFileName, mProfJSONFullFileName, mProfilingDataRealFileName, mProfilingDataIntFileName;
   int profilingNumSteps;
   int mCurrentEquationIndex;
   MyHandler *mpInfoXMLFileHandler;
@@ -194,7 +238,8 @@ private:
   EquationTreeWidget *mpDefinedInEquationsTreeWidget;
   EquationTreeWidget *mpUsedInEquationsTreeWidget;
   QTreeWidget *mpVariableOperationsTreeWidget;
-  EquationTreeWidget *mpEquationsTreeWidget;
+  EquationTreeModel *mpEquationTreeModel;
+  EquationTreeView *mpEquationsTreeView;
   QTreeWidget *mpDefinesVariableTreeWidget;
   QTreeWidget *mpDependsVariableTreeWidget;
   QComboBox *mpEquationDiffFilterComboBox;
@@ -209,17 +254,18 @@ private:
   QSplitter *mpEquationsNestedVerticalSplitter;
   QSplitter *mpEquationsHorizontalSplitter;
   QSplitter *mpTransformationsVerticalSplitter;
+  ProfilingWidget *mpProfilingWidget;
   QHash<QString,OMVariable> mVariables;
   QList<OMEquation*> mEquations;
   bool hasOperationsEnabled;
 
   void parseProfiling(QString fileName);
-  QTreeWidgetItem* makeEquationTreeWidgetItem(int equationIndex, int allowChild);
 public slots:
   void reloadTransformations();
   void findVariables();
   void fetchVariableData(const QModelIndex &index);
   void fetchEquationData(QTreeWidgetItem *pEquationTreeItem, int column);
+  void fetchEquationData(const QModelIndex &index);
   void filterEquationOperations(int index);
 };
 
@@ -0,0 +1,211 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ResultColumns.h"
+
+#include <algorithm>
+
+/*!
+ * \class ResultTimeBracket
+ * \brief Rows of a result file around a time point.
+ */
+/*!
+ * \brief ResultTimeBracket::ResultTimeBracket
+ * Creates an invalid bracket.
+ */
+ResultTimeBracket::ResultTimeBracket()
+  : mValid(false), mTime(0.0), mRow1(0), mRow2(0), mWeight1(1.0), mWeight2(0.0)
+{
+}
+
+/*!
+ * \brief ResultTimeBracket::ResultTimeBracket
+ * Binary searches the time vector for the rows around the time point.\n
+ * Events are stored as repeated time points in the result files. The row after the event is used for such time points.
+ * Times outside the simulation interval are clamped to the first or the last row.
+ * \param pTimeValues - the time vector sorted in ascending order.
+ * \param numberOfRows
+ * \param time
+ */
+ResultTimeBracket::ResultTimeBracket(const double *pTimeValues, int numberOfRows, double time)
+  : mValid(false), mTime(time), mRow1(0), mRow2(0), mWeight1(1.0), mWeight2(0.0)
+{
+  if (!pTimeValues || numberOfRows <= 0) {
+    return;
+  }
+  mValid = true;
+  const double *pUpper = std::upper_bound(pTimeValues, pTimeValues + numberOfRows, time);
+  if (pUpper == pTimeValues) {
+    mRow1 = mRow2 = 0;
+  } else if (pUpper == pTimeValues + numberOfRows) {
+    mRow1 = mRow2 = numberOfRows - 1;
+  } else {
+    mRow2 = pUpper - pTimeValues;
+    mRow1 = mRow2 - 1;
+    double interval = pTimeValues[mRow2] - pTimeValues[mRow1];
+    mWeight2 = interval > 0.0 ? (time - pTimeValues[mRow1]) / interval : 0.0;
+    mWeight1 = 1.0 - mWeight2;
+  }
+}
+
+/*!
+ * \class CSVResultColumns
+ * \brief Column accessor for the csv result files.
+ */
+/*!
+ * \brief CSVResultColumns::CSVResultColumns
+ */
+CSVResultColumns::CSVResultColumns()
+  : mpCSVData(0), mpTimeValues(0)
+{
+}
+
+/*!
+ * \brief CSVResultColumns::setCSVData
+ * Resolves all the columns of the csv data. Pass 0 when the csv data is freed.
+ * \param pCSVData
+ */
+void CSVResultColumns::setCSVData(csv_data *pCSVData)
+{
+  mpCSVData = pCSVData;
+  mpTimeValues = 0;
+  mColumns.clear();
+  if (!mpCSVData) {
+    return;
+  }
+  mColumns.reserve(mpCSVData->numvars);
+  for (int i = 0 ; i < mpCSVData->numvars ; i++) {
+    QString name = QString(mpCSVData->variables[i]);
+    if (!mColumns.contains(name)) {
+      mColumns.insert(name, mpCSVData->data + (size_t)i * mpCSVData->numsteps);
+    }
+  }
+  mpTimeValues = getColumn("time");
+}
+
+/*!
+ * \brief CSVResultColumns::getTimeBracket
+ * Returns the rows around the time point.
+ * \param time
+ * \return
+ */
+ResultTimeBracket CSVResultColumns::getTimeBracket(double time) const
+{
+  if (!mpCSVData) {
+    return ResultTimeBracket();
+  }
+  return ResultTimeBracket(mpTimeValues, mpCSVData->numsteps, time);
+}
+
+/*!
+ * \class ResultVariablesPlan
+ * \brief Result variables resolved to their columns.
+ */
+/*!
+ * \brief ResultVariablesPlan::ResultVariablesPlan
+ */
+ResultVariablesPlan::ResultVariablesPlan()
+  : mResultFileId(-1)
+{
+}
+
+/*!
+ * \brief ResultVariablesPlan::clear
+ * Removes all the variables from the plan.
+ */
+void ResultVariablesPlan::clear()
+{
+  mNames.clear();
+  mColumns.clear();
+  mValues.clear();
+  mResultFileId = -1;
+}
+
+/*!
+ * \brief ResultVariablesPlan::addVariable
+ * Adds the variable to the plan. The plan must be resolved again after adding variables.
+ * \param name
+ * \return the index of the variable value.
+ */
+int ResultVariablesPlan::addVariable(const QString &name)
+{
+  mNames.append(name);
+  mColumns.append(0);
+  mValues.append(0.0);
+  mResultFileId = -1;
+  return mNames.size() - 1;
+}
+
+/*!
+ * \brief ResultVariablesPlan::resolve
+ * Resolves the variables to the columns of the result file.\n
+ * Parameters are read once and kept as constant values. Variables missing in the result file read as 0.
+ * \param resultFileId - identifies the opened result file.
+ * \param pMatReader - the mat result file or 0.
+ * \param pCSVResultColumns - the csv result file or 0.
+ */
+void ResultVariablesPlan::resolve(int resultFileId, ModelicaMatReader *pMatReader, const CSVResultColumns *pCSVResultColumns)
+{
+  mResultFileId = resultFileId;
+  for (int i = 0 ; i < mNames.size() ; i++) {
+    mColumns[i] = 0;
+    mValues[i] = 0.0;
+    if (pMatReader) {
+      ModelicaMatVariable_t *pVariable = omc_matlab4_find_var(pMatReader, mNames.at(i).toStdString().c_str());
+      if (pVariable) {
+        if (pVariable->isParam) {
+          omc_matlab4_val(&mValues[i], pMatReader, pVariable, 0.0);
+        } else {
+          mColumns[i] = omc_matlab4_read_vals(pMatReader, pVariable->index);
+        }
+      }
+    } else if (pCSVResultColumns && pCSVResultColumns->isValid()) {
+      mColumns[i] = pCSVResultColumns->getColumn(mNames.at(i));
+    }
+  }
+}
+
+/*!
+ * \brief ResultVariablesPlan::evaluate
+ * Interpolates all the resolved columns at the time bracket.
+ * \param timeBracket
+ */
+void ResultVariablesPlan::evaluate(const ResultTimeBracket &timeBracket)
+{
+  if (!timeBracket.isValid()) {
+    return;
+  }
+  for (int i = 0 ; i < mColumns.size() ; i++) {
+    if (mColumns.at(i)) {
+      mValues[i] = timeBracket.interpolate(mColumns.at(i));
+    }
+  }
+}
@@ -0,0 +1,108 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef RESULTCOLUMNS_H
+#define RESULTCOLUMNS_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "util/read_csv.h"
+#include "util/read_matlab4.h"
+
+/*!
+ * \brief The ResultTimeBracket class
+ * Holds the two rows of a result file around a time point and their linear interpolation weights.
+ * Computing it once per time point allows reading any number of result columns at that time without searching the time vector again.
+ */
+class ResultTimeBracket
+{
+public:
+  ResultTimeBracket();
+  ResultTimeBracket(const double *pTimeValues, int numberOfRows, double time);
+  bool isValid() const {return mValid;}
+  double getTime() const {return mTime;}
+  double interpolate(const double *pValues) const {return mWeight1 * pValues[mRow1] + mWeight2 * pValues[mRow2];}
+private:
+  bool mValid;
+  double mTime;
+  int mRow1;
+  int mRow2;
+  double mWeight1;
+  double mWeight2;
+};
+
+/*!
+ * \brief The CSVResultColumns class
+ * Resolves the column pointers of a csv result file once so that reading a variable doesn't scan all the variable names.
+ * The csv_data is not owned by this class.
+ */
+class CSVResultColumns
+{
+public:
+  CSVResultColumns();
+  void setCSVData(csv_data *pCSVData);
+  bool isValid() const {return mpTimeValues != 0;}
+  const double* getColumn(const QString &name) const {return mColumns.value(name, 0);}
+  ResultTimeBracket getTimeBracket(double time) const;
+private:
+  csv_data *mpCSVData;
+  const double *mpTimeValues;
+  QHash<QString, const double*> mColumns;
+};
+
+/*!
+ * \brief The ResultVariablesPlan class
+ * A list of result variables that are read together for every time point.\n
+ * The variables are resolved to their result columns once per result file so that each frame only interpolates the columns.
+ */
+class ResultVariablesPlan
+{
+public:
+  ResultVariablesPlan();
+  void clear();
+  int addVariable(const QString &name);
+  int size() const {return mNames.size();}
+  const QString& getName(int index) const {return mNames.at(index);}
+  bool isResolvedFor(int resultFileId) const {return mResultFileId == resultFileId;}
+  void resolve(int resultFileId, ModelicaMatReader *pMatReader, const CSVResultColumns *pCSVResultColumns);
+  void evaluate(const ResultTimeBracket &timeBracket);
+  double getValue(int index) const {return mValues.at(index);}
+  void setValue(int index, double value) {mValues[index] = value;}
+private:
+  QVector<QString> mNames;
+  QVector<const double*> mColumns;
+  QVector<double> mValues;
+  int mResultFileId;
+};
+
+#endif // RESULTCOLUMNS_H
@@ -1518,7 +1518,17 @@ QStringList StringHandler::makeVariablePartsWithInd(QString variable)
 
   if (!varParts.isEmpty()) {
 	  QString* lastStr = &(varParts.last());
-	  int i = lastStr->lastIndexOf(QRegExp("\\[\\d+\\]"));
+	  // find the last [digits] part without compiling a QRegExp for every variable
+	  int i = -1;
+	  for (int start = lastStr->lastIndexOf('['); start >= 0 && i < 0; start = start > 0 ? lastStr->lastIndexOf('[', start - 1) : -1) {
+		  int end = start + 1;
+		  while (end < lastStr->size() && lastStr->at(end).isDigit()) {
+			  end++;
+		  }
+		  if (end > start + 1 && end < lastStr->size() && lastStr->at(end) == ']') {
+			  i = start;
+		  }
+	  }
 	  if(i>=0){
 		  QString indexPart = *lastStr;
 		  indexPart.remove(0,i);
@@ -0,0 +1,104 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "Editors/ModelicaEditor.h"
+
+#include <QtTest/QTest>
+#include <QPlainTextEdit>
+#include <QFile>
+
+/*!
+ * \class ModelicaHighlighterBenchmark
+ * \brief Benchmarks ModelicaHighlighter on a large package.mo.
+ */
+class ModelicaHighlighterBenchmark : public QObject
+{
+  Q_OBJECT
+private:
+  QString getPackageText();
+private slots:
+  void highlightPackage();
+};
+
+/*!
+ * \brief ModelicaHighlighterBenchmark::getPackageText
+ * Reads the package.mo given in OMEDIT_BENCHMARK_PACKAGE.
+ * Otherwise generates a package of about 45000 lines with comments, strings, numbers, function calls and annotations.
+ * \return
+ */
+QString ModelicaHighlighterBenchmark::getPackageText()
+{
+  QString fileName = QString::fromLocal8Bit(qgetenv("OMEDIT_BENCHMARK_PACKAGE"));
+  if (!fileName.isEmpty()) {
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly)) {
+      return QString::fromUtf8(file.readAll());
+    }
+    qWarning("Unable to read %s. Using the generated package.", qPrintable(fileName));
+  }
+  QString text = "within;\npackage Benchmark \"Generated package for the highlighter benchmark\"\n";
+  for (int i = 0 ; i < 3000 ; i++) {
+    text.append(QString("  model Model%1 \"Model number %1\"\n"
+                        "    /* parameters of the model\n"
+                        "       spanning two lines */\n"
+                        "    parameter Real k = %2e-3 \"Gain\";\n"
+                        "    Real x(start = 1.0, fixed = true);\n"
+                        "    Modelica.Blocks.Interfaces.RealOutput y \"Output\"\n"
+                        "      annotation (Placement(transformation(extent = {{100, -10}, {120, 10}})));\n"
+                        "  equation\n"
+                        "    der(x) = -k * x + sin(time); // the state\n"
+                        "    y = if x > 0.5 then x else abs(x);\n"
+                        "    annotation (Icon(graphics = {Rectangle(extent = {{-100, 100}, {100, -100}}),\n"
+                        "      Text(extent = {{-100, 20}, {100, -20}}, textString = \"%name\")}),\n"
+                        "      Documentation(info = \"<html><p>Model %1.</p></html>\"));\n"
+                        "  end Model%1;\n\n").arg(i).arg(i % 97));
+  }
+  text.append("end Benchmark;\n");
+  return text;
+}
+
+/*!
+ * \brief ModelicaHighlighterBenchmark::highlightPackage
+ * Highlights all the blocks of the package.
+ */
+void ModelicaHighlighterBenchmark::highlightPackage()
+{
+  QPlainTextEdit plainTextEdit;
+  plainTextEdit.setPlainText(getPackageText());
+  ModelicaHighlighter highlighter(0, &plainTextEdit);
+  QBENCHMARK {
+    highlighter.rehighlight();
+  }
+}
+
+QTEST_MAIN(ModelicaHighlighterBenchmark)
+
+#include "ModelicaHighlighterBenchmark.moc"
@@ -26,7 +26,8 @@ HEADERS += OMPlot.h \
     PlotApplication.h \
     PlotWindowContainer.h \
     PlotMainWindow.h \
-    ScaleDraw.h
+    ScaleDraw.h \
+    ResultFile.h
 
 win32 {
   QMAKE_LFLAGS += -Wl,--enable-auto-import
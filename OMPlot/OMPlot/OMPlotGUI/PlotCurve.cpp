@@ -36,11 +36,316 @@
 #include "qwt_legend_item.h"
 #else
 #include "qwt_painter.h"
+#include "qwt_point_data.h"
 #endif
 #include "qwt_symbol.h"
 
 using namespace OMPlot;
 
+MinMaxPyramid::MinMaxPyramid()
+{
+  clear();
+}
+
+void MinMaxPyramid::clear()
+{
+  mpXData = 0;
+  mpYData = 0;
+  mSize = 0;
+  mIsDecimatable = false;
+  mLevels.clear();
+}
+
+bool MinMaxPyramid::isBuiltFor(const double *xData, const double *yData, int size) const
+{
+  return mpXData == xData && mpYData == yData && mSize == size;
+}
+
+/*!
+ * \brief MinMaxPyramid::build
+ * Builds all the levels of the pyramid. The curve can only be decimated if its x values are increasing.
+ * \param xData
+ * \param yData
+ * \param size
+ */
+void MinMaxPyramid::build(const double *xData, const double *yData, int size)
+{
+  clear();
+  mpXData = xData;
+  mpYData = yData;
+  mSize = size;
+  if (size < 1) {
+    return;
+  }
+  for (int i = 1; i < size; i++) {
+    if (xData[i] < xData[i - 1]) {
+      return;
+    }
+  }
+  mIsDecimatable = true;
+  // level 0 is computed from the samples
+  QVector<int> level(((size + mBaseBucketSize - 1) / mBaseBucketSize) * 2);
+  for (int bucket = 0, first = 0; first < size; bucket++, first += mBaseBucketSize) {
+    const int last = qMin(first + mBaseBucketSize, size);
+    int minIndex = first, maxIndex = first;
+    for (int i = first + 1; i < last; i++) {
+      if (yData[i] < yData[minIndex]) {
+        minIndex = i;
+      }
+      if (yData[i] > yData[maxIndex]) {
+        maxIndex = i;
+      }
+    }
+    level[2 * bucket] = minIndex;
+    level[2 * bucket + 1] = maxIndex;
+  }
+  mLevels.append(level);
+  // every next level merges two buckets of the previous level
+  while (level.size() > 2) {
+    const int previousBuckets = level.size() / 2;
+    QVector<int> nextLevel(((previousBuckets + 1) / 2) * 2);
+    for (int bucket = 0; bucket < nextLevel.size() / 2; bucket++) {
+      int minIndex = level[4 * bucket], maxIndex = level[4 * bucket + 1];
+      if (2 * bucket + 1 < previousBuckets) {
+        if (yData[level[4 * bucket + 2]] < yData[minIndex]) {
+          minIndex = level[4 * bucket + 2];
+        }
+        if (yData[level[4 * bucket + 3]] > yData[maxIndex]) {
+          maxIndex = level[4 * bucket + 3];
+        }
+      }
+      nextLevel[2 * bucket] = minIndex;
+      nextLevel[2 * bucket + 1] = maxIndex;
+    }
+    mLevels.append(nextLevel);
+    level = nextLevel;
+  }
+}
+
+static inline void appendIndex(QVector<int> &indexes, int index)
+{
+  if (indexes.isEmpty() || indexes.last() != index) {
+    indexes.append(index);
+  }
+}
+
+/*!
+ * \brief MinMaxPyramid::getIndexes
+ * Returns the indexes of the samples to draw for the range from-to.\n
+ * Uses the coarsest level whose buckets are not larger than samplesPerBucket.
+ * The first, minimum, maximum and last sample of every bucket are returned in sample order so the drawn polyline
+ * covers the same pixels as the full curve. The partial buckets at the ends of the range are scanned sample by sample,
+ * which costs at most two buckets.
+ * \param from
+ * \param to
+ * \param samplesPerBucket
+ * \param indexes
+ * \return false if the range is not worth decimating.
+ */
+bool MinMaxPyramid::getIndexes(int from, int to, int samplesPerBucket, QVector<int> &indexes) const
+{
+  if (!mIsDecimatable || mLevels.isEmpty() || samplesPerBucket < mBaseBucketSize || from < 0 || to >= mSize || from > to) {
+    return false;
+  }
+  int level = 0;
+  int bucketSize = mBaseBucketSize;
+  while (level + 1 < mLevels.size() && bucketSize * 2 <= samplesPerBucket) {
+    level++;
+    bucketSize *= 2;
+  }
+  const QVector<int> &buckets = mLevels.at(level);
+  indexes.clear();
+  indexes.reserve(4 * ((to - from) / bucketSize + 2));
+  for (int bucket = from / bucketSize; bucket <= to / bucketSize; bucket++) {
+    const int first = qMax(bucket * bucketSize, from);
+    const int last = qMin(bucket * bucketSize + bucketSize - 1, to);
+    int bucketMinIndex = buckets[2 * bucket], bucketMaxIndex = buckets[2 * bucket + 1];
+    // the extrema of the partial buckets at the ends of the range may be outside of it so scan their visible samples.
+    if (first > bucket * bucketSize || last < qMin(bucket * bucketSize + bucketSize, mSize) - 1) {
+      bucketMinIndex = first;
+      bucketMaxIndex = first;
+      for (int i = first + 1; i <= last; i++) {
+        if (mpYData[i] < mpYData[bucketMinIndex]) {
+          bucketMinIndex = i;
+        }
+        if (mpYData[i] > mpYData[bucketMaxIndex]) {
+          bucketMaxIndex = i;
+        }
+      }
+    }
+    appendIndex(indexes, first);
+    appendIndex(indexes, qMin(bucketMinIndex, bucketMaxIndex));
+    appendIndex(indexes, qMax(bucketMinIndex, bucketMaxIndex));
+    appendIndex(indexes, last);
+  }
+  return true;
+}
+
+CurvePointIndex::CurvePointIndex()
+{
+  clear();
+}
+
+void CurvePointIndex::clear()
+{
+  mpXData = 0;
+  mpYData = 0;
+  mSize = 0;
+  mIsIncreasing = false;
+  mGridSize = 0;
+  mGridX = 0;
+  mGridY = 0;
+  mCellWidth = 1;
+  mCellHeight = 1;
+  mCellStarts.clear();
+  mCellPoints.clear();
+}
+
+bool CurvePointIndex::isBuiltFor(const double *xData, const double *yData, int size) const
+{
+  return mpXData == xData && mpYData == yData && mSize == size;
+}
+
+/*!
+ * \brief CurvePointIndex::build
+ * Checks if the x values are increasing. If not then the samples are sorted into a grid of about four samples per cell.
+ * \param xData
+ * \param yData
+ * \param size
+ */
+void CurvePointIndex::build(const double *xData, const double *yData, int size)
+{
+  clear();
+  mpXData = xData;
+  mpYData = yData;
+  mSize = size;
+  if (size < 1) {
+    return;
+  }
+  mIsIncreasing = true;
+  double xMin = xData[0], xMax = xData[0], yMin = yData[0], yMax = yData[0];
+  for (int i = 1; i < size; i++) {
+    if (xData[i] < xData[i - 1]) {
+      mIsIncreasing = false;
+    }
+    xMin = qMin(xMin, xData[i]);
+    xMax = qMax(xMax, xData[i]);
+    yMin = qMin(yMin, yData[i]);
+    yMax = qMax(yMax, yData[i]);
+  }
+  if (mIsIncreasing) {
+    return;
+  }
+  mGridSize = qMax(1, (int)qSqrt(size / 4.0));
+  mGridX = xMin;
+  mGridY = yMin;
+  mCellWidth = xMax > xMin ? (xMax - xMin) / mGridSize : 1.0;
+  mCellHeight = yMax > yMin ? (yMax - yMin) / mGridSize : 1.0;
+  // counting sort of the samples into the cells
+  QVector<int> cells(size);
+  mCellStarts.fill(0, mGridSize * mGridSize + 1);
+  for (int i = 0; i < size; i++) {
+    cells[i] = getCell(yData[i], mGridY, mCellHeight) * mGridSize + getCell(xData[i], mGridX, mCellWidth);
+    mCellStarts[cells[i] + 1]++;
+  }
+  for (int cell = 0; cell < mGridSize * mGridSize; cell++) {
+    mCellStarts[cell + 1] += mCellStarts[cell];
+  }
+  mCellPoints.resize(size);
+  QVector<int> cellEnds = mCellStarts;
+  for (int i = 0; i < size; i++) {
+    mCellPoints[cellEnds[cells[i]]++] = i;
+  }
+}
+
+int CurvePointIndex::getCell(double value, double origin, double cellSize) const
+{
+  const double cell = (value - origin) / cellSize;
+  if (!(cell > 0)) {
+    return 0;
+  }
+  return cell >= mGridSize ? mGridSize - 1 : (int)cell;
+}
+
+void CurvePointIndex::checkPoint(int i, const QPoint &pos, const QwtScaleMap &xMap, const QwtScaleMap &yMap, int &index, double &distance) const
+{
+  const double cx = xMap.transform(mpXData[i]) - pos.x();
+  const double cy = yMap.transform(mpYData[i]) - pos.y();
+  const double f = cx * cx + cy * cy;
+  if (index < 0 || f < distance || (f == distance && i < index)) {
+    index = i;
+    distance = f;
+  }
+}
+
+/*!
+ * \brief CurvePointIndex::closestPoint
+ * Finds the sample closest to pos in canvas coordinates.
+ * \param pos
+ * \param xMap
+ * \param yMap
+ * \param index - set to the index of the closest sample.
+ * \param distance - set to the squared distance in pixels.
+ * \return false if the index can't be used for the scales, e.g., the grid with a logarithmic scale.
+ */
+bool CurvePointIndex::closestPoint(const QPoint &pos, const QwtScaleMap &xMap, const QwtScaleMap &yMap, int &index, double &distance) const
+{
+  index = -1;
+  distance = 0;
+  if (mSize < 1) {
+    return false;
+  }
+  if (mIsIncreasing) {
+    // walk away from the mouse x position in both directions until the x distance alone exceeds the closest sample
+    const int center = std::lower_bound(mpXData, mpXData + mSize, xMap.invTransform(pos.x())) - mpXData;
+    for (int i = center; i < mSize; i++) {
+      const double cx = xMap.transform(mpXData[i]) - pos.x();
+      if (index >= 0 && cx * cx >= distance) {
+        break;
+      }
+      checkPoint(i, pos, xMap, yMap, index, distance);
+    }
+    for (int i = center - 1; i >= 0; i--) {
+      const double cx = xMap.transform(mpXData[i]) - pos.x();
+      if (index >= 0 && cx * cx > distance) {
+        break;
+      }
+      checkPoint(i, pos, xMap, yMap, index, distance);
+    }
+    return true;
+  }
+  if (mGridSize < 1 || xMap.transformation() || yMap.transformation() || xMap.sDist() == 0 || yMap.sDist() == 0) {
+    return false;
+  }
+  // search the rings of cells around the mouse position until no closer sample is possible
+  const int cellX = getCell(xMap.invTransform(pos.x()), mGridX, mCellWidth);
+  const int cellY = getCell(yMap.invTransform(pos.y()), mGridY, mCellHeight);
+  const double cellPixels = qMin(qAbs(xMap.pDist() / xMap.sDist()) * mCellWidth, qAbs(yMap.pDist() / yMap.sDist()) * mCellHeight);
+  for (int ring = 0; ring <= mGridSize; ring++) {
+    const double minDistance = (ring - 1) * cellPixels;
+    if (index >= 0 && ring > 1 && minDistance * minDistance >= distance) {
+      break;
+    }
+    for (int j = qMax(0, cellY - ring); j <= qMin(mGridSize - 1, cellY + ring); j++) {
+      // the rows at the top and bottom of the ring are visited completely, the others only at the left and right
+      const bool fullRow = qAbs(j - cellY) == ring;
+      for (int i = qMax(0, cellX - ring); i <= qMin(mGridSize - 1, cellX + ring); i++) {
+        if (!fullRow && qAbs(i - cellX) != ring) {
+          if (i < cellX + ring) {
+            i = cellX + ring - 1;
+          }
+          continue;
+        }
+        const int cell = j * mGridSize + i;
+        for (int k = mCellStarts[cell]; k < mCellStarts[cell + 1]; k++) {
+          checkPoint(mCellPoints[k], pos, xMap, yMap, index, distance);
+        }
+      }
+    }
+  }
+  return true;
+}
+
 PlotCurve::PlotCurve(QString fileName, QString name, QString xVariableName, QString yVariableName, QString unit, QString displayUnit, Plot *pParent)
   : mCustomColor(false)
 {
@@ -152,6 +457,23 @@ QPair<QVector<double>*, QVector<double>*> PlotCurve::getAxisVectors()
   return qMakePair(&mXAxisVector, &mYAxisVector);
 }
 
+/*!
+ * \brief PlotCurve::setAxisVectors
+ * Copies the curve data in one go. Used when the values come from a result file.
+ * \param xValues
+ * \param yValues
+ * \param size
+ */
+void PlotCurve::setAxisVectors(const double *xValues, const double *yValues, int size)
+{
+  mXAxisVector.resize(size);
+  mYAxisVector.resize(size);
+  if (size > 0) {
+    memcpy(mXAxisVector.data(), xValues, size * sizeof(double));
+    memcpy(mYAxisVector.data(), yValues, size * sizeof(double));
+  }
+}
+
 void PlotCurve::setYAxisVector(QVector<double> vector)
 {
   mYAxisVector = vector;
@@ -240,6 +562,9 @@ void PlotCurve::toggleVisibility()
 
 void PlotCurve::setData(const double* xData, const double* yData, int size)
 {
+  // the values may have been changed in place so rebuild the pyramid and the point index when needed
+  mMinMaxPyramid.clear();
+  mPointIndex.clear();
 #if QWT_VERSION >= 0x060000
   setRawSamples(xData, yData, size);
 #else
@@ -265,6 +590,7 @@ void PlotCurve::updateLegend(QwtLegend *legend) const
  * \brief QwtPlotCurve::closestPoint
  * Reimplentation of QwtPlotCurve::closestPoint()
  * Just doesn't fail if first time f < dmin instead we use the first f value to initialize dmin.
+ * Curves set with setData() are searched with the CurvePointIndex instead of checking every sample.
  * \param pos
  * \param dist
  * \return
@@ -280,6 +606,23 @@ int PlotCurve::closestPoint(const QPoint &pos, double *dist) const
   const QwtScaleMap xMap = plot()->canvasMap(xAxis());
   const QwtScaleMap yMap = plot()->canvasMap(yAxis());
 
+#if QWT_VERSION >= 0x060000
+  const QwtCPointerData *pData = dynamic_cast<const QwtCPointerData*>(series);
+  if (pData) {
+    if (!mPointIndex.isBuiltFor(pData->xData(), pData->yData(), numSamples)) {
+      mPointIndex.build(pData->xData(), pData->yData(), numSamples);
+    }
+    int closestIndex;
+    double closestDistance;
+    if (mPointIndex.closestPoint(pos, xMap, yMap, closestIndex, closestDistance)) {
+      if (dist) {
+        *dist = qSqrt(closestDistance);
+      }
+      return closestIndex;
+    }
+  }
+#endif
+
   int index = -1;
   double dmin = 1.0e10;
 
@@ -301,3 +644,63 @@ int PlotCurve::closestPoint(const QPoint &pos, double *dist) const
 
   return index;
 }
+
+#if QWT_VERSION >= 0x060000
+/*!
+ * \brief PlotCurve::drawSeries
+ * Reimplementation of QwtPlotCurve::drawSeries()
+ * Curves with many more samples than the canvas has pixels are drawn from the min/max pyramid.
+ * The cost of a replot, zoom or pan then depends on the canvas width instead of the number of samples.
+ * \param painter
+ * \param xMap
+ * \param yMap
+ * \param canvasRect
+ * \param from
+ * \param to
+ */
+void PlotCurve::drawSeries(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect, int from, int to) const
+{
+  const QwtCPointerData *pData = dynamic_cast<const QwtCPointerData*>(data());
+  const int numSamples = dataSize();
+  const int canvasWidth = qMax(1, qRound(canvasRect.width()));
+  if (to < 0) {
+    to = numSamples - 1;
+  }
+  // only plain lines are decimated
+  if (!pData || numSamples <= 4 * canvasWidth || style() != QwtPlotCurve::Lines || testCurveAttribute(QwtPlotCurve::Fitted)
+      || brush().style() != Qt::NoBrush || (symbol() && symbol()->style() != QwtSymbol::NoSymbol)) {
+    QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+    return;
+  }
+  if (!mMinMaxPyramid.isBuiltFor(pData->xData(), pData->yData(), numSamples)) {
+    mMinMaxPyramid.build(pData->xData(), pData->yData(), numSamples);
+  }
+  if (!mMinMaxPyramid.isDecimatable()) {
+    QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+    return;
+  }
+  // find the visible samples. Keep one sample on each side so the lines to the canvas borders are drawn.
+  const double *pXData = pData->xData();
+  const double *pYData = pData->yData();
+  const double xMin = qMin(xMap.s1(), xMap.s2());
+  const double xMax = qMax(xMap.s1(), xMap.s2());
+  const int first = std::lower_bound(pXData + from, pXData + to + 1, xMin) - pXData;
+  const int last = std::upper_bound(pXData + first, pXData + to + 1, xMax) - pXData;
+  from = qMax(from, first - 1);
+  to = qMin(to, last);
+  QVector<int> indexes;
+  if (!mMinMaxPyramid.getIndexes(from, to, (to - from + 1) / canvasWidth, indexes)) {
+    QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+    return;
+  }
+  QPolygonF polyline(indexes.size());
+  for (int i = 0; i < indexes.size(); i++) {
+    polyline[i] = QPointF(xMap.transform(pXData[indexes[i]]), yMap.transform(pYData[indexes[i]]));
+  }
+  painter->save();
+  painter->setPen(pen());
+  painter->setRenderHint(QPainter::Antialiasing, testRenderHint(QwtPlotItem::RenderAntialiased));
+  QwtPainter::drawPolyline(painter, polyline);
+  painter->restore();
+}
+#endif
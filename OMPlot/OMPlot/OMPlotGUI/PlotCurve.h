@@ -39,6 +39,61 @@
 
 namespace OMPlot
 {
+/*!
+ * \class MinMaxPyramid
+ * \brief Multi-resolution min/max summary of a curve whose x values are increasing.
+ * Level 0 stores the indexes of the minimum and maximum y value of every mBaseBucketSize samples.
+ * Every next level merges two buckets of the previous level.
+ */
+class MinMaxPyramid
+{
+public:
+  MinMaxPyramid();
+  void clear();
+  bool isBuiltFor(const double *xData, const double *yData, int size) const;
+  void build(const double *xData, const double *yData, int size);
+  bool isDecimatable() const {return mIsDecimatable;}
+  bool getIndexes(int from, int to, int samplesPerBucket, QVector<int> &indexes) const;
+private:
+  static const int mBaseBucketSize = 4;
+  const double *mpXData;
+  const double *mpYData;
+  int mSize;
+  bool mIsDecimatable;
+  QVector<QVector<int> > mLevels;
+};
+
+/*!
+ * \class CurvePointIndex
+ * \brief Index of the curve samples for finding the sample closest to the mouse.
+ * Curves with increasing x values are searched with a binary search on x.
+ * Other curves, e.g., parametric curves, are indexed with a uniform grid over their bounding rectangle.
+ */
+class CurvePointIndex
+{
+public:
+  CurvePointIndex();
+  void clear();
+  bool isBuiltFor(const double *xData, const double *yData, int size) const;
+  void build(const double *xData, const double *yData, int size);
+  bool closestPoint(const QPoint &pos, const QwtScaleMap &xMap, const QwtScaleMap &yMap, int &index, double &distance) const;
+private:
+  const double *mpXData;
+  const double *mpYData;
+  int mSize;
+  bool mIsIncreasing;
+  int mGridSize;
+  double mGridX;
+  double mGridY;
+  double mCellWidth;
+  double mCellHeight;
+  QVector<int> mCellStarts;
+  QVector<int> mCellPoints;
+
+  int getCell(double value, double origin, double cellSize) const;
+  void checkPoint(int i, const QPoint &pos, const QwtScaleMap &xMap, const QwtScaleMap &yMap, int &index, double &distance) const;
+};
+
 class PlotCurve : public QwtPlotCurve
 {
 private:
@@ -55,6 +110,8 @@ private:
 
   Plot *mpParentPlot;
   QwtPlotDirectPainter *mpPlotDirectPainter;
+  mutable MinMaxPyramid mMinMaxPyramid;
+  mutable CurvePointIndex mPointIndex;
 public:
   PlotCurve(QString fileName, QString name, QString xVariableName, QString yVariableName, QString unit, QString displayUnit, Plot *pParent);
   ~PlotCurve();
@@ -78,6 +135,7 @@ public:
   void updateXAxisValue(int index, double value);
   const double* getXAxisVector() const;
   QPair<QVector<double>*, QVector<double>*> getAxisVectors();
+  void setAxisVectors(const double *xValues, const double *yValues, int size);
   void clearXAxisVector() {mXAxisVector.clear();}
   void setYAxisVector(QVector<double> vector);
   void addYAxisValue(double value);
@@ -103,6 +161,9 @@ public:
   virtual void updateLegend(QwtLegend *legend) const;
 #endif
   virtual int closestPoint(const QPoint &pos, double *dist = NULL) const;
+#if QWT_VERSION >= 0x060000
+  virtual void drawSeries(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect, int from, int to) const;
+#endif
 };
 }
 
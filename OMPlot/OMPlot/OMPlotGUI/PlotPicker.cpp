@@ -116,7 +116,7 @@ bool PlotPicker::curveAtPosition(const QPoint pos, PlotCurve *&pPlotCurve, int &
         int index1, previousIndex, nextIndex;
         if (index == 0) {
           index1 = 1;
-        } else if (index == pPlotCurve->mXAxisVector.size()) {
+        } else if (index == pPlotCurve->mXAxisVector.size() - 1) {
           index1 = index - 1;
         } else {
           previousIndex = index - 1;
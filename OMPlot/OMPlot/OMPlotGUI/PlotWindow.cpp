@@ -43,7 +43,7 @@
 using namespace OMPlot;
 
 PlotWindow::PlotWindow(QStringList arguments, QWidget *parent, bool isInteractiveSimulation)
-  : QMainWindow(parent), mIsInteractiveSimulation(isInteractiveSimulation)
+  : QMainWindow(parent), mIsInteractiveSimulation(isInteractiveSimulation), mArrayResultsFileSize(0)
 {
   /* set the widget background white. so that the plot is more useable in books and publications. */
   QPalette p(palette());
@@ -170,6 +170,24 @@ void PlotWindow::initializeFile(QString file)
   }
 }
 
+/*!
+ * \brief PlotWindow::getResultFile
+ * Returns the shared parsed result file of mFile. The file is parsed again only if it has changed on disk.
+ * \return
+ */
+ResultFile* PlotWindow::getResultFile()
+{
+  QString fileName = QFileInfo(mFile).absoluteFilePath();
+  if (!mpResultFile || mpResultFile->getFileName() != fileName || !mpResultFile->isUpToDate()) {
+    QString errorString;
+    mpResultFile = ResultFile::open(fileName, &errorString);
+    if (!mpResultFile) {
+      throw PlotException(errorString);
+    }
+  }
+  return mpResultFile.data();
+}
+
 void PlotWindow::getStartStopTime(double &start, double &stop){
   //PLOT PLT
   if (mFile.fileName().endsWith("plt"))
@@ -221,39 +239,23 @@ void PlotWindow::getStartStopTime(double &start, double &stop){
   else if (mFile.fileName().endsWith("csv"))
   {
     /* open the file */
-    struct csv_data *csvReader;
-    csvReader = read_csv(mFile.fileName().toStdString().c_str());
-    if (csvReader == NULL) {
-      throw NoVariableException("Variable doesnt exist: time");
-    }
+    struct csv_data *csvReader = getResultFile()->getCSVData();
     //Read in timevector
     double *timeVals = read_csv_dataset(csvReader, "time");
     if (timeVals == NULL) {
-      omc_free_csv_reader(csvReader);
       throw NoVariableException("Variable doesnt exist: time");
     }
     start = timeVals[0];
     stop = timeVals[csvReader->numsteps-1];
-
-    // close the file
-    omc_free_csv_reader(csvReader);
   }
   //PLOT MAT
   else if(mFile.fileName().endsWith("mat"))
   {
-    ModelicaMatReader reader;
-    const char *msg = "";
-    //Read in mat file
-    if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader))) {
-      throw PlotException(msg);
-    }
+    ModelicaMatReader &reader = *getResultFile()->getMatReader();
 
     //Read in timevector
     start = omc_matlab4_startTime(&reader);
     stop =  omc_matlab4_stopTime(&reader);
-
-    // close the file
-    omc_free_matlab4_reader(&reader);
   } else {throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));}
 }
 
@@ -372,6 +374,12 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
     throw NoVariableException(QString("No variables specified!").toStdString().c_str());
 
   bool editCase = pPlotCurve ? true : false;
+  bool plotAll = getPlotType() == PlotWindow::PLOTALL;
+  QSet<QString> variablesSet;
+  foreach (const QString &variable, mVariablesList) {
+    variablesSet.insert(variable);
+  }
+  QStringList variablesPlotted;
   //PLOT PLT
   if (mFile.fileName().endsWith("plt"))
   {
@@ -390,7 +398,7 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
       }
     }
 
-    QStringList variablesPlotted;
+    QVector<double> xValues(intervalSize), yValues(intervalSize);
     // Read variable values and plot them
     while (!mpTextStream->atEnd())
     {
@@ -399,38 +407,30 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
       if (currentLine.contains("DataSet:"))
       {
         currentVariable = currentLine.remove("DataSet: ");
-        if (mVariablesList.contains(currentVariable) or getPlotType() == PlotWindow::PLOTALL)
+        if (plotAll || variablesSet.remove(currentVariable))
         {
           variablesPlotted.append(currentVariable);
           if (!editCase) {
             pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), currentVariable, "time", currentVariable, getUnit(), getDisplayUnit(), mpPlot);
             mpPlot->addPlotCurve(pPlotCurve);
           }
-          // clear previous curve data
-          pPlotCurve->clearXAxisVector();
-          pPlotCurve->clearYAxisVector();
           // read the variable values now
-          currentLine = mpTextStream->readLine();
           for(int j = 0; j < intervalSize; j++)
           {
-            QStringList values = currentLine.split(",");
-            pPlotCurve->addXAxisValue(QString(values[0]).toDouble());
-            pPlotCurve->addYAxisValue(QString(values[1]).toDouble());
             currentLine = mpTextStream->readLine();
+            int separator = currentLine.indexOf(',');
+            xValues[j] = currentLine.left(separator).toDouble();
+            yValues[j] = currentLine.mid(separator + 1).toDouble();
           }
+          pPlotCurve->setAxisVectors(xValues.constData(), yValues.constData(), intervalSize);
           pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
           pPlotCurve->attach(mpPlot);
-          mpPlot->replot();
         }
         // if plottype is PLOT and we have read all the variable we need to plot then simply break the loop
-        if (getPlotType() == PlotWindow::PLOT)
-          if (mVariablesList.size() == variablesPlotted.size())
-            break;
+        if (getPlotType() == PlotWindow::PLOT && variablesSet.isEmpty())
+          break;
       }
     }
-    // if plottype is PLOT then check which requested variables are not found in the file
-    if (getPlotType() == PlotWindow::PLOT)
-      checkForErrors(mVariablesList, variablesPlotted);
     // close the file
     mFile.close();
   }
@@ -438,11 +438,7 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
   else if (mFile.fileName().endsWith("csv"))
   {
     /* open the file */
-    QStringList variablesPlotted;
-    struct csv_data *csvReader;
-    csvReader = read_csv(mFile.fileName().toStdString().c_str());
-    if (csvReader == NULL)
-      throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+    struct csv_data *csvReader = getResultFile()->getCSVData();
 
     //Read in timevector
     double *timeVals = read_csv_dataset(csvReader, "time");
@@ -451,129 +447,94 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
       timeVals = read_csv_dataset(csvReader, "lambda");
       if (timeVals == NULL)
       {
-        omc_free_csv_reader(csvReader);
         throw NoVariableException(tr("Variable doesnt exist: %1").arg("time or lambda").toStdString().c_str());
       }
       setXLabel("lambda");
     }
 
-    // read in all values
+    // read in all values. The values of the variables are stored one after the other.
     for (int i = 0; i < csvReader->numvars; i++)
     {
-      if (mVariablesList.contains(csvReader->variables[i]) or getPlotType() == PlotWindow::PLOTALL)
+      if (plotAll || variablesSet.remove(csvReader->variables[i]))
       {
         variablesPlotted.append(csvReader->variables[i]);
-        double *vals = read_csv_dataset(csvReader, csvReader->variables[i]);
-        if (vals == NULL)
-        {
-          omc_free_csv_reader(csvReader);
-          throw NoVariableException(tr("Variable doesnt exist: %1").arg(csvReader->variables[i]).toStdString().c_str());
-        }
-
+        double *vals = csvReader->data + (size_t)i * csvReader->numsteps;
         if (!editCase) {
           pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), csvReader->variables[i], "time", csvReader->variables[i], getUnit(), getDisplayUnit(), mpPlot);
           mpPlot->addPlotCurve(pPlotCurve);
         }
-        // clear previous curve data
-        pPlotCurve->clearXAxisVector();
-        pPlotCurve->clearYAxisVector();
-        for (int i = 0 ; i < csvReader->numsteps ; i++)
-        {
-          pPlotCurve->addXAxisValue(timeVals[i]);
-          pPlotCurve->addYAxisValue(vals[i]);
-        }
+        pPlotCurve->setAxisVectors(timeVals, vals, csvReader->numsteps);
         pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
         pPlotCurve->attach(mpPlot);
-        mpPlot->replot();
       }
     }
-    // if plottype is PLOT then check which requested variables are not found in the file
-    if (getPlotType() == PlotWindow::PLOT)
-      checkForErrors(mVariablesList, variablesPlotted);
-    // close the file
-    omc_free_csv_reader(csvReader);
   }
   //PLOT MAT
   else if(mFile.fileName().endsWith("mat"))
   {
-    ModelicaMatReader reader;
-    ModelicaMatVariable_t *var;
-    const char *msg = "";
-    QStringList variablesPlotted;
+    ModelicaMatReader &reader = *getResultFile()->getMatReader();
 
-    //Read in mat file
-    if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader))) {
-      throw PlotException(msg);
-    }
     //Read in timevector
     double startTime = omc_matlab4_startTime(&reader);
     double stopTime =  omc_matlab4_stopTime(&reader);
     if (reader.nvar < 1) {
-      omc_free_matlab4_reader(&reader);
       throw NoVariableException("Variable doesnt exist: time");
     }
     double *timeVals = omc_matlab4_read_vals(&reader,1);
     if (!timeVals) {
-      omc_free_matlab4_reader(&reader);
       throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
     }
-    // read in all values
-    for (int i = 0; i < reader.nall; i++) {
-      if (mVariablesList.contains(reader.allInfo[i].name) or getPlotType() == PlotWindow::PLOTALL) {
+    // collect the variables to plot. Either all the variables in file order or the requested ones found by binary search.
+    QVector<ModelicaMatVariable_t*> variables;
+    if (plotAll) {
+      variables.reserve(reader.nall);
+      for (int i = 0; i < reader.nall; i++) {
+        variables.append(&reader.allInfo[i]);
         variablesPlotted.append(reader.allInfo[i].name);
-        // create the plot curve for variable
-        if (!editCase) {
-          pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), reader.allInfo[i].name, "time", reader.allInfo[i].name, getUnit(), getDisplayUnit(), mpPlot);
-          mpPlot->addPlotCurve(pPlotCurve);
+      }
+    } else {
+      variables.reserve(mVariablesList.size());
+      foreach (const QString &variable, mVariablesList) {
+        ModelicaMatVariable_t *var = omc_matlab4_find_var(&reader, variable.toStdString().c_str());
+        if (var && variablesSet.remove(variable)) {
+          variables.append(var);
+          variablesPlotted.append(variable);
         }
-        // read the variable values
-        var = omc_matlab4_find_var(&reader, reader.allInfo[i].name);
-        if (!var) {
-          omc_free_matlab4_reader(&reader);
-          throw NoVariableException(QString("Variable doesn't exist : ").append(reader.allInfo[i].name).toStdString().c_str());
+      }
+    }
+    // read in all values
+    for (int i = 0; i < variables.size(); i++) {
+      ModelicaMatVariable_t *var = variables.at(i);
+      // create the plot curve for variable
+      if (!editCase) {
+        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), variablesPlotted.at(i), "time", variablesPlotted.at(i), getUnit(), getDisplayUnit(), mpPlot);
+        mpPlot->addPlotCurve(pPlotCurve);
+      }
+      // if variable is not a parameter then
+      if (!var->isParam) {
+        double *vals = omc_matlab4_read_vals(&reader,var->index);
+        if (!vals) {
+          throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
         }
-        // clear previous curve data
-        pPlotCurve->clearXAxisVector();
-        pPlotCurve->clearYAxisVector();
-        // if variable is not a parameter then
-        if (!var->isParam) {
-          double *vals = omc_matlab4_read_vals(&reader,var->index);
-          if (!vals) {
-            omc_free_matlab4_reader(&reader);
-            throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
-          }
-          // set plot curve data and attach it to plot
-          for (int i = 0 ; i < reader.nrows ; i++) {
-            pPlotCurve->addXAxisValue(timeVals[i]);
-            pPlotCurve->addYAxisValue(vals[i]);
-          }
-          pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
-          pPlotCurve->attach(mpPlot);
-          mpPlot->replot();
-        } else { // if variable is a parameter then
-          double val;
-          if (omc_matlab4_val(&val,&reader,var,0.0)) {
-            omc_free_matlab4_reader(&reader);
-            throw NoVariableException(QString("Parameter doesn't have a value : ").append(reader.allInfo[i].name).toStdString().c_str());
-          }
-
-          pPlotCurve->addXAxisValue(startTime);
-          pPlotCurve->addYAxisValue(val);
-          pPlotCurve->addXAxisValue(stopTime);
-          pPlotCurve->addYAxisValue(val);
-          pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(),
-                              pPlotCurve->getSize());
-          pPlotCurve->attach(mpPlot);
-          mpPlot->replot();
+        // set plot curve data
+        pPlotCurve->setAxisVectors(timeVals, vals, reader.nrows);
+      } else { // if variable is a parameter then
+        double val;
+        if (omc_matlab4_val(&val,&reader,var,0.0)) {
+          throw NoVariableException(QString("Parameter doesn't have a value : ").append(variablesPlotted.at(i)).toStdString().c_str());
         }
+        const double xValues[] = {startTime, stopTime};
+        const double yValues[] = {val, val};
+        pPlotCurve->setAxisVectors(xValues, yValues, 2);
       }
+      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+      pPlotCurve->attach(mpPlot);
     }
-    // if plottype is PLOT then check which requested variables are not found in the file
-    if (getPlotType() == PlotWindow::PLOT)
-      checkForErrors(mVariablesList, variablesPlotted);
-    // close the file
-    omc_free_matlab4_reader(&reader);
   }
+  mpPlot->replot();
+  // if plottype is PLOT then check which requested variables are not found in the file
+  if (getPlotType() == PlotWindow::PLOT)
+    checkForErrors(mVariablesList, variablesPlotted);
 }
 
 void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
@@ -686,10 +647,7 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
     {
       /* open the file */
       QStringList variablesPlotted;
-      struct csv_data *csvReader;
-      csvReader = read_csv(mFile.fileName().toStdString().c_str());
-      if (csvReader == NULL)
-        throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+      struct csv_data *csvReader = getResultFile()->getCSVData();
 
       double *xVals = NULL, *yVals = NULL;
       // read in all values
@@ -700,7 +658,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
           variablesPlotted.append(csvReader->variables[i]);
           xVals = read_csv_dataset(csvReader, csvReader->variables[i]);
           if (xVals == NULL) {
-            omc_free_csv_reader(csvReader);
             throw NoVariableException(tr("Variable doesnt exist: %1").arg(csvReader->variables[i]).toStdString().c_str());
           }
         }
@@ -709,7 +666,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
           variablesPlotted.append(csvReader->variables[i]);
           yVals = read_csv_dataset(csvReader, csvReader->variables[i]);
           if (yVals == NULL) {
-            omc_free_csv_reader(csvReader);
             throw NoVariableException(tr("Variable doesnt exist: %1").arg(csvReader->variables[i]).toStdString().c_str());
           }
         }
@@ -722,32 +678,19 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
         mpPlot->addPlotCurve(pPlotCurve);
       }
       // clear previous curve data
-      pPlotCurve->clearXAxisVector();
-      pPlotCurve->clearYAxisVector();
-      for (int i = 0 ; i < csvReader->numsteps ; i++)
-      {
-        pPlotCurve->addXAxisValue(xVals[i]);
-        pPlotCurve->addYAxisValue(yVals[i]);
-      }
+      pPlotCurve->setAxisVectors(xVals, yVals, csvReader->numsteps);
       pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
       pPlotCurve->attach(mpPlot);
       mpPlot->replot();
       // check which requested variables are not found in the file
       checkForErrors(mVariablesList, variablesPlotted);
-      // close the file
-      omc_free_csv_reader(csvReader);
     }
     //PLOT MAT
     else if(mFile.fileName().endsWith("mat"))
     {
       //Declare variables
-      ModelicaMatReader reader;
+      ModelicaMatReader &reader = *getResultFile()->getMatReader();
       ModelicaMatVariable_t *var;
-      const char *msg = "";
-
-      //Read the .mat file
-      if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader)))
-        throw PlotException(msg);
 
       if (!editCase) {
         pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), yVariable + " vs " + xVariable, xVariable, yVariable, getUnit(), getDisplayUnit(), mpPlot);
@@ -758,7 +701,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       //Fill variable x with data
       var = omc_matlab4_find_var(&reader, xVariable.toStdString().c_str());
       if (!var) {
-        omc_free_matlab4_reader(&reader);
         throw NoVariableException(QString("Variable doesn't exist : ").append(xVariable).toStdString().c_str());
       }
       // clear previous curve data
@@ -769,7 +711,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double *xVals = omc_matlab4_read_vals(&reader,var->index);
         if (!xVals) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
         }
         for (int i = 0 ; i < reader.nrows ; i++)
@@ -780,7 +721,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double xval;
         if (omc_matlab4_val(&xval,&reader,var,0.0)) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Parameter doesn't have a value : ").append(xVariable).toStdString().c_str());
         }
         pPlotCurve->addYAxisValue(xval);
@@ -788,7 +728,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       //Fill variable y with data
       var = omc_matlab4_find_var(&reader, yVariable.toStdString().c_str());
       if (!var) {
-        omc_free_matlab4_reader(&reader);
         throw NoVariableException(QString("Variable doesn't exist : ").append(yVariable).toStdString().c_str());
       }
       // if variable is not a parameter then
@@ -796,7 +735,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double *yVals = omc_matlab4_read_vals(&reader,var->index);
         if (!yVals) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
         }
         for (int i = 0 ; i < reader.nrows ; i++)
@@ -807,7 +745,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double yval;
         if (omc_matlab4_val(&yval,&reader,var,0.0)) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Parameter doesn't have a value : ").append(yVariable).toStdString().c_str());
         }
         pPlotCurve->addYAxisValue(yval);
@@ -815,7 +752,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
       pPlotCurve->attach(mpPlot);
       mpPlot->replot();
-      omc_free_matlab4_reader(&reader);
     }
   }
 }
@@ -862,263 +798,272 @@ int readPLTDataset(QTextStream *mpTextStream, QString variable, int N, double* v
   return 0;
 }
 
-void readPLTArray(QTextStream *mpTextStream, QString variable, double alpha, int intervalSize, int it, QList<double> &arrLstOut){
-  int index = 1;
-  double vals[intervalSize];
-  do  //loop over all indexes
-  {
-    //read the values
-    QString variableWithInd = variable;
-    if (QRegExp("der\\(\\D(\\w)*\\)").exactMatch(variableWithInd)){
-      variableWithInd.chop(1);
-      variableWithInd.append("["+QString::number(index)+"])");
-    } else {
-      variableWithInd.append("["+QString::number(index)+"]");
-    }
-    if (readPLTDataset(mpTextStream, variableWithInd, intervalSize, vals)){
-      if (index == 1)
-        throw NoVariableException(QObject::tr("Array variable doesnt exist: %1").arg(variable).toStdString().c_str());
-      else
-        break;
-    }
-    if (it == 0)
-      arrLstOut.push_back(vals[0]);
-    else
-      arrLstOut.push_back(alpha*vals[it-1] + (1-alpha)*vals[it]);
-    index++;
-  } while(true);
-  return;
-}
-
-double getTimeUnitFactor(QString timeUnit){
-  if (timeUnit == "ms") return 1000.0;
-  else if (timeUnit == "s") return 1.0;
-  else if (timeUnit == "min") return 1.0/6.0;
-  else if (timeUnit == "h") return 1.0/3600.0;
-  else if (timeUnit == "d") return 1.0/86400.0;
-  else throw PlotException(QObject::tr("Unknown unit in plotArray(Parametric)."));
-}
-
-void PlotWindow::updateTimeText(QString unit)
+/*!
+ * \brief getArrayElementName
+ * Returns the name of the array element at index, e.g., x[2] for x and der(x[2]) for der(x).
+ * \param variable
+ * \param index
+ * \return
+ */
+static QString getArrayElementName(QString variable, int index)
 {
-  double timeUnitFactor = getTimeUnitFactor(unit);
-  mpPlot->setFooter(QString("t = %1 " + unit).arg(getTime()*timeUnitFactor,0,'g',3));
-  mpPlot->replot();
+  if (QRegExp("der\\(\\D(\\w)*\\)").exactMatch(variable)) {
+    variable.chop(1);
+    variable.append("[" + QString::number(index) + "])");
+  } else {
+    variable.append("[" + QString::number(index) + "]");
+  }
+  return variable;
 }
 
-void PlotWindow::plotArray(double timePercent, PlotCurve *pPlotCurve)
+/*!
+ * \brief PlotWindow::updateArrayResults
+ * Reads the time vector of the result file used by the array plots.\n
+ * The array values read so far are kept until the result file changes on disk.
+ */
+void PlotWindow::updateArrayResults()
 {
-  double *res;
-  QString currentLine;
-  double time;
-  double timeUnitFactor = getTimeUnitFactor(getTimeUnit());
-  if (mVariablesList.isEmpty() and getPlotType() == PlotWindow::PLOTARRAY)
-    throw NoVariableException(QString("No variables specified!").toStdString().c_str());
-  bool editCase = pPlotCurve ? true : false;
+  QFileInfo fileInfo(mFile);
+  if (!mArrayTimeVector.isEmpty() && mArrayResultsFileName == fileInfo.absoluteFilePath()
+      && mArrayResultsLastModified == fileInfo.lastModified() && mArrayResultsFileSize == fileInfo.size()) {
+    return;
+  }
+  mArrayTimeVector.clear();
+  mArrayResults.clear();
   //PLOT PLT
-  //we presume time is the first dataset and array elements datasets are consequent
-  if (mFile.fileName().endsWith("plt"))
-  {
-    /* open the file */
-    if (!mFile.open(QIODevice::ReadOnly))
+  if (mFile.fileName().endsWith("plt")) {
+    if (!mFile.open(QIODevice::ReadOnly)) {
       throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
-    mpTextStream = new QTextStream(&mFile);
+    }
+    QTextStream textStream(&mFile);
     // read the interval size from the file
     int intervalSize = -1;
-    while (!mpTextStream->atEnd())
-    {
-      currentLine = mpTextStream->readLine();
-      if (currentLine.startsWith("#IntervalSize"))
-      {
+    while (!textStream.atEnd()) {
+      QString currentLine = textStream.readLine();
+      if (currentLine.startsWith("#IntervalSize")) {
         intervalSize = static_cast<QString>(currentLine.split("=").last()).toInt();
         break;
       }
     }
-    if (intervalSize == -1) {
-      mFile.close();
-      throw PlotException(tr("Interval size not specified.").toStdString().c_str());
-    }
-    //    double vals[intervalSize];
-    //Read in timevector
-    double timeVals[intervalSize];
-    readPLTDataset(mpTextStream, "time", intervalSize, timeVals);
-    //calculate time
-    double startTime = timeVals[0];
-    double stopTime = timeVals[intervalSize-1];
-    time = startTime + (stopTime - startTime)*timePercent/100.0;
-    setTime(time);
-    //Find indexes and alpha to interpolate data in particular time
-    double alpha;
-    int it = setupInterp(timeVals, time, intervalSize, alpha);
-    if (it < 0) {
+    if (intervalSize < 1) {
       mFile.close();
-      throw PlotException("Time out of bounds.");
+      throw PlotException(tr("Interval size not specified."));
     }
-    QString currentVariable;  //without index part
-    // Read variable values and plot them
-    for (QStringList::Iterator itVarList = mVariablesList.begin(); itVarList != mVariablesList.end(); itVarList++){ //loop over all variables to be plotted
-      currentVariable = *(itVarList);
-      if (editCase)
-      {
-        // clear previous curve data
-        pPlotCurve->clearXAxisVector();
-        pPlotCurve->clearYAxisVector();
-      } else {
-        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), currentVariable, "array index", currentVariable, getUnit(), getDisplayUnit(), mpPlot);
-        mpPlot->addPlotCurve(pPlotCurve);
-      }
-      QList<double> arrLst;
-      readPLTArray(mpTextStream, currentVariable, alpha, intervalSize, it, arrLst);
-      for (int i = 0; i < arrLst.length(); i++)
-      {
-        pPlotCurve->addXAxisValue(i);
-        pPlotCurve->addYAxisValue(arrLst[i]);
-      }
-      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
-      pPlotCurve->attach(mpPlot);
-      mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
-      mpPlot->replot();
+    mArrayTimeVector.resize(intervalSize);
+    if (readPLTDataset(&textStream, "time", intervalSize, mArrayTimeVector.data())) {
+      mArrayTimeVector.clear();
     }
     mFile.close();
   }
   //PLOT CSV
-  else if (mFile.fileName().endsWith("csv"))
-  {
-    /* open the file */
-    struct csv_data *csvReader;
-    csvReader = read_csv(mFile.fileName().toStdString().c_str());
-    if (csvReader == NULL)
-      throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
-    //Read in timevector
+  else if (mFile.fileName().endsWith("csv")) {
+    struct csv_data *csvReader = getResultFile()->getCSVData();
     double *timeVals = read_csv_dataset(csvReader, "time");
-    if (timeVals == NULL)
-    {
-      omc_free_csv_reader(csvReader);
-      throw NoVariableException(tr("Variable doesnt exist: %1").arg("time").toStdString().c_str());
+    if (timeVals) {
+      mArrayTimeVector.resize(csvReader->numsteps);
+      std::copy(timeVals, timeVals + csvReader->numsteps, mArrayTimeVector.begin());
     }
-    //calculate time
-    double startTime = timeVals[0];
-    double stopTime = timeVals[csvReader->numsteps-1];
-    time = startTime + (stopTime - startTime)*timePercent/100.0;
-    setTime(time);
-    double alpha;
-    int it = setupInterp(timeVals, time, csvReader->numsteps, alpha);
-    if (it < 0) {
-      omc_free_csv_reader(csvReader);
-      throw PlotException("Time out of bounds.");
+  }
+  //PLOT MAT
+  else if (mFile.fileName().endsWith("mat")) {
+    ModelicaMatReader &reader = *getResultFile()->getMatReader();
+    double *timeVals = reader.nvar < 1 ? 0 : omc_matlab4_read_vals(&reader, 1);
+    if (timeVals) {
+      mArrayTimeVector.resize(reader.nrows);
+      std::copy(timeVals, timeVals + reader.nrows, mArrayTimeVector.begin());
     }
-    QStringList::Iterator itVarList;
-    for (itVarList = mVariablesList.begin(); itVarList != mVariablesList.end(); itVarList++){
-      if (!editCase) {
-        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), *itVarList, "array index", *itVarList, getUnit(), getDisplayUnit(), mpPlot);
-        mpPlot->addPlotCurve(pPlotCurve);
-      }
-      QList<double> res;
-      double *arrElement;
-      int i = 1;
-      do {
-        QString varNameQS = (*itVarList);
-        if (QRegExp("der\\(\\D(\\w)*\\)").exactMatch(varNameQS)){
-          varNameQS.chop(1);
-          varNameQS.append("["+QString::number(i)+"])");
-        } else {
-          varNameQS.append("["+QString::number(i)+"]");
+  } else {
+    throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+  }
+  if (mArrayTimeVector.isEmpty()) {
+    throw NoVariableException(tr("Variable doesnt exist: %1").arg("time").toStdString().c_str());
+  }
+  mArrayResultsFileName = fileInfo.absoluteFilePath();
+  mArrayResultsLastModified = fileInfo.lastModified();
+  mArrayResultsFileSize = fileInfo.size();
+}
+
+/*!
+ * \brief PlotWindow::getArrayResult
+ * Returns the values of all the elements of the array variable.\n
+ * The elements are read from the result file once and stored as one matrix with a row per time point.
+ * \param variable
+ * \return
+ */
+const PlotWindow::ArrayResult& PlotWindow::getArrayResult(const QString &variable)
+{
+  QHash<QString, ArrayResult>::const_iterator iterator = mArrayResults.constFind(variable);
+  if (iterator != mArrayResults.constEnd()) {
+    return iterator.value();
+  }
+  const int numRows = mArrayTimeVector.size();
+  // the columns of the array elements. The PLT and parameter columns are stored in columnsData.
+  QVector<const double*> columns;
+  QList<QVector<double> > columnsData;
+  //PLOT PLT
+  if (mFile.fileName().endsWith("plt")) {
+    if (!mFile.open(QIODevice::ReadOnly)) {
+      throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+    }
+    QTextStream textStream(&mFile);
+    try {
+      forever {
+        QVector<double> values(numRows);
+        if (readPLTDataset(&textStream, getArrayElementName(variable, columns.size() + 1), numRows, values.data())) {
+          break;
         }
-        if (!(arrElement = read_csv_dataset(csvReader, varNameQS.toStdString().c_str()))) break;
-        i++;
-
-        if (it == 0)
-          res.push_back(arrElement[0]);
-        else
-          res.push_back(alpha*arrElement[it-1] + (1-alpha)*arrElement[it]);
-      } while (true);
-      pPlotCurve->clearXAxisVector();
-      pPlotCurve->clearYAxisVector();
-      for (int j = 0; j < res.count(); j++){
-        pPlotCurve->addXAxisValue(j);
-        pPlotCurve->addYAxisValue(res[j]);
+        columnsData.append(values);
+        columns.append(columnsData.last().constData());
       }
-      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
-      pPlotCurve->attach(mpPlot);
-      mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
-      mpPlot->replot();
-
+    } catch (PlotException&) {
+      mFile.close();
+      throw;
+    }
+    mFile.close();
+  }
+  //PLOT CSV
+  else if (mFile.fileName().endsWith("csv")) {
+    struct csv_data *csvReader = getResultFile()->getCSVData();
+    if (csvReader->numsteps != numRows) {
+      throw PlotException(tr("Failed to load the %1 variable.").arg(variable));
+    }
+    double *arrElement;
+    while ((arrElement = read_csv_dataset(csvReader, getArrayElementName(variable, columns.size() + 1).toStdString().c_str()))) {
+      columns.append(arrElement);
     }
-    omc_free_csv_reader(csvReader);
   }
   //PLOT MAT
-  else
-    if(mFile.fileName().endsWith("mat"))
-    {
-      ModelicaMatReader reader;
-      ModelicaMatVariable_t *var;
-      QList<ModelicaMatVariable_t*> vars;
-      const char *msg = "";
-      QStringList variablesPlotted;
-
-      //Read in mat file
-      if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader)))
-        throw PlotException(msg);
-      //calculate time
-      double startTime = omc_matlab4_startTime(&reader);
-      double stopTime =  omc_matlab4_stopTime(&reader);
-      time = startTime + (stopTime - startTime)*timePercent/100.0;
-      setTime(time);
-      if (reader.nvar < 1) {
-        omc_free_matlab4_reader(&reader);
-        throw NoVariableException("Variable doesnt exist: time");
-      }
-      if (time<startTime || stopTime<time) {
-        omc_free_matlab4_reader(&reader);
-        throw PlotException("Time out of bounds.");
-      }
-      QStringList::Iterator itVarList;
-      for (itVarList = mVariablesList.begin(); itVarList != mVariablesList.end(); itVarList++){
-        if (!editCase) {
-          pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), *itVarList, "array index", *itVarList, getUnit(), getDisplayUnit(), mpPlot);
-          mpPlot->addPlotCurve(pPlotCurve);
+  else if (mFile.fileName().endsWith("mat")) {
+    ModelicaMatReader &reader = *getResultFile()->getMatReader();
+    ModelicaMatVariable_t *var;
+    while ((var = omc_matlab4_find_var(&reader, getArrayElementName(variable, columns.size() + 1).toStdString().c_str()))) {
+      if (var->isParam) {
+        double value;
+        if (omc_matlab4_val(&value, &reader, var, 0.0)) {
+          throw NoVariableException(QString("Parameter doesn't have a value : ").append(QString(var->name)).toStdString().c_str());
         }
-        int i = 1;
-        do {
-          QString varNameQS = (*itVarList);
-          if (QRegExp("der\\(\\D(\\w)*\\)").exactMatch(varNameQS)){
-            varNameQS.chop(1);
-            varNameQS.append("["+QString::number(i)+"])");
-          } else {
-            varNameQS.append("["+QString::number(i)+"]");
-          }
-          if(!(var = omc_matlab4_find_var(&reader, varNameQS.toStdString().c_str()))) break;
-          i++;
-          vars.push_back(var);
-        } while (true);
-        QVector<ModelicaMatVariable_t*> varVec = vars.toVector();
-        res = new double [vars.count()];
-        omc_matlab4_read_vars_val(res, &reader, varVec.data(), vars.count(), time);
-        pPlotCurve->clearXAxisVector();
-        pPlotCurve->clearYAxisVector();
-        for (int i = 0; i < vars.count(); i++){
-          pPlotCurve->addXAxisValue(i);
-          pPlotCurve->addYAxisValue(res[i]);
+        columnsData.append(QVector<double>(numRows, value));
+        columns.append(columnsData.last().constData());
+      } else {
+        double *vals = omc_matlab4_read_vals(&reader, var->index);
+        if (!vals || reader.nrows != numRows) {
+          throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
         }
-        pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
-        pPlotCurve->attach(mpPlot);
-        mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
-        mpPlot->replot();
-        delete[] res;
+        columns.append(vals);
       }
-      // if plottype is PLOT then check which requested variables are not found in the file
-      if (getPlotType() == PlotWindow::PLOT)
-        checkForErrors(mVariablesList, variablesPlotted);
-      // close the file
-      omc_free_matlab4_reader(&reader);
     }
+  }
+  if (columns.isEmpty()) {
+    throw NoVariableException(tr("Array variable doesnt exist: %1").arg(variable).toStdString().c_str());
+  }
+  // store the columns as a matrix so the values at a time point are contiguous
+  ArrayResult arrayResult;
+  arrayResult.mNumElements = columns.size();
+  arrayResult.mValues.resize(numRows * arrayResult.mNumElements);
+  double *pValues = arrayResult.mValues.data();
+  for (int row = 0; row < numRows; row++) {
+    for (int element = 0; element < arrayResult.mNumElements; element++) {
+      *pValues++ = columns[element][row];
+    }
+  }
+  return mArrayResults.insert(variable, arrayResult).value();
+}
+
+/*!
+ * \brief PlotWindow::getArrayTime
+ * Returns the time at timePercent of the simulation and finds the time points around it.
+ * \param timePercent
+ * \param row - set to the first time point at or after the time.
+ * \param alpha - set to the interpolation factor between row - 1 and row.
+ * \return
+ */
+double PlotWindow::getArrayTime(double timePercent, int &row, double &alpha)
+{
+  updateArrayResults();
+  double startTime = mArrayTimeVector.first();
+  double stopTime = mArrayTimeVector.last();
+  double time = qBound(startTime, startTime + (stopTime - startTime)*timePercent/100.0, stopTime);
+  setTime(time);
+  row = setupInterp(mArrayTimeVector.data(), time, mArrayTimeVector.size(), alpha);
+  if (row < 0) {
+    throw PlotException("Time out of bounds.");
+  }
+  return time;
+}
+
+/*!
+ * \brief PlotWindow::interpolateArrayResult
+ * Interpolates the values of all the array elements between the rows row - 1 and row.
+ * \param arrayResult
+ * \param row
+ * \param alpha
+ * \param values
+ */
+void PlotWindow::interpolateArrayResult(const ArrayResult &arrayResult, int row, double alpha, QVector<double> &values)
+{
+  const int numElements = arrayResult.mNumElements;
+  values.resize(numElements);
+  const double *pCurrent = arrayResult.mValues.constData() + row * numElements;
+  if (row == 0) {
+    std::copy(pCurrent, pCurrent + numElements, values.begin());
+  } else {
+    const double *pPrevious = pCurrent - numElements;
+    for (int i = 0; i < numElements; i++) {
+      values[i] = (1 - alpha)*pPrevious[i] + alpha*pCurrent[i];
+    }
+  }
+}
+
+double getTimeUnitFactor(QString timeUnit){
+  if (timeUnit == "ms") return 1000.0;
+  else if (timeUnit == "s") return 1.0;
+  else if (timeUnit == "min") return 1.0/6.0;
+  else if (timeUnit == "h") return 1.0/3600.0;
+  else if (timeUnit == "d") return 1.0/86400.0;
+  else throw PlotException(QObject::tr("Unknown unit in plotArray(Parametric)."));
+}
+
+void PlotWindow::updateTimeText(QString unit)
+{
+  double timeUnitFactor = getTimeUnitFactor(unit);
+  mpPlot->setFooter(QString("t = %1 " + unit).arg(getTime()*timeUnitFactor,0,'g',3));
+  mpPlot->replot();
+}
+
+void PlotWindow::plotArray(double timePercent, PlotCurve *pPlotCurve)
+{
+  double timeUnitFactor = getTimeUnitFactor(getTimeUnit());
+  if (mVariablesList.isEmpty() and getPlotType() == PlotWindow::PLOTARRAY)
+    throw NoVariableException(QString("No variables specified!").toStdString().c_str());
+  bool editCase = pPlotCurve ? true : false;
+  int row;
+  double alpha;
+  double time = getArrayTime(timePercent, row, alpha);
+  QVector<double> indexes, values;
+  QStringList::Iterator itVarList;
+  for (itVarList = mVariablesList.begin(); itVarList != mVariablesList.end(); itVarList++) {
+    const ArrayResult &arrayResult = getArrayResult(*itVarList);
+    if (!editCase) {
+      pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), *itVarList, "array index", *itVarList, getUnit(), getDisplayUnit(), mpPlot);
+      mpPlot->addPlotCurve(pPlotCurve);
+    }
+    interpolateArrayResult(arrayResult, row, alpha, values);
+    indexes.resize(values.size());
+    for (int i = 0; i < indexes.size(); i++) {
+      indexes[i] = i;
+    }
+    pPlotCurve->setAxisVectors(indexes.constData(), values.constData(), values.size());
+    pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+    pPlotCurve->attach(mpPlot);
+  }
+  mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
+  mpPlot->replot();
 }
 
 void PlotWindow::plotArrayParametric(double timePercent, PlotCurve *pPlotCurve)
 {
   QString xVariable, yVariable, xTitle, yTitle;
   int pair = 0;
-  double time;
   double timeUnitFactor = getTimeUnitFactor(getTimeUnit());
   if (mVariablesList.isEmpty())
     throw NoVariableException(QString("No variables specified!").toStdString().c_str());
@@ -1126,14 +1071,15 @@ void PlotWindow::plotArrayParametric(double timePercent, PlotCurve *pPlotCurve)
     throw NoVariableException(QString("Please specify variable pairs for plotParametric.").toStdString().c_str());
 
   bool editCase = pPlotCurve ? true : false;
+  int row;
+  double alpha;
+  double time = getArrayTime(timePercent, row, alpha);
+  QVector<double> xValues, yValues;
 
   for (pair = 0; pair < mVariablesList.size(); pair += 2)
   {
-    QStringList varPair;
     xVariable = mVariablesList.at(pair);
     yVariable = mVariablesList.at(pair+1);
-    //    if (!editCase)
-    //    {
     if (pair==0)
     {
       xTitle = xVariable;
@@ -1146,226 +1092,27 @@ void PlotWindow::plotArrayParametric(double timePercent, PlotCurve *pPlotCurve)
     }
     setXLabel(xTitle);
     setYLabel(yTitle);
-    //    }
 
-    //PLOT PLT
-    //we presume time is the first dataset and array elements datasets are consequent
-    if (mFile.fileName().endsWith("plt"))
-    {
-      /* open the file */
-      if (!mFile.open(QIODevice::ReadOnly))
-        throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
-      mpTextStream = new QTextStream(&mFile);
-      // read the interval size from the file
-      QString currentLine;
-      int intervalSize = -1;
-      while (!mpTextStream->atEnd())
-      {
-        currentLine = mpTextStream->readLine();
-        if (currentLine.startsWith("#IntervalSize"))
-        {
-          intervalSize = static_cast<QString>(currentLine.split("=").last()).toInt();
-          break;
-        }
-      }
-      if (intervalSize == -1) {
-        mFile.close();
-        throw PlotException(tr("Interval size not specified.").toStdString().c_str());
-      }
-      //Read in timevector
-      double timeVals[intervalSize];
-      readPLTDataset(mpTextStream, "time", intervalSize, timeVals);
-      //calculate time
-      double startTime = timeVals[0];
-      double stopTime = timeVals[intervalSize-1];
-      time = startTime + (stopTime - startTime)*timePercent/100.0;
-      setTime(time);
-      //Find indexes and alpha to interpolate data in particular time
-      double alpha;
-      int it = setupInterp(timeVals, time, intervalSize, alpha);
-      if (it < 0) {
-        mFile.close();
-        throw PlotException("Time out of bounds.");
-      }
-      if (editCase) {
-        pPlotCurve->clearXAxisVector();
-        pPlotCurve->clearYAxisVector();
-      } else {
-        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), yVariable + " vs " + xVariable, xVariable, yVariable, getUnit(), getDisplayUnit(), mpPlot);
-        pPlotCurve->setXVariable(xVariable);
-        pPlotCurve->setYVariable(yVariable);
-        mpPlot->addPlotCurve(pPlotCurve);
-      }
-      //Read the values
-      QList<double> xValsLst;
-      readPLTArray(mpTextStream, xVariable, alpha, intervalSize, it, xValsLst);
-      QList<double> yValsLst;
-      readPLTArray(mpTextStream, yVariable, alpha, intervalSize, it, yValsLst);
-      if (xValsLst.length() != yValsLst.length()) {
-        mFile.close();
-        throw PlotException(tr("Arrays must be of the same length in array parametric plot."));
-      }
-      for (int i = 0; i < xValsLst.length(); i++){
-        pPlotCurve->addXAxisValue(xValsLst[i]);
-        pPlotCurve->addYAxisValue(yValsLst[i]);
-      }
-      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
-      pPlotCurve->attach(mpPlot);
-      mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
-      mpPlot->replot();
-      mFile.close();
+    // copies since reading the second array may add to mArrayResults
+    const ArrayResult xArrayResult = getArrayResult(xVariable);
+    const ArrayResult yArrayResult = getArrayResult(yVariable);
+    if (xArrayResult.mNumElements != yArrayResult.mNumElements) {
+      throw PlotException(tr("Arrays must be of the same length in array parametric plot."));
     }
-    //    //PLOT CSV
-    else if (mFile.fileName().endsWith("csv"))
-    {
-      /* open the file */
-      struct csv_data *csvReader;
-      csvReader = read_csv(mFile.fileName().toStdString().c_str());
-      if (csvReader == NULL)
-        throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
-      //Read in timevector
-      double *timeVals = read_csv_dataset(csvReader, "time");
-      if (timeVals == NULL)
-      {
-        omc_free_csv_reader(csvReader);
-        throw NoVariableException(tr("Variable doesnt exist: %1").arg("time").toStdString().c_str());
-      }
-      //calculate time
-      double startTime = timeVals[0];
-      double stopTime = timeVals[csvReader->numsteps-1];
-      time = startTime + (stopTime - startTime)*timePercent/100.0;
-      setTime(time);
-      double alpha;
-      int it = setupInterp(timeVals, time, csvReader->numsteps, alpha);
-      if (it < 0) {
-        omc_free_csv_reader(csvReader);
-        throw PlotException("Time out of bounds.");
-      }
-      if (!editCase) {
-        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), yVariable + " vs " + xVariable, xVariable, yVariable, getUnit(), getDisplayUnit(), mpPlot);
-        pPlotCurve->setXVariable(xVariable);
-        pPlotCurve->setYVariable(yVariable);
-        mpPlot->addPlotCurve(pPlotCurve);
-      }
-      pPlotCurve->clearXAxisVector();
-      pPlotCurve->clearYAxisVector();
-      QStringList varPair;
-      varPair << xVariable << yVariable;
-      QList<double> res;
-      for (int j = 0; j<2; j++){
-        res.clear();
-        double *arrElement;
-        for (int i = 1; i++; true){
-          QString varNameQS = varPair[j];
-          if (QRegExp("der\\(\\D(\\w)*\\)").exactMatch(varNameQS)){
-            varNameQS.chop(1);
-            varNameQS.append("["+QString::number(i)+"])");
-          } else {
-            varNameQS.append("["+QString::number(i)+"]");
-          }
-          if (!(arrElement = read_csv_dataset(csvReader, varNameQS.toStdString().c_str()))) break;
-
-          if (it == 0)
-            res.push_back(arrElement[0]);
-          else
-            res.push_back(alpha*arrElement[it-1] + (1-alpha)*arrElement[it]);
-        }
-        if (j == 0) { //xVar
-          for (int i = 0; i < res.count(); i++)
-            pPlotCurve->addXAxisValue(res[i]);
-        }
-        else { //yVar
-          if (pPlotCurve->getSize()!=res.count()) {
-            omc_free_csv_reader(csvReader);
-            throw PlotException(tr("Arrays must be of the same length in array parametric plot."));
-          }
-          for (int i = 0; i < res.count(); i++)
-            pPlotCurve->addYAxisValue(res[i]);
-        }
-      }
-      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
-      pPlotCurve->attach(mpPlot);
-      mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
-      mpPlot->replot();
-      omc_free_csv_reader(csvReader);
-    }
-    //PLOT MAT
-    else if(mFile.fileName().endsWith("mat"))
-    {
-      //Declare variables
-      ModelicaMatReader reader;
-      ModelicaMatVariable_t *var;
-      double *res;
-      const char *msg = "";
-
-      //Read the .mat file
-      if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader)))
-        throw PlotException(msg);
-
-      if (!editCase) {
-        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), yVariable + " vs " + xVariable, xVariable, yVariable, getUnit(), getDisplayUnit(), mpPlot);
-        pPlotCurve->setXVariable(xVariable);
-        pPlotCurve->setYVariable(yVariable);
-        mpPlot->addPlotCurve(pPlotCurve);
-      }
-      //calculate time
-      double startTime = omc_matlab4_startTime(&reader);
-      double stopTime =  omc_matlab4_stopTime(&reader);
-      time = startTime + (stopTime - startTime)*timePercent/100.0;
-      setTime(time);
-      if (reader.nvar < 1) {
-        omc_free_matlab4_reader(&reader);
-        throw NoVariableException("Variable doesnt exist: time");
-      }
-      if (time<startTime || stopTime<time) {
-        omc_free_matlab4_reader(&reader);
-        throw PlotException("Time out of bounds.");
-      }
-      pPlotCurve->clearXAxisVector();
-      pPlotCurve->clearYAxisVector();
-      QList<ModelicaMatVariable_t*> vars;
-      QStringList varPair;
-      varPair.push_back(xVariable);
-      varPair.push_back(yVariable);
-      //read x and y vals:
-      for (int j = 0; j < 2; j++){
-        vars.clear();
-        int i = 1;
-        do {
-          QString varNameQS = varPair[j];
-          if (QRegExp("der\\(\\D(\\w)*\\)").exactMatch(varNameQS)){
-            varNameQS.chop(1);
-            varNameQS.append("["+QString::number(i)+"])");
-          } else {
-            varNameQS.append("["+QString::number(i)+"]");
-          }
-          if(!(var = omc_matlab4_find_var(&reader, varNameQS.toStdString().c_str()))) break;
-          i++;
-          vars.push_back(var);
-        } while (true);
-        QVector<ModelicaMatVariable_t*> varVec = vars.toVector();
-        res = new double [vars.count()];
-        omc_matlab4_read_vars_val(res, &reader, varVec.data(), vars.count(), time);
-        if (j == 0)
-          for (int i = 0; i < vars.count(); i++)
-            pPlotCurve->addXAxisValue(res[i]);
-        else{
-          if (pPlotCurve->getSize()!=vars.count()) {
-            omc_free_matlab4_reader(&reader);
-            throw PlotException("Arrays must be of the same length in array parametric plot.");
-          }
-          for (int i = 0; i < vars.count(); i++)
-            pPlotCurve->addYAxisValue(res[i]);
-        }
-        delete[] res;
-      }
-      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
-      pPlotCurve->attach(mpPlot);
-      mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
-      mpPlot->replot();
-      omc_free_matlab4_reader(&reader);
+    if (!editCase) {
+      pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), yVariable + " vs " + xVariable, xVariable, yVariable, getUnit(), getDisplayUnit(), mpPlot);
+      pPlotCurve->setXVariable(xVariable);
+      pPlotCurve->setYVariable(yVariable);
+      mpPlot->addPlotCurve(pPlotCurve);
     }
+    interpolateArrayResult(xArrayResult, row, alpha, xValues);
+    interpolateArrayResult(yArrayResult, row, alpha, yValues);
+    pPlotCurve->setAxisVectors(xValues.constData(), yValues.constData(), xValues.size());
+    pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+    pPlotCurve->attach(mpPlot);
   }
+  mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
+  mpPlot->replot();
 }
 
 QPair<QVector<double>*, QVector<double>*> PlotWindow::plotInteractive(PlotCurve *pPlotCurve)
@@ -1609,10 +1356,14 @@ QString PlotWindow::getFooter()
 
 void PlotWindow::checkForErrors(QStringList variables, QStringList variablesPlotted)
 {
+  QSet<QString> variablesPlottedSet;
+  foreach (const QString &variable, variablesPlotted) {
+    variablesPlottedSet.insert(variable);
+  }
   QStringList nonExistingVariables;
   foreach (QString variable, variables)
   {
-    if (!variablesPlotted.contains(variable))
+    if (!variablesPlottedSet.contains(variable))
       nonExistingVariables.append(variable);
   }
   if (!nonExistingVariables.isEmpty())
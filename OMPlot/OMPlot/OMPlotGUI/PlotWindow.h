@@ -50,6 +50,7 @@
 #include "util/read_matlab4.h"
 #include "util/read_csv.h"
 #include "OMPlot.h"
+#include "ResultFile.h"
 
 namespace OMPlot
 {
@@ -76,6 +77,7 @@ private:
   QComboBox *mpSimulationSpeedComboBox;
   QTextStream *mpTextStream;
   QFile mFile;
+  QSharedPointer<ResultFile> mpResultFile;
   QStringList mVariablesList;
   PlotType mPlotType;
   QString mGridType;
@@ -95,6 +97,16 @@ private:
   QwtSeriesData<QPointF>* mpInteractiveData;
   QString mInteractiveModelName;
   QMdiSubWindow *mpSubWindow;
+  /* The values of an array variable. One row of mNumElements values per time point. */
+  struct ArrayResult {
+    int mNumElements;
+    QVector<double> mValues;
+  };
+  QVector<double> mArrayTimeVector;
+  QHash<QString, ArrayResult> mArrayResults;
+  QString mArrayResultsFileName;
+  QDateTime mArrayResultsLastModified;
+  qint64 mArrayResultsFileSize;
 public:
   PlotWindow(QStringList arguments = QStringList(), QWidget *parent = 0, bool isInteractiveSimulation = false);
 
@@ -161,6 +173,12 @@ public:
   void updateTimeText(QString unit);
   void updateCurves();
   void updateYAxis(QPair<double, double> minMaxValues);
+private:
+  ResultFile* getResultFile();
+  void updateArrayResults();
+  const ArrayResult& getArrayResult(const QString &variable);
+  double getArrayTime(double timePercent, int &row, double &alpha);
+  void interpolateArrayResult(const ArrayResult &arrayResult, int row, double alpha, QVector<double> &values);
 signals:
   void closingDown();
 public slots:
@@ -0,0 +1,122 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linkoping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linkoping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3
+ * AND THIS OSMC PUBLIC LICENSE (OSMC-PL).
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S
+ * ACCEPTANCE OF THE OSMC PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linkoping University, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ResultFile.h"
+
+using namespace OMPlot;
+
+QHash<QString, QWeakPointer<ResultFile> > ResultFile::mResultFiles;
+
+ResultFile::ResultFile(const QString &fileName)
+  : mFileName(fileName), mSize(0), mpCSVData(0)
+{
+  mMatReader.file = 0;
+  QFileInfo fileInfo(mFileName);
+  mLastModified = fileInfo.lastModified();
+  mSize = fileInfo.size();
+}
+
+ResultFile::~ResultFile()
+{
+  if (mMatReader.file) {
+    omc_free_matlab4_reader(&mMatReader);
+    mMatReader.file = 0;
+  }
+  if (mpCSVData) {
+    omc_free_csv_reader(mpCSVData);
+    mpCSVData = 0;
+  }
+}
+
+/*!
+ * \brief ResultFile::open
+ * Returns the result file. If the file is already open and hasn't changed on disk since then the open instance is returned.
+ * Otherwise the file is read again. Instances that are no longer referenced are freed automatically.
+ * \param fileName
+ * \param pErrorString - set to the error if the file can't be read.
+ * \return the result file or a null pointer if the file can't be read.
+ */
+QSharedPointer<ResultFile> ResultFile::open(const QString &fileName, QString *pErrorString)
+{
+  QFileInfo fileInfo(fileName);
+  QString key = fileInfo.absoluteFilePath();
+  QSharedPointer<ResultFile> pResultFile = mResultFiles.value(key).toStrongRef();
+  if (pResultFile && pResultFile->isUpToDate()) {
+    return pResultFile;
+  }
+  pResultFile = QSharedPointer<ResultFile>(new ResultFile(key));
+  if (!pResultFile->read(pErrorString)) {
+    mResultFiles.remove(key);
+    return QSharedPointer<ResultFile>();
+  }
+  mResultFiles.insert(key, pResultFile.toWeakRef());
+  return pResultFile;
+}
+
+/*!
+ * \brief ResultFile::isUpToDate
+ * Returns true if the file on disk is unchanged since it was read.
+ * \return
+ */
+bool ResultFile::isUpToDate() const
+{
+  QFileInfo fileInfo(mFileName);
+  return fileInfo.exists() && fileInfo.lastModified() == mLastModified && fileInfo.size() == mSize;
+}
+
+/*!
+ * \brief ResultFile::read
+ * Reads the header of the MAT file or the contents of the CSV file.
+ * \param pErrorString
+ * \return
+ */
+bool ResultFile::read(QString *pErrorString)
+{
+  QString errorString;
+  if (mFileName.endsWith(".mat")) {
+    const char *msg = omc_new_matlab4_reader(mFileName.toStdString().c_str(), &mMatReader);
+    if (0 != msg) {
+      mMatReader.file = 0;
+      errorString = msg;
+    }
+  } else if (mFileName.endsWith(".csv")) {
+    mpCSVData = read_csv(mFileName.toStdString().c_str());
+    if (!mpCSVData) {
+      errorString = QObject::tr("Failed to open simulation result file %1").arg(mFileName);
+    }
+  } else {
+    errorString = QObject::tr("Unsupported result file %1").arg(mFileName);
+  }
+  if (pErrorString) {
+    *pErrorString = errorString;
+  }
+  return errorString.isEmpty();
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linkoping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linkoping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3
+ * AND THIS OSMC PUBLIC LICENSE (OSMC-PL).
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S
+ * ACCEPTANCE OF THE OSMC PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linkoping University, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef RESULTFILE_H
+#define RESULTFILE_H
+
+#include <QtCore>
+#include "util/read_matlab4.h"
+#include "util/read_csv.h"
+
+namespace OMPlot
+{
+/*!
+ * \class ResultFile
+ * \brief A parsed MAT or CSV result file shared by everyone reading the same file.
+ * The file is opened and parsed once. The values read from it are cached inside the reader and stay valid as long as
+ * a reference to the ResultFile exists.
+ */
+class ResultFile
+{
+public:
+  ~ResultFile();
+  static QSharedPointer<ResultFile> open(const QString &fileName, QString *pErrorString = 0);
+  QString getFileName() const {return mFileName;}
+  bool isUpToDate() const;
+  ModelicaMatReader* getMatReader() {return mMatReader.file ? &mMatReader : 0;}
+  csv_data* getCSVData() {return mpCSVData;}
+private:
+  ResultFile(const QString &fileName);
+  bool read(QString *pErrorString);
+
+  QString mFileName;
+  QDateTime mLastModified;
+  qint64 mSize;
+  ModelicaMatReader mMatReader;
+  csv_data *mpCSVData;
+  static QHash<QString, QWeakPointer<ResultFile> > mResultFiles;
+};
+}
+
+#endif // RESULTFILE_H
@@ -0,0 +1,162 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linkoping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linkoping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3
+ * AND THIS OSMC PUBLIC LICENSE (OSMC-PL).
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S
+ * ACCEPTANCE OF THE OSMC PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linkoping University, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ */
+
+#include "PlotCurve.h"
+
+#include <QtTest/QTest>
+#include <QImage>
+#include <QPainter>
+#include <qmath.h>
+
+using namespace OMPlot;
+
+/*!
+ * \class PlotCurveBenchmark
+ * \brief Benchmarks the min/max decimation of PlotCurve on a 10M-point curve drawn on a 1000 pixels wide canvas.
+ */
+class PlotCurveBenchmark : public QObject
+{
+  Q_OBJECT
+private:
+  static const int mSize = 10000000;
+  static const int mCanvasWidth = 1000;
+  QVector<double> mXData;
+  QVector<double> mYData;
+  MinMaxPyramid mMinMaxPyramid;
+  void drawIndexes(const QVector<int> &indexes, int from, int to);
+private slots:
+  void initTestCase();
+  void buildPyramid();
+  void drawAll();
+  void drawZoomed();
+  void drawAllSamples();
+  void keepEdgeBucketPeaks();
+};
+
+void PlotCurveBenchmark::initTestCase()
+{
+  mXData.resize(mSize);
+  mYData.resize(mSize);
+  for (int i = 0; i < mSize; i++) {
+    mXData[i] = i * 1e-6;
+    mYData[i] = qSin(i * 1e-4) + ((i % 1000003) == 0 ? 10.0 : 0.0);
+  }
+  mMinMaxPyramid.build(mXData.constData(), mYData.constData(), mSize);
+  QVERIFY(mMinMaxPyramid.isDecimatable());
+}
+
+/*!
+ * \brief PlotCurveBenchmark::drawIndexes
+ * Draws the samples like PlotCurve::drawSeries does.
+ * \param indexes
+ * \param from
+ * \param to
+ */
+void PlotCurveBenchmark::drawIndexes(const QVector<int> &indexes, int from, int to)
+{
+  QImage image(mCanvasWidth, 400, QImage::Format_ARGB32_Premultiplied);
+  image.fill(0);
+  QPainter painter(&image);
+  const double xScale = mCanvasWidth / (mXData[to] - mXData[from]);
+  QPolygonF polyline(indexes.size());
+  for (int i = 0; i < indexes.size(); i++) {
+    polyline[i] = QPointF((mXData[indexes[i]] - mXData[from]) * xScale, 200 - mYData[indexes[i]] * 15);
+  }
+  painter.drawPolyline(polyline);
+}
+
+void PlotCurveBenchmark::buildPyramid()
+{
+  MinMaxPyramid minMaxPyramid;
+  QBENCHMARK {
+    minMaxPyramid.build(mXData.constData(), mYData.constData(), mSize);
+  }
+}
+
+void PlotCurveBenchmark::drawAll()
+{
+  QVector<int> indexes;
+  QBENCHMARK {
+    QVERIFY(mMinMaxPyramid.getIndexes(0, mSize - 1, mSize / mCanvasWidth, indexes));
+    drawIndexes(indexes, 0, mSize - 1);
+  }
+}
+
+void PlotCurveBenchmark::drawZoomed()
+{
+  const int from = 3333333, to = from + 250000;
+  QVector<int> indexes;
+  QBENCHMARK {
+    QVERIFY(mMinMaxPyramid.getIndexes(from, to, (to - from + 1) / mCanvasWidth, indexes));
+    drawIndexes(indexes, from, to);
+  }
+}
+
+/*!
+ * \brief PlotCurveBenchmark::drawAllSamples
+ * Draws every sample for comparison, i.e., the cost of a replot without the pyramid.
+ */
+void PlotCurveBenchmark::drawAllSamples()
+{
+  QVector<int> indexes(mSize);
+  for (int i = 0; i < mSize; i++) {
+    indexes[i] = i;
+  }
+  QBENCHMARK {
+    drawIndexes(indexes, 0, mSize - 1);
+  }
+}
+
+/*!
+ * \brief PlotCurveBenchmark::keepEdgeBucketPeaks
+ * The peaks in the visible part of the partial buckets at the ends of the range must be drawn.
+ */
+void PlotCurveBenchmark::keepEdgeBucketPeaks()
+{
+  QVector<double> xData(1 << 16), yData(1 << 16);
+  for (int i = 0; i < xData.size(); i++) {
+    xData[i] = i;
+    yData[i] = 0;
+  }
+  // the extrema of the edge buckets are outside of the range
+  yData[500] = 9;
+  yData[1001] = 5;
+  yData[60001] = -5;
+  yData[61000] = -9;
+  MinMaxPyramid minMaxPyramid;
+  minMaxPyramid.build(xData.constData(), yData.constData(), xData.size());
+  QVector<int> indexes;
+  QVERIFY(minMaxPyramid.getIndexes(1000, 60002, 4096, indexes));
+  QVERIFY(indexes.contains(1001));
+  QVERIFY(indexes.contains(60001));
+}
+
+QTEST_MAIN(PlotCurveBenchmark)
+
+#include "PlotCurveBenchmark.moc"
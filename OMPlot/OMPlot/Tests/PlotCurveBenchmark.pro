@@ -0,0 +1,38 @@
+#-------------------------------------------------
+#
+# Benchmark of the min/max decimation of PlotCurve on 10M-point curves.
+# Build OMPlot first, then run qmake, make and ./PlotCurveBenchmark.
+#
+#-------------------------------------------------
+
+QT += core gui svg testlib
+greaterThan(QT_MAJOR_VERSION, 4) {
+    QT *= printsupport widgets
+}
+
+TARGET = PlotCurveBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += PlotCurveBenchmark.cpp
+
+win32 {
+  QMAKE_LFLAGS += -Wl,--enable-auto-import
+  CONFIG(debug, debug|release){
+    LIBS += -L../bin -L$$(OMBUILDDIR)/lib/omc -lOMPlot -lomqwtd
+  }
+  else {
+    LIBS += -L../bin -L$$(OMBUILDDIR)/lib/omc -lOMPlot -lomqwt
+  }
+  INCLUDEPATH += $$(OMBUILDDIR)/include/omplot/qwt $$(OMBUILDDIR)/include/omc/c
+} else {
+  include(../OMPlotGUI/OMPlotGUI.config)
+  LIBS += -L../bin -lOMPlot
+}
+
+INCLUDEPATH += ../OMPlotGUI
+
+CONFIG += warn_off
+
+MOC_DIR = generatedfiles/moc